@@ -1,4 +1,4 @@
-import threading, time
+import threading
 
 from sockets.admin_manager import AdminManager
 from sockets.socket_factory import create_unreal_socket
@@ -9,14 +9,15 @@ from gym_wrappers.gym_wrapper_multi_env import GymWrapperMultiEnv
 
 class AdminTHD(threading.Thread):
 
-    def __init__(self, ip, port, out_q):
+    def __init__(self, ip, port, out_q, bridge_id=None):
         super().__init__(daemon=True, name= "AdminThread")
         self.ip, self.port = ip, port
+        self.bridge_id = bridge_id
         self.q = out_q
         self.admin = None
 
     def run(self):
-        self.admin = AdminManager(ip=self.ip, port=self.port)
+        self.admin = AdminManager(ip=self.ip, port=self.port, bridge_id=self.bridge_id)
         self.admin.connect()
         env_type, obs_shape, act_shape, env_count = self.admin.wait_for_handshake()
         self.q.put({
@@ -24,15 +25,24 @@ class AdminTHD(threading.Thread):
             "obs_shape": obs_shape,
             "act_shape": act_shape,
             "env_count": env_count,
+            "auto_reset": self.admin.auto_reset,
+            "bridge_id": self.bridge_id,
+            "agents": self.admin.agents,
+            "obs_schema": self.admin.obs_schema,
+            "act_schema": self.admin.act_schema,
+            "frame_stack": self.admin.frame_stack,
+            "obs_norm": self.admin.obs_norm,
+            "rollout_length": self.admin.rollout_length,
+            "actor_mode": self.admin.actor_mode,
             "admin": self.admin, 
         })
 
+        # keep handling admin messages (MODEL_LOADED, MODEL_FAILED, POLICY_REQUEST, ...) until the socket is closed
         while True:
             try:
-                _ = self.admin.get_cmd_nonblocking()
-            except Exception:
-                time.sleep(0.3) #sleep for 2 seconds 
-                pass
+                self.admin.run_command()
+            except (ConnectionError, OSError):
+                break
 class envTHD:
     def __init__(self, ip, port, meta):
         self.ip, self.port = ip, port
@@ -41,12 +51,20 @@ class envTHD:
         self.act_shape = meta["act_shape"]
         self.env_type  = meta["env_type"]
         self.n_envs    = meta["env_count"] if meta["env_type"] == "MULTI" else 1
+        self.auto_reset = meta.get("auto_reset", False)
+        self.bridge_id = meta.get("bridge_id")
+        self.obs_schema = meta.get("obs_schema", [])
+        self.act_schema = meta.get("act_schema", [])
+        self.frame_stack = meta.get("frame_stack", 1)
     
     def init_single_env(self):
         obs_shape, act_shape = self.obs_shape, self.act_shape
         ip, port = self.ip, self.port
         admin_sock           = self.meta["admin"].sock
         env_type             = self.env_type
+        bridge_id            = self.bridge_id
+        obs_schema, act_schema = self.obs_schema, self.act_schema
+        frame_stack          = self.frame_stack
 
         def  _init():
             if env_type == "RLBASE":
@@ -58,11 +76,14 @@ class envTHD:
                 )
             elif env_type == "SINGLE":  # SINGLE
                 print("[Training] SINGLE => new socket")
-                sock = create_unreal_socket(ip, port)
+                sock = create_unreal_socket(ip, port, bridge_id)
                 return GymWrapperSingleEnv(
                     sock=sock,
                     obs_shape=obs_shape,
                     act_shape=act_shape,
+                    obs_schema=obs_schema,
+                    act_schema=act_schema,
+                    frame_stack=frame_stack,
                 )
         return _init
 
@@ -70,15 +91,24 @@ class envTHD:
         ip, port          = self.ip, self.port
         obs_shape         = self.obs_shape
         act_shape         = self.act_shape
+        auto_reset        = self.auto_reset
+        bridge_id         = self.bridge_id
+        obs_schema        = self.obs_schema
+        act_schema        = self.act_schema
+        frame_stack       = self.frame_stack
 
         def _init():
             print(f"[Training] MULTI => create {idx} sub-environments")
-            sock = create_unreal_socket(ip, port)
+            sock = create_unreal_socket(ip, port, bridge_id)
             return GymWrapperMultiEnv(
                 sock=sock,
                 obs_shape=obs_shape,
                 act_shape=act_shape,
                 env_id=idx,
+                auto_reset=auto_reset,
+                obs_schema=obs_schema,
+                act_schema=act_schema,
+                frame_stack=frame_stack,
             )
         return _init
 
@@ -0,0 +1,168 @@
+# export_mlp.py
+"""
+Export a dense MLP policy to the weight file read by UInferenceInterfaceMLP.
+
+    python export_mlp.py --model example_model/model.zip --out policy.uemlp
+    python export_mlp.py --onnx policy.onnx --out policy.uemlp
+    python export_mlp.py --model example_model/model.zip --out policy_int8.uemlp --dtype int8
+
+File layout (little endian): b"UEMLP1\\0\\0", uint32 num_layers, then per layer
+uint32 in_size, uint32 out_size, uint32 activation, float32 weights[out x in] (row-major), float32 bias[out].
+float16/int8 files start with b"UEMLP2\\0\\0" and add uint32 weight_type after activation;
+int8 layers store float32 scales[out] (symmetric, per output row) before the int8 weights.
+"""
+
+import argparse as ap
+import struct
+import sys
+
+import numpy as np
+
+MAGIC = b"UEMLP1\x00\x00"
+MAGIC_TYPED = b"UEMLP2\x00\x00"
+ACTIVATIONS = {"none": 0, "relu": 1, "tanh": 2, "sigmoid": 3}
+WEIGHT_TYPES = {"float32": 0, "float16": 1, "int8": 2}
+
+def quantize_int8(weights):
+    """Symmetric per row int8 quantization, returns (scales [out], codes [out, in])."""
+    scales = np.abs(weights).max(axis=1) / 127.0
+    scales[scales == 0] = 1.0
+    codes = np.clip(np.round(weights / scales[:, None]), -127, 127).astype(np.int8)
+    return scales.astype("<f4"), codes
+
+def write_mlp(path, layers, dtype="float32"):
+    """layers: list of (weights [out, in], bias [out], activation name). dtype: float32, float16 or int8."""
+    typed = dtype != "float32"
+    with open(path, "wb") as f:
+        f.write(MAGIC_TYPED if typed else MAGIC)
+        f.write(struct.pack("<I", len(layers)))
+        for weights, bias, activation in layers:
+            weights = np.ascontiguousarray(weights, dtype="<f4")
+            bias = np.ascontiguousarray(bias, dtype="<f4").ravel()
+            out_size, in_size = weights.shape
+            if bias.size != out_size:
+                raise ValueError(f"bias has {bias.size} values, layer has {out_size} outputs")
+            f.write(struct.pack("<III", in_size, out_size, ACTIVATIONS[activation]))
+            if typed:
+                f.write(struct.pack("<I", WEIGHT_TYPES[dtype]))
+            if dtype == "int8":
+                scales, codes = quantize_int8(weights)
+                f.write(scales.tobytes())
+                f.write(codes.tobytes())
+            else:
+                f.write(weights.astype("<f2" if dtype == "float16" else "<f4").tobytes())
+            f.write(bias.tobytes())
+
+def max_quantization_error(layers, dtype):
+    """Largest absolute weight error introduced by dtype, to judge before deploying."""
+    error = 0.0
+    for weights, _, _ in layers:
+        weights = np.asarray(weights, dtype=np.float32)
+        if dtype == "int8":
+            scales, codes = quantize_int8(weights)
+            restored = codes.astype(np.float32) * scales[:, None]
+        elif dtype == "float16":
+            restored = weights.astype(np.float16).astype(np.float32)
+        else:
+            restored = weights
+        error = max(error, float(np.abs(restored - weights).max()))
+    return error
+
+def _torch_layers(modules):
+    """Linear layers of a torch module sequence, each with the activation that follows it."""
+    import torch.nn as nn
+    names = {nn.ReLU: "relu", nn.Tanh: "tanh", nn.Sigmoid: "sigmoid"}
+    layers = []
+    for module in modules:
+        if isinstance(module, nn.Linear):
+            layers.append([module.weight.detach().cpu().numpy(), module.bias.detach().cpu().numpy(), "none"])
+        elif type(module) in names and layers:
+            layers[-1][2] = names[type(module)]
+        elif isinstance(module, (nn.Sequential,)):
+            layers.extend(_torch_layers(module))
+        elif not isinstance(module, (nn.Flatten, nn.Identity)):
+            raise ValueError(f"unsupported module {type(module).__name__}")
+    return layers
+
+def from_sb3(model_path):
+    """Actor of a stable-baselines3 model (PPO/A2C MlpPolicy, SAC/TD3/DDPG actor), with its policy head hint."""
+    from stable_baselines3 import PPO, A2C, SAC, TD3, DDPG
+    for algo in (PPO, A2C, SAC, TD3, DDPG):
+        try:
+            model = algo.load(model_path, device="cpu")
+            break
+        except Exception:
+            continue
+    else:
+        raise ValueError(f"{model_path} is not a stable-baselines3 model")
+
+    policy = model.policy
+    if hasattr(policy, "mlp_extractor"):
+        layers = _torch_layers(policy.mlp_extractor.policy_net) + _torch_layers([policy.action_net])
+        if hasattr(policy, "log_std"):
+            log_std = policy.log_std.detach().cpu().numpy()
+            hint = f"Gaussian head, set LogStd = {np.array2string(log_std, separator=', ')}"
+        else:
+            hint = "Categorical head(s) over the logits"
+    elif hasattr(policy.actor, "log_std"):
+        # SAC: one final layer holding mean and log_std rows back to back
+        layers = _torch_layers(policy.actor.latent_pi)
+        mu, log_std = _torch_layers([policy.actor.mu])[0], _torch_layers([policy.actor.log_std])[0]
+        layers.append([np.concatenate([mu[0], log_std[0]]), np.concatenate([mu[1], log_std[1]]), "none"])
+        hint = "SquashedGaussian head with the action space bounds"
+    else:
+        layers = _torch_layers(policy.actor.mu)
+        hint = "Deterministic head (tanh output in [-1, 1])"
+    return layers, hint
+
+def from_onnx(onnx_path):
+    """Dense layers of an ONNX graph made of Gemm or MatMul+Add nodes with Relu/Tanh/Sigmoid in between."""
+    import onnx
+    from onnx import numpy_helper
+    graph = onnx.load(onnx_path).graph
+    weights = {init.name: numpy_helper.to_array(init) for init in graph.initializer}
+    names = {"Relu": "relu", "Tanh": "tanh", "Sigmoid": "sigmoid"}
+    layers = []
+    for node in graph.node:
+        if node.op_type == "Gemm":
+            attrs = {a.name: onnx.helper.get_attribute_value(a) for a in node.attribute}
+            w = weights[node.input[1]]
+            w = w if attrs.get("transB", 0) else w.T
+            b = weights[node.input[2]] if len(node.input) > 2 else np.zeros(w.shape[0], np.float32)
+            layers.append([w * attrs.get("alpha", 1.0), b * attrs.get("beta", 1.0), "none"])
+        elif node.op_type == "MatMul" and node.input[1] in weights:
+            w = weights[node.input[1]].T
+            layers.append([w, np.zeros(w.shape[0], np.float32), "none"])
+        elif node.op_type == "Add" and layers and any(i in weights for i in node.input):
+            layers[-1][1] = layers[-1][1] + next(weights[i] for i in node.input if i in weights)
+        elif node.op_type in names and layers:
+            layers[-1][2] = names[node.op_type]
+        elif node.op_type not in ("Flatten", "Identity", "Reshape"):
+            raise ValueError(f"unsupported ONNX op {node.op_type}, only dense MLPs can be exported")
+    return layers, "heads depend on how the graph was exported"
+
+def main():
+    parser = ap.ArgumentParser()
+    source = parser.add_mutually_exclusive_group(required=True)
+    source.add_argument("--model", type=str, help="stable-baselines3 model zip")
+    source.add_argument("--onnx", type=str, help="ONNX graph of a dense MLP")
+    parser.add_argument("--out", type=str, required=True, help="weight file to write")
+    parser.add_argument("--dtype", choices=list(WEIGHT_TYPES), default="float32", help="weight storage")
+    args = parser.parse_args()
+
+    try:
+        layers, hint = from_sb3(args.model) if args.model else from_onnx(args.onnx)
+    except ValueError as e:
+        print(f"[export_mlp] {e}")
+        sys.exit(1)
+
+    write_mlp(args.out, layers, args.dtype)
+    shapes = " -> ".join(f"{w.shape[1]}x{w.shape[0]}:{a}" for w, _, a in layers)
+    print(f"[export_mlp] Wrote {len(layers)} {args.dtype} layers ({shapes}) to '{args.out}'")
+    if args.dtype != "float32":
+        print(f"[export_mlp] Max weight error {max_quantization_error(layers, args.dtype):g}, "
+              f"compare actions with UBPFL_InferenceHelpers::CompareOnRecordedObservations")
+    print(f"[export_mlp] Policy heads: {hint}")
+
+if __name__ == "__main__":
+    main()
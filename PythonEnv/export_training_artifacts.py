@@ -0,0 +1,116 @@
+# export_training_artifacts.py
+"""
+Export a stable-baselines3 PPO MlpPolicy as ONNX Runtime training artifacts for UOnnxPolicyTrainer.
+
+    python export_training_artifacts.py --model example_model/model.zip --out artifacts/
+
+Writes training_model.onnx, eval_model.onnx, optimizer_model.onnx and checkpoint to --out.
+The training graph computes the PPO loss (clipped surrogate, value and entropy terms) from the float inputs
+    obs [N, obs], taken_actions [N, act] (discrete: [N] choice index), old_log_probs [N], advantages [N], returns [N]
+and returns (loss, actions). "actions" holds the policy head parameters: logits for Discrete spaces,
+means followed by log stds for Box spaces (use a Categorical or Gaussian FPolicyHead without LogStd).
+UOnnxPolicyTrainer::ExportPolicy() prunes the eval graph to "actions" for UInferenceInterfaceOnnx.
+Needs torch, stable-baselines3, onnx and onnxruntime-training.
+"""
+
+import argparse as ap
+import os
+import sys
+
+# the taken actions input must not share a name with the "actions" output
+INPUT_NAMES = ["obs", "taken_actions", "old_log_probs", "advantages", "returns"]
+
+def make_loss_module(policy, discrete, clip_range, vf_coef, ent_coef):
+    import torch
+    import torch.nn as nn
+
+    class PPOLoss(nn.Module):
+        def __init__(self):
+            super().__init__()
+            self.policy = policy
+
+        def forward(self, obs, taken_actions, old_log_probs, advantages, returns):
+            features = self.policy.extract_features(obs, self.policy.pi_features_extractor)
+            latent_pi, latent_vf = self.policy.mlp_extractor(features)
+            head = self.policy.action_net(latent_pi)
+            values = self.policy.value_net(latent_vf).squeeze(-1)
+
+            if discrete:
+                log_probs_all = torch.log_softmax(head, dim=-1)
+                log_probs = torch.gather(log_probs_all, 1, taken_actions.long().unsqueeze(-1)).squeeze(-1)
+                entropy = -(log_probs_all.exp() * log_probs_all).sum(-1)
+                out = head
+            else:
+                log_std = self.policy.log_std.expand_as(head)
+                var = torch.exp(2.0 * log_std)
+                log_probs = (-((taken_actions - head) ** 2) / (2.0 * var) - log_std - 0.9189385332046727).sum(-1)
+                entropy = (0.5 + 0.9189385332046727 + log_std).sum(-1)
+                out = torch.cat([head, log_std], dim=-1)
+
+            # population std, the unbiased one is NaN for a single sample mini-batch
+            advantages = (advantages - advantages.mean()) / (advantages.std(unbiased=False) + 1e-8)
+            ratio = torch.exp(log_probs - old_log_probs)
+            surrogate = torch.min(ratio * advantages, torch.clamp(ratio, 1.0 - clip_range, 1.0 + clip_range) * advantages)
+            loss = -surrogate.mean() + vf_coef * ((returns - values) ** 2).mean() - ent_coef * entropy.mean()
+            return loss, out
+
+    return PPOLoss()
+
+def export_artifacts(model_path, out_dir):
+    import torch
+    import onnx
+    from gymnasium import spaces
+    from onnxruntime.training import artifacts
+    from stable_baselines3 import PPO
+
+    model = PPO.load(model_path, device="cpu")
+    discrete = isinstance(model.action_space, spaces.Discrete)
+    if not discrete and not isinstance(model.action_space, spaces.Box):
+        raise ValueError(f"unsupported action space {model.action_space}, use Discrete or Box")
+
+    clip_range = model.clip_range(1.0) if callable(model.clip_range) else model.clip_range
+    module = make_loss_module(model.policy, discrete, float(clip_range), float(model.vf_coef), float(model.ent_coef))
+
+    batch = 2
+    obs_size = int(model.observation_space.shape[0])
+    act_size = 1 if discrete else int(model.action_space.shape[0])
+    sample = (
+        torch.zeros(batch, obs_size),
+        torch.zeros(batch) if discrete else torch.zeros(batch, act_size),
+        torch.zeros(batch),
+        torch.ones(batch),
+        torch.zeros(batch),
+    )
+
+    os.makedirs(out_dir, exist_ok=True)
+    graph_path = os.path.join(out_dir, "ppo_loss.onnx")
+    torch.onnx.export(module, sample, graph_path, input_names=INPUT_NAMES, output_names=["loss", "actions"],
+                      dynamic_axes={name: {0: "batch"} for name in INPUT_NAMES + ["actions"]},
+                      export_params=True, do_constant_folding=False, training=torch.onnx.TrainingMode.TRAINING)
+
+    graph = onnx.load(graph_path)
+    trainable = [init.name for init in graph.graph.initializer if init.name.startswith("policy.")]
+    # The graph already ends in the loss, no loss block is appended
+    artifacts.generate_artifacts(graph, requires_grad=trainable, frozen_params=[], loss=None,
+                                 optimizer=artifacts.OptimType.AdamW, artifact_directory=out_dir)
+    os.remove(graph_path)
+    return len(trainable), discrete, act_size
+
+def main():
+    parser = ap.ArgumentParser()
+    parser.add_argument("--model", type=str, required=True, help="stable-baselines3 PPO model zip")
+    parser.add_argument("--out", type=str, required=True, help="directory for the training artifacts")
+    args = parser.parse_args()
+
+    try:
+        num_params, discrete, act_size = export_artifacts(args.model, args.out)
+    except ValueError as e:
+        print(f"[export_training_artifacts] {e}")
+        sys.exit(1)
+
+    head = "Categorical head over the logits" if discrete else f"Gaussian head of size {act_size}, no LogStd"
+    print(f"[export_training_artifacts] Wrote artifacts with {num_params} trainable tensors to '{args.out}'")
+    print(f"[export_training_artifacts] Inputs: {', '.join(INPUT_NAMES)}. Policy heads: {head}")
+
+if __name__ == "__main__":
+    main()
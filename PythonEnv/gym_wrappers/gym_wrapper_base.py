@@ -24,7 +24,7 @@ class GymWrapperBase(gym.Env, metaclass=abc.ABCMeta):
             raise ValueError("A valid, pre-connected socket must be provided.")
 
         self.sock = sock
-        self.recv_buffer = ""
+        self.recv_buffer = b""
         self.obs_shape = obs_shape
         self.act_shape = act_shape
 
@@ -57,25 +57,44 @@ class GymWrapperBase(gym.Env, metaclass=abc.ABCMeta):
         Receive data from the Unreal environment until the newline delimiter is encountered.
         Returns the complete message (delimiter removed).
         """
+        header, _ = self.receive_frame(bufsize)
+        return header
+
+    def receive_frame(self, bufsize=1024):
+        """
+        Receive one message. Text messages end at the newline delimiter; binary frames
+        ("<header>;BYTES=<n>\n" + n bytes, used for schema packed observations) also carry a payload.
+        Returns (header str, payload bytes or None).
+        """
         if not self.sock:
-            return ""
+            return "", None
 
         try:
-            while "\n" not in self.recv_buffer:
+            while b"\n" not in self.recv_buffer:
                 data = self.sock.recv(bufsize)
                 if not data:
-                    break
-                self.recv_buffer += data.decode('utf-8')
-
-            if "\n" in self.recv_buffer:
-                message, self.recv_buffer = self.recv_buffer.split("\n", 1)
-                message = message.strip()
-                print(f"[GymWrapperBase] Received data: {message}")
-                return message
+                    return "", None
+                self.recv_buffer += data
+
+            line, self.recv_buffer = self.recv_buffer.split(b"\n", 1)
+            header = line.decode('utf-8').strip()
+
+            payload = None
+            nbytes = next((int(p[6:]) for p in header.split(";") if p.startswith("BYTES=")), None)
+            if nbytes is not None:
+                while len(self.recv_buffer) < nbytes:
+                    data = self.sock.recv(max(bufsize, nbytes - len(self.recv_buffer)))
+                    if not data:
+                        return "", None
+                    self.recv_buffer += data
+                payload, self.recv_buffer = self.recv_buffer[:nbytes], self.recv_buffer[nbytes:]
+
+            print(f"[GymWrapperBase] Received data: {header}")
+            return header, payload
         except Exception as e:
             print(f"[GymWrapperBase] Error receiving data: {e}")
 
-        return ""
+        return "", None
 
     @abc.abstractmethod
     def step(self, action):
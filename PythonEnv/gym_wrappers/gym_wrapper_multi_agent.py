@@ -0,0 +1,111 @@
+# gym_wrapper_multi_agent.py
+
+import numpy as np
+from gymnasium import spaces
+from .gym_wrapper_base import GymWrapperBase
+
+class GymWrapperMultiAgent(GymWrapperBase):
+    """
+    A PettingZoo-parallel style wrapper for the MultiAgentBridge protocol:
+      - One socket, one world, several agents with their own observation/action sizes
+        (declared in the handshake as "AGENTS=<name>:<obs>:<act>,...").
+      - On reset: sends "ACT=RESET"
+      - On step:  sends "AGENT=0;ACT=<...>||AGENT=1;ACT=<...>||..."
+      - Expects one packed response per step:
+          "AGENT=0;OBS=<...>;REW=<r>;DONE=<0|1>;TRUNC=<0|1>||AGENT=1;OBS=<...>;REW=<r>;DONE=<0|1>;TRUNC=<0|1>||..."
+    Observations, rewards, terminations, truncations and infos are dicts keyed by agent name.
+    """
+
+    def __init__(self, sock, agents):
+        """
+        :param sock:   A pre-connected TCP socket
+        :param agents: List of (name, obs_size, act_size) in agent index order
+        """
+        super().__init__(sock=sock,
+                         obs_shape=sum(a[1] for a in agents),
+                         act_shape=sum(a[2] for a in agents))
+
+        self.possible_agents = [name for name, _, _ in agents]
+        self.agents = list(self.possible_agents)
+        self.agent_index = {name: i for i, name in enumerate(self.possible_agents)}
+
+        self.observation_spaces = {
+            name: spaces.Box(low=-np.inf, high=np.inf, shape=(obs,), dtype=np.float32)
+            for name, obs, _ in agents
+        }
+        self.action_spaces = {
+            name: spaces.Box(low=-1.0, high=1.0, shape=(act,), dtype=np.float32)
+            for name, _, act in agents
+        }
+
+    def observation_space(self, agent):
+        return self.observation_spaces[agent]
+
+    def action_space(self, agent):
+        return self.action_spaces[agent]
+
+    def reset(self, seed=None, options=None):
+        """
+        Reset the whole world.
+        Returns:
+            observations (dict), infos (dict)
+        """
+        self.send_data("ACT=RESET")
+        obs, _, _, _ = self._parse_state(self.receive_data())
+        self.agents = list(self.possible_agents)
+        return obs, {name: {} for name in self.agents}
+
+    def step(self, actions):
+        """
+        :param actions: dict agent name -> action vector, agents missing from it or already finished are not sent
+        Returns:
+            observations, rewards, terminations, truncations, infos (dicts keyed by agent name),
+            holding only the agents that were live before this step
+        """
+        live = set(self.agents)
+        parts = []
+        for name, action in actions.items():
+            if name not in live:
+                continue
+            vals = ",".join(f"{a:.2f}" for a in np.asarray(action).ravel())
+            parts.append(f"AGENT={self.agent_index[name]};ACT={vals}")
+        self.send_data("||".join(parts))
+
+        obs, rewards, dones, truncations = self._parse_state(self.receive_data())
+
+        # PettingZoo parallel API: an agent is reported up to its terminal step, after that it is gone until reset
+        obs = {name: v for name, v in obs.items() if name in live}
+        rewards = {name: v for name, v in rewards.items() if name in live}
+        dones = {name: v for name, v in dones.items() if name in live}
+        truncations = {name: v for name, v in truncations.items() if name in live}
+        infos = {name: {} for name in obs}
+
+        # finished agents drop out until the next reset
+        self.agents = [name for name in self.agents if not (dones.get(name, False) or truncations.get(name, False))]
+        return obs, rewards, dones, truncations, infos
+
+    def _parse_state(self, data: str):
+        """
+        Parse a packed multi-agent state string into per-agent dicts.
+        Returns:
+            observations (dict), rewards (dict), dones (dict), truncations (dict)
+        """
+        obs, rewards, dones, truncations = {}, {}, {}, {}
+        for entry in data.split("||"):
+            kv = {k: v for k, _, v in (seg.strip().partition("=") for seg in entry.split(";")) if k}
+            try:
+                name = self.possible_agents[int(kv.get("AGENT", "-1"))]
+            except (ValueError, IndexError):
+                print(f"[GymWrapperMultiAgent] Error parsing agent entry '{entry}'")
+                continue
+
+            size = self.observation_spaces[name].shape[0]
+            values = np.fromstring(kv.get("OBS", ""), sep=",", dtype=np.float32)
+            agent_obs = np.zeros(size, dtype=np.float32)
+            agent_obs[:min(values.size, size)] = values[:size]
+
+            obs[name] = agent_obs
+            rewards[name] = float(kv.get("REW", "0"))
+            dones[name] = bool(int(kv.get("DONE", "0")))
+            truncations[name] = bool(int(kv.get("TRUNC", "0")))
+        return obs, rewards, dones, truncations
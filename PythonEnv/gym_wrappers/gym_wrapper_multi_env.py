@@ -3,6 +3,7 @@
 import numpy as np
 from gymnasium import spaces
 from .gym_wrapper_base import GymWrapperBase
+from . import schema
 
 class GymWrapperMultiEnv(GymWrapperBase):
     """
@@ -10,19 +11,40 @@ class GymWrapperMultiEnv(GymWrapperBase):
       - On reset: sends "ACT=RESET" to Unreal
       - On step:   sends "ACT=<a0>,<a1>,..." to Unreal
       - Expects responses of the form:
-          "OBS=<obs0>,<obs1>,...;REW=<reward>;DONE=<0|1>"
+          "OBS=<obs0>,<obs1>,...;REW=<reward>;DONE=<0|1>;TRUNC=<0|1>"
+      - With auto-reset (AUTO_RESET=1 in the handshake) episode ending steps also carry
+        "RESET_OBS=<...>", the first observation of the next episode. It is cached and
+        returned by the following reset() without a round-trip to Unreal.
+      - With an observation schema (OBS_SCHEMA in the handshake) responses are binary frames
+        "REW=..;DONE=..;TRUNC=..[;RESET_OBS=1];ENV=..;BYTES=<n>" + packed fields
+        (the reset observation follows the terminal one when RESET_OBS=1).
+      - With rollout storage (ROLLOUT=T in the handshake) call set_policy_outputs(value, log_prob) before step(),
+        they are sent as "ACT=<...>;VAL=<v>;LOGP=<l>" and Unreal ships whole rollouts over the admin socket.
+        After a truncated step also pass terminal_value, the value of the terminal observation ("TVAL=<v>"),
+        Unreal bootstraps the truncated step from it.
       - Uses the base class’s send_data / receive_data to handle TCP logic.
     """
 
-    def __init__(self, sock, obs_shape=0, act_shape=0, env_id=0):
+    def __init__(self, sock, obs_shape=0, act_shape=0, env_id=0, auto_reset=False,
+                 obs_schema=None, act_schema=None, frame_stack=1):
         """
         :param sock:       A pre-connected TCP socket to the MultiTcpConnection server
         :param obs_shape:  Number of observation dimensions per environment
         :param act_shape:  Number of action dimensions per environment
         :param env_id:     Integer index (0 ≤ env_id < ENV_COUNT) for this sub-environment
+        :param auto_reset: True if Unreal resets finished episodes itself (AUTO_RESET=1)
+        :param obs_schema: Parsed OBS_SCHEMA fields (see schema.parse_obs_schema), or None
+        :param act_schema: Parsed ACT_SCHEMA heads (see schema.parse_act_schema), or None
+        :param frame_stack: Frames per observation (FRAME_STACK), obs_shape already covers all of them
         """
         super().__init__(sock=sock, obs_shape=obs_shape, act_shape=act_shape)
         self.env_id = env_id
+        self.auto_reset = auto_reset
+        self._reset_obs = None
+        self.obs_schema = obs_schema or []
+        self.act_schema = act_schema or []
+        self.frame_stack = frame_stack
+        self._policy_outputs = ""
 
         # Define Box spaces for vector observations & actions
         self.observation_space = spaces.Box(
@@ -37,6 +59,10 @@ class GymWrapperMultiEnv(GymWrapperBase):
             shape=(self.act_shape,),
             dtype=np.float32
         )
+        if self.obs_schema:
+            self.observation_space = schema.build_observation_space(self.obs_schema, self.frame_stack)
+        if self.act_schema:
+            self.action_space = schema.build_action_space(self.act_schema)
 
     def reset(self, seed=None, options=None):
         """
@@ -45,12 +71,25 @@ class GymWrapperMultiEnv(GymWrapperBase):
         Returns:
             obs (np.ndarray), info (dict)
         """
+        # Unreal already reset this env after the last episode ended
+        if self._reset_obs is not None:
+            obs, self._reset_obs = self._reset_obs, None
+            return obs, {}
+
         # tell UE to reset this specific env
         self.send_data(f"ACT=RESET")
-        data = self.receive_data()
-        obs, reward, done = self._parse_state(data)
+        obs, reward, done, truncated = self._receive_state()
         return obs, {}
 
+    def set_policy_outputs(self, value, log_prob, terminal_value=None):
+        """
+        Value estimate and log probability of the next action, recorded by Unreal's rollout buffer.
+        terminal_value is the value of the terminal observation if the previous step was truncated.
+        """
+        self._policy_outputs = f";VAL={float(value):.6g};LOGP={float(log_prob):.6g}"
+        if terminal_value is not None:
+            self._policy_outputs += f";TVAL={float(terminal_value):.6g}"
+
     def step(self, action):
         """
         Take one step for this env instance.
@@ -59,26 +98,55 @@ class GymWrapperMultiEnv(GymWrapperBase):
             obs (np.ndarray),
             reward (float),
             done (bool),
-            truncated (False),
+            truncated (bool),
             info (dict)
         """
         # format the action vector
-        vals = ",".join(f"{a:.2f}" for a in action) if action is not None else ""
+        vals = schema.format_action(self.act_schema, action) if action is not None else ""
         # include the env index
-        self.send_data(f"ACT={vals}")
+        self.send_data(f"ACT={vals}{self._policy_outputs}")
+        self._policy_outputs = ""
+
+        obs, reward, done, truncated = self._receive_state()
+        return obs, reward, done, truncated, {}
 
-        data = self.receive_data()
-        obs, reward, done = self._parse_state(data)
-        return obs, reward, done, False, {}
+    def _receive_state(self):
+        """
+        Receive the next state, text or schema packed.
+        On terminal steps of an auto-reset env, keeps the next episode's observation for reset().
+        """
+        header, payload = self.receive_frame()
+        if not self.obs_schema or payload is None:
+            obs, reward, done, truncated = self._parse_state(header)
+            if self.auto_reset and (done or truncated):
+                self._reset_obs = self._parse_obs(header, "RESET_OBS")
+            return obs, reward, done, truncated
+
+        kv = dict(part.split("=", 1) for part in header.split(";") if "=" in part)
+        obs, offset = schema.decode_observation(self.obs_schema, payload, frame_stack=self.frame_stack)
+        if kv.get("RESET_OBS") == "1":
+            self._reset_obs, _ = schema.decode_observation(self.obs_schema, payload, offset, self.frame_stack)
+        return obs, float(kv.get("REW", "0")), bool(int(kv.get("DONE", "1"))), bool(int(kv.get("TRUNC", "0")))
+
+    def _parse_obs(self, data: str, key: str):
+        """
+        Returns the observation stored under key (e.g. "RESET_OBS") or None if missing.
+        """
+        for seg in data.split(";"):
+            k, _, v = seg.strip().partition("=")
+            if k == key:
+                return np.fromstring(v, sep=",", dtype=np.float32) if v else np.zeros(self.obs_shape, dtype=np.float32)
+        return None
 
     def _parse_state(self, data: str):
         """
         Parse a state string from MultiEnvBridge:
-            "OBS=<o0>,...;REW=<r>;DONE=<0|1>"
+            "OBS=<o0>,...;REW=<r>;DONE=<0|1>;TRUNC=<0|1>"
         Returns:
-            obs   (np.ndarray),
-            reward(float),
-            done  (bool)
+            obs      (np.ndarray),
+            reward   (float),
+            done     (bool),
+            truncated(bool)
         """
         try:
             parts = [seg.strip() for seg in data.split(";")]
@@ -88,15 +156,17 @@ class GymWrapperMultiEnv(GymWrapperBase):
             obs_str  = kv.get("OBS", "")
             rew_str  = kv.get("REW", "0")
             done_str = kv.get("DONE", "1")
+            trunc_str = kv.get("TRUNC", "0")
 
             obs    = (np.fromstring(obs_str, sep=",", dtype=np.float32)
                       if obs_str else np.zeros(self.obs_shape, dtype=np.float32))
             reward = float(rew_str)
             done   = bool(int(done_str))
+            truncated = bool(int(trunc_str))
 
-            return obs, reward, done
+            return obs, reward, done, truncated
 
         except Exception as e:
             print(f"[GymWrapperMultiEnv] Error parsing '{data}': {e}")
             default_obs = np.zeros(self.observation_space.shape, dtype=np.float32)
-            return default_obs, 0.0, True
+            return default_obs, 0.0, True, False
@@ -1,6 +1,7 @@
 import numpy as np
 from gymnasium import spaces
 from .gym_wrapper_base import GymWrapperBase
+from . import schema
 
 class GymWrapperSingleEnv(GymWrapperBase):
     """
@@ -9,16 +10,24 @@ class GymWrapperSingleEnv(GymWrapperBase):
       - On step: sends "ACT=<a0>,<a1>,..." to Unreal, then waits for a keyed response
       - Expects responses of the form:
           "OBS=<obs0>,<obs1>,...;REW=<reward>;DONE=<0|1>"
+      - With an observation schema (OBS_SCHEMA in the handshake) responses are binary frames
+          "REW=<reward>;DONE=<0|1>;BYTES=<n>" + packed fields, decoded into a Dict observation
       - All I/O uses the base class’s send_data / receive_data methods
     """
 
-    def __init__(self, sock, obs_shape=0, act_shape=0):
+    def __init__(self, sock, obs_shape=0, act_shape=0, obs_schema=None, act_schema=None, frame_stack=1):
         """
         :param sock:       A pre-connected TCP socket
         :param obs_shape:  Number of observation dimensions
         :param act_shape:  Number of action dimensions
+        :param obs_schema: Parsed OBS_SCHEMA fields (see schema.parse_obs_schema), or None
+        :param act_schema: Parsed ACT_SCHEMA heads (see schema.parse_act_schema), or None
+        :param frame_stack: Frames per observation (FRAME_STACK), obs_shape already covers all of them
         """
         super().__init__(sock=sock, obs_shape=obs_shape, act_shape=act_shape)
+        self.obs_schema = obs_schema or []
+        self.act_schema = act_schema or []
+        self.frame_stack = frame_stack
 
         # Define observation/action spaces
         self.observation_space = spaces.Box(
@@ -33,6 +42,10 @@ class GymWrapperSingleEnv(GymWrapperBase):
             shape=(self.act_shape,),
             dtype=np.float32
         )
+        if self.obs_schema:
+            self.observation_space = schema.build_observation_space(self.obs_schema, self.frame_stack)
+        if self.act_schema:
+            self.action_space = schema.build_action_space(self.act_schema)
 
     def reset(self, seed=None, options=None):
         """
@@ -42,8 +55,7 @@ class GymWrapperSingleEnv(GymWrapperBase):
             observation (np.ndarray), info (dict)
         """
         self.send_data("ACT=RESET")
-        data = self.receive_data()
-        obs, reward, done = self._parse_state(data)
+        obs, reward, done = self._receive_state()
         return obs, {}
 
     def step(self, action):
@@ -58,14 +70,23 @@ class GymWrapperSingleEnv(GymWrapperBase):
             info (dict)
         """
         # format comma‑separated floats
-        action_vals = ",".join(f"{a:.2f}" for a in action) if action is not None else ""
+        action_vals = schema.format_action(self.act_schema, action) if action is not None else ""
         # prefix with ACT=
         self.send_data(f"ACT={action_vals}")
 
-        data = self.receive_data()
-        obs, reward, done = self._parse_state(data)
+        obs, reward, done = self._receive_state()
         return obs, reward, done, False, {}
 
+    def _receive_state(self):
+        """Receive the next state, text or schema packed."""
+        header, payload = self.receive_frame()
+        if not self.obs_schema or payload is None:
+            return self._parse_state(header)
+
+        kv = dict(part.split("=", 1) for part in header.split(";") if "=" in part)
+        obs, _ = schema.decode_observation(self.obs_schema, payload, frame_stack=self.frame_stack)
+        return obs, float(kv.get("REW", "0")), bool(int(kv.get("DONE", "1")))
+
     def _parse_state(self, data: str):
         """
         Parse a SingleEnvBridge state string of the form:
@@ -0,0 +1,62 @@
+# obs_normalization.py
+
+import numpy as np
+
+# Text format of UBaseBridge::ExportNormalizationStats / ImportNormalizationStats:
+#   COUNT=<n>\nCLIP=<clip>\nEPSILON=<eps>\nMEAN=<m0>,<m1>,...\nVAR=<v0>,<v1>,...
+
+def save_stats(path, mean, var, count, clip=10.0, epsilon=1e-8):
+    """Write observation statistics in the format Unreal imports."""
+    mean = np.asarray(mean, dtype=np.float64).ravel()
+    var = np.asarray(var, dtype=np.float64).ravel()
+    if mean.shape != var.shape:
+        raise ValueError(f"mean has {mean.size} values, var has {var.size}")
+    with open(path, "w") as f:
+        f.write(f"COUNT={float(count):.17g}\n")
+        f.write(f"CLIP={float(clip):.9g}\n")
+        f.write(f"EPSILON={float(epsilon):.9g}\n")
+        f.write("MEAN=" + ",".join(f"{v:.9g}" for v in mean) + "\n")
+        f.write("VAR=" + ",".join(f"{v:.9g}" for v in var) + "\n")
+
+def load_stats(path):
+    """Read statistics exported by Unreal. Returns a dict: {"mean", "var", "count", "clip", "epsilon"}."""
+    stats = {"clip": 10.0, "epsilon": 1e-8}
+    with open(path, "r") as f:
+        for line in f:
+            key, sep, value = line.strip().partition("=")
+            if not sep:
+                continue
+            if key == "COUNT":
+                stats["count"] = float(value)
+            elif key == "CLIP":
+                stats["clip"] = float(value)
+            elif key == "EPSILON":
+                stats["epsilon"] = float(value)
+            elif key in ("MEAN", "VAR"):
+                stats[key.lower()] = np.array([float(v) for v in value.split(",") if v], dtype=np.float64)
+    return stats
+
+def normalize(obs, stats):
+    """Apply the same normalization as Unreal to the first len(mean) values of obs (last axis)."""
+    obs = np.array(obs, dtype=np.float32, copy=True)
+    n = stats["mean"].size
+    scaled = (obs[..., :n] - stats["mean"]) / np.sqrt(stats["var"] + stats["epsilon"])
+    obs[..., :n] = np.clip(scaled, -stats["clip"], stats["clip"])
+    return obs
+
+def export_vec_normalize(vec_normalize, path):
+    """Save the observation statistics of a stable-baselines3 VecNormalize for UBaseBridge::ImportNormalizationStats."""
+    rms = vec_normalize.obs_rms
+    save_stats(path, rms.mean, rms.var, rms.count, vec_normalize.clip_obs, vec_normalize.epsilon)
+
+def import_vec_normalize(vec_normalize, path):
+    """Load statistics exported by Unreal into a stable-baselines3 VecNormalize (e.g. to evaluate in Python)."""
+    stats = load_stats(path)
+    rms = vec_normalize.obs_rms
+    if rms.mean.shape != stats["mean"].shape:
+        raise ValueError(f"VecNormalize expects {rms.mean.shape} statistics, file has {stats['mean'].shape}")
+    rms.mean = stats["mean"]
+    rms.var = stats["var"]
+    rms.count = stats["count"]
+    vec_normalize.clip_obs = stats["clip"]
+    vec_normalize.epsilon = stats["epsilon"]
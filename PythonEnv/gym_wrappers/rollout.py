@@ -0,0 +1,89 @@
+# rollout.py
+
+import numpy as np
+
+# Binary rollout block of UMultiEnvBridge (RolloutLength > 0), sent over the admin socket as
+#   "ROLLOUT:T=<t>;N=<n>;OBS=<o>;ACT=<a>;BYTES=<size>\n" + payload
+# payload: little endian float32 arrays, time-major
+#   obs [T, N, OBS], actions [T, N, ACT],
+#   rewards, dones, truncations, terminal_values, values, log_probs, advantages, returns [T, N], env_mask [N]
+# dones are terminations only; truncated steps bootstrap from terminal_values (value of the terminal observation).
+# Actor mode (ACTOR=1;VERSION=<v>;BOOTSTRAP_OBS=1;TERMINAL_OBS=1) adds bootstrap_obs [N, OBS], the observations after
+# the last step, and terminal_obs [T, N, OBS], the observations truncated steps ended at (zeros elsewhere).
+# Values and advantages are zero there, the learner evaluates them, e.g. with vtrace().
+SCALAR_FIELDS = ("rewards", "dones", "truncations", "terminal_values", "values", "log_probs", "advantages", "returns")
+
+def decode_rollout(header, payload):
+    """Split a rollout frame into a dict of numpy arrays (views into payload)."""
+    body = header.split(":", 1)[1] if ":" in header else header
+    kv = dict(part.split("=", 1) for part in body.split(";") if "=" in part)
+    t, n, obs, act = (int(kv[key]) for key in ("T", "N", "OBS", "ACT"))
+
+    data = np.frombuffer(payload, dtype="<f4")
+    bootstrap = kv.get("BOOTSTRAP_OBS") == "1"
+    terminal = kv.get("TERMINAL_OBS") == "1"
+    expected = (t * n * (obs + act + len(SCALAR_FIELDS)) + n + (n * obs if bootstrap else 0)
+                + (t * n * obs if terminal else 0))
+    if data.size != expected:
+        raise ValueError(f"rollout holds {data.size} floats, header announces {expected}")
+
+    rollout = {}
+    offset = 0
+    for name, shape in (("obs", (t, n, obs)), ("actions", (t, n, act))):
+        size = int(np.prod(shape))
+        rollout[name] = data[offset:offset + size].reshape(shape)
+        offset += size
+    for name in SCALAR_FIELDS:
+        rollout[name] = data[offset:offset + t * n].reshape(t, n)
+        offset += t * n
+    rollout["env_mask"] = data[offset:offset + n].astype(bool)
+    offset += n
+    if bootstrap:
+        rollout["bootstrap_obs"] = data[offset:offset + n * obs].reshape(n, obs)
+        offset += n * obs
+    if terminal:
+        rollout["terminal_obs"] = data[offset:offset + t * n * obs].reshape(t, n, obs)
+    rollout["version"] = int(kv.get("VERSION", 0))
+    return rollout
+
+def flatten_rollout(rollout):
+    """[T * active envs] samples of every field, envs outside the rollout dropped, e.g. for PPO mini-batches."""
+    mask = rollout["env_mask"]
+    flat = {}
+    for name, values in rollout.items():
+        if name in ("env_mask", "bootstrap_obs", "version"):
+            continue
+        kept = values[:, mask]
+        flat[name] = kept.reshape((-1,) + kept.shape[2:])
+    return flat
+
+def vtrace(rewards, dones, values, bootstrap_values, behaviour_log_probs, target_log_probs,
+           gamma=0.99, rho_clip=1.0, c_clip=1.0, truncations=None, terminal_values=None):
+    """
+    V-trace targets for off-policy actor rollouts (Espeholt et al. 2018), all inputs [T, N] except
+    bootstrap_values [N]. Returns (vs, pg_advantages), both [T, N].
+    Truncated steps end the trace like dones but bootstrap from terminal_values, the learner's values of
+    their terminal observations (rollout["terminal_obs"]; without them a truncation counts as a termination).
+    """
+    rhos = np.exp(target_log_probs - behaviour_log_probs)
+    clipped_rhos = np.minimum(rhos, rho_clip)
+    cs = np.minimum(rhos, c_clip)
+    if truncations is not None:
+        dones = np.maximum(dones, truncations)
+        if terminal_values is not None:
+            rewards = rewards + gamma * truncations * terminal_values
+    discounts = gamma * (1.0 - dones)
+
+    next_values = np.concatenate([values[1:], bootstrap_values[None]], axis=0)
+    deltas = clipped_rhos * (rewards + discounts * next_values - values)
+
+    vs_minus_v = np.zeros_like(values)
+    acc = np.zeros_like(bootstrap_values)
+    for step in reversed(range(values.shape[0])):
+        acc = deltas[step] + discounts[step] * cs[step] * acc
+        vs_minus_v[step] = acc
+    vs = vs_minus_v + values
+
+    next_vs = np.concatenate([vs[1:], bootstrap_values[None]], axis=0)
+    pg_advantages = clipped_rhos * (rewards + discounts * next_vs - values)
+    return vs, pg_advantages
@@ -0,0 +1,130 @@
+# schema.py
+
+import numpy as np
+from gymnasium import spaces
+
+# dtype names used in the OBS_SCHEMA handshake entry
+WIRE_DTYPES = {
+    "float32": np.dtype("<f4"),
+    "float16": np.dtype("<f2"),
+    "uint8":   np.dtype("u1"),
+    "int32":   np.dtype("<i4"),
+    "qint8":   np.dtype("i1"),   # linear quantized, value = q * scale + offset
+    "quint16": np.dtype("<u2"),
+}
+QUANTIZED = ("qint8", "quint16")
+
+def parse_obs_schema(text):
+    """
+    Parse "OBS_SCHEMA=<name>:<dtype>:<d0>x<d1>...[:<scale>:<offset>],..." (value part only).
+    Returns a list of dicts: {"name", "dtype", "shape", "scale", "offset"} in wire order;
+    scale/offset are None for unquantized fields.
+    """
+    fields = []
+    for entry in filter(None, (e.strip() for e in text.split(","))):
+        name, dtype, shape, *quant = entry.split(":")
+        fields.append({
+            "name": name,
+            "dtype": WIRE_DTYPES[dtype],
+            "shape": tuple(int(d) for d in shape.split("x")),
+            "scale": float(quant[0]) if dtype in QUANTIZED else None,
+            "offset": float(quant[1]) if dtype in QUANTIZED else None,
+        })
+    return fields
+
+def parse_act_schema(text):
+    """
+    Parse "ACT_SCHEMA=<name>:<cont|disc>:<size>,..." (value part only).
+    Returns a list of dicts: {"name", "discrete", "size"}.
+    """
+    heads = []
+    for entry in filter(None, (e.strip() for e in text.split(","))):
+        name, kind, size = entry.split(":")
+        heads.append({"name": name, "discrete": kind == "disc", "size": int(size)})
+    return heads
+
+def packed_size(fields, frame_stack=1):
+    """Bytes of one packed observation (all stacked frames)."""
+    return frame_stack * sum(int(np.prod(f["shape"])) * f["dtype"].itemsize for f in fields)
+
+def build_observation_space(fields, frame_stack=1):
+    """Dict space, with FRAME_STACK=K every field gets a leading frame axis of K."""
+    spaces_by_name = {}
+    for f in fields:
+        shape = (frame_stack,) + f["shape"] if frame_stack > 1 else f["shape"]
+        if f["scale"] is not None:
+            # quantized fields are handed to the policy dequantized
+            spaces_by_name[f["name"]] = spaces.Box(low=-np.inf, high=np.inf, shape=shape, dtype=np.float32)
+        elif f["dtype"] == np.uint8:
+            spaces_by_name[f["name"]] = spaces.Box(low=0, high=255, shape=shape, dtype=np.uint8)
+        elif f["dtype"].kind == "i":
+            spaces_by_name[f["name"]] = spaces.Box(low=np.iinfo(np.int32).min, high=np.iinfo(np.int32).max,
+                                                   shape=shape, dtype=np.int32)
+        else:
+            spaces_by_name[f["name"]] = spaces.Box(low=-np.inf, high=np.inf, shape=shape, dtype=np.float32)
+    return spaces.Dict(spaces_by_name)
+
+def build_action_space(heads):
+    """
+    All discrete heads => MultiDiscrete, otherwise one flat Box. Continuous slots span [-1, 1],
+    each discrete head takes one slot spanning [0, size - 1] that is rounded on send.
+    """
+    if heads and all(h["discrete"] for h in heads):
+        return spaces.MultiDiscrete([h["size"] for h in heads])
+    if not heads:
+        return spaces.Box(low=-1.0, high=1.0, shape=(0,), dtype=np.float32)
+    low, high = [], []
+    for h in heads:
+        if h["discrete"]:
+            low.append(0.0)
+            high.append(float(h["size"] - 1))
+        else:
+            low.extend([-1.0] * h["size"])
+            high.extend([1.0] * h["size"])
+    return spaces.Box(low=np.array(low, dtype=np.float32), high=np.array(high, dtype=np.float32), dtype=np.float32)
+
+def decode_observation(fields, payload, offset=0, frame_stack=1):
+    """
+    Decode one packed observation starting at offset.
+    With frame_stack > 1 the frames are packed one after another (oldest first)
+    and stacked per field along a new leading axis.
+    Returns (dict name -> np.ndarray, next offset).
+    """
+    if frame_stack > 1:
+        frames = []
+        for _ in range(frame_stack):
+            frame, offset = decode_observation(fields, payload, offset)
+            frames.append(frame)
+        return {f["name"]: np.stack([fr[f["name"]] for fr in frames]) for f in fields}, offset
+
+    obs = {}
+    for f in fields:
+        count = int(np.prod(f["shape"]))
+        values = np.frombuffer(payload, dtype=f["dtype"], count=count, offset=offset)
+        offset += count * f["dtype"].itemsize
+        if f["scale"] is not None:
+            values = values.astype(np.float32) * np.float32(f["scale"]) + np.float32(f["offset"])
+        elif f["dtype"].kind == "f":
+            values = values.astype(np.float32)
+        elif f["dtype"].kind == "i":
+            values = values.astype(np.int32)
+        obs[f["name"]] = values.reshape(f["shape"])
+    return obs, offset
+
+def format_action(heads, action):
+    """
+    Format an action for "ACT=": continuous heads as %.2f, discrete heads as integers.
+    """
+    flat = np.asarray(action).ravel()
+    if not heads:
+        return ",".join(f"{a:.2f}" for a in flat)
+
+    vals, i = [], 0
+    for h in heads:
+        if h["discrete"]:
+            vals.append(str(int(np.clip(np.rint(flat[i]), 0, h["size"] - 1))))
+            i += 1
+        else:
+            vals.extend(f"{a:.2f}" for a in flat[i:i + h["size"]])
+            i += h["size"]
+    return ",".join(vals)
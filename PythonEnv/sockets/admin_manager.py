@@ -1,5 +1,8 @@
 import socket
 from collections import deque
+from sockets.socket_factory import send_hello
+from gym_wrappers.schema import parse_obs_schema, parse_act_schema
+from gym_wrappers.rollout import decode_rollout
 
 class AdminManager:
     """
@@ -7,22 +10,37 @@ class AdminManager:
     Intended for future extensibility to handle user and 
     system requests while training is underway.
     TCP uses and expects "\n" (newline char) as delimiter.
+    Binary frames ("<header>;BYTES=<n>\n" + n bytes, e.g. ROLLOUT blocks) carry a payload after the header.
     """
 
-    def __init__(self, ip="127.0.0.1", port=7777, bufsize=1024):
+    def __init__(self, ip="127.0.0.1", port=7777, bufsize=1024, bridge_id=None):
         self.ip = ip
         self.port = port
         self.bufsize = bufsize
+        self.bridge_id = bridge_id  # set when Unreal shares the port between bridges
         self.sock = None
 
-        self._recv_buffer = ""
-        self._msg_queue = deque() 
+        self._recv_buffer = b""
+        self._msg_queue = deque()  # (header, payload or None)
+        self.rollouts = deque()    # decoded ROLLOUT blocks, see wait_for_rollout()
+        self.policy_requests = deque()  # policy versions actors asked to replace, see publish_policy()
+        self.loaded_policy_version = 0  # last streamed policy Unreal reported as swapped in, see stream_policy()
+        self.failed_policy_versions = deque()  # streamed policies Unreal could not build, see stream_policy()
 
         # Handshake-related state
         self.env_type = None
         self.obs_shape = 0
         self.act_shape = 0
         self.env_count = 1   
+        self.auto_reset = False
+        self.async_batch = 0
+        self.frame_stack = 1  # observations carry the last frame_stack frames, oldest first
+        self.obs_norm = 0.0   # clip of the observation normalization done in Unreal, 0 if observations are raw
+        self.rollout_length = 0  # steps per env of the rollouts Unreal ships, 0 if transitions are not stored there
+        self.actor_mode = False  # Unreal acts with its local policy and only ships rollouts
+        self.agents = []   # (name, obs, act) per agent for MULTIAGENT
+        self.obs_schema = []  # typed observation fields, empty for flat float observations
+        self.act_schema = []
 
         self.handshake_completed = False
 
@@ -31,6 +49,8 @@ class AdminManager:
         self.sock = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
         try:
             self.sock.connect((self.ip, self.port))
+            if self.bridge_id:
+                send_hello(self.sock, self.bridge_id)
             print(f"[AdminManager] Connected to {self.ip}:{self.port}")
         except Exception as e:
             print(f"[AdminManager] Connection error: {e}")
@@ -46,9 +66,16 @@ class AdminManager:
     def receive_msg(self):
         """
         BLOCK until at least one full message (delimited by '\n') is received.
-        Return that message as a string (with '\n' removed).
+        Return that message as a string (with '\n' removed), binary payloads are dropped.
         If the socket closes prematurely, raises ConnectionError.
         """
+        return self.receive_frame()[0]
+
+    def receive_frame(self):
+        """
+        BLOCK until one full message is received.
+        Returns (header str, payload bytes or None).
+        """
         if not self.sock:
             raise ConnectionError("[AdminManager] No socket available.")
 
@@ -58,21 +85,61 @@ class AdminManager:
                 return self._msg_queue.popleft()
 
             # Otherwise, read more data from the socket.
-            data = self.sock.recv(self.bufsize)
+            data = self.sock.recv(max(self.bufsize, 65536))
             if not data:
                 raise ConnectionError("[AdminManager] Socket closed unexpectedly.")
-            self._recv_buffer += data.decode('utf-8')
+            self._recv_buffer += data
 
-            # Split out completed messages
-            while "\n" in self._recv_buffer:
-                msg, remainder = self._recv_buffer.split("\n", 1)
-                msg = msg.strip()
+            # Split out completed messages, binary frames wait until their whole payload arrived
+            while b"\n" in self._recv_buffer:
+                head, remainder = self._recv_buffer.split(b"\n", 1)
+                header = head.decode("utf-8").strip()
+                nbytes = next((int(p[6:]) for p in header.split(";") if p.startswith("BYTES=")), None)
+                payload = None
+                if nbytes is not None:
+                    if len(remainder) < nbytes:
+                        break
+                    payload, remainder = remainder[:nbytes], remainder[nbytes:]
                 self._recv_buffer = remainder
-                self._msg_queue.append(msg)
+                self._msg_queue.append((header, payload))
 
             # If we appended at least one message, we'll return it on the next loop iteration.
 
-    def process_message(self, msg):
+    def wait_for_rollout(self):
+        """
+        Blocks until Unreal ships the next rollout (ROLLOUT=T in the handshake).
+        Returns the dict of gym_wrappers.rollout.decode_rollout.
+        """
+        while not self.rollouts:
+            self.process_message(*self.receive_frame())
+        return self.rollouts.popleft()
+
+    def publish_policy(self, path, version):
+        """
+        Actor mode: tells Unreal to act with the ONNX policy at path (readable by the Unreal process).
+        Version is echoed in the following rollouts so the learner can measure policy lag.
+        """
+        if not self.sock:
+            raise ConnectionError("[AdminManager] No socket available.")
+        self.sock.sendall(f"POLICY:PATH={path};VERSION={int(version)}\n".encode("utf-8"))
+
+    def stream_policy(self, model_bytes, version, chunk_size=1 << 20):
+        """
+        Sends a model (ONNX bytes, or a .uemlp weight file for UInferenceInterfaceMLP) to the bridge's
+        InferenceInterface as MODEL_CHUNK frames, without touching the filesystem.
+        Unreal builds it in the background and answers MODEL_LOADED:VERSION=<version> once it acts with it,
+        or MODEL_FAILED:VERSION=<version> if it could not build it (the previous policy keeps acting).
+        """
+        if not self.sock:
+            raise ConnectionError("[AdminManager] No socket available.")
+        model_bytes = bytes(model_bytes)
+        total = len(model_bytes)
+        for offset in range(0, total, chunk_size):
+            chunk = model_bytes[offset:offset + chunk_size]
+            header = f"MODEL_CHUNK:VERSION={int(version)};OFFSET={offset};TOTAL={total};BYTES={len(chunk)}\n"
+            self.sock.sendall(header.encode("utf-8") + chunk)
+
+    def process_message(self, msg, payload=None):
         """
         Decide how to handle an incoming message. 
         Possible message types:
@@ -84,6 +151,21 @@ class AdminManager:
         if msg.startswith("CONFIG:"):
             self._handle_config(msg)
 
+        elif msg.startswith("ROLLOUT:"):
+            self.rollouts.append(decode_rollout(msg, payload or b""))
+
+        elif msg.startswith("MODEL_LOADED:"):
+            self.loaded_policy_version = int(msg.split("VERSION=", 1)[1].split(";")[0])
+
+        elif msg.startswith("MODEL_FAILED:"):
+            version = int(msg.split("VERSION=", 1)[1].split(";")[0])
+            self.failed_policy_versions.append(version)
+            print(f"[AdminManager] Unreal failed to load streamed policy version {version}, "
+                  f"still acting with version {self.loaded_policy_version}.")
+
+        elif msg.startswith("POLICY_REQUEST:"):
+            self.policy_requests.append(int(msg.split("VERSION=", 1)[1].split(";")[0]))
+
         else:
             print(f"[AdminManager] Received unrecognized message: {msg}")
             
@@ -107,6 +189,15 @@ class AdminManager:
             self.obs_shape = 0
             self.act_shape = 0
             self.env_count = 1
+            self.auto_reset = False
+            self.async_batch = 0
+            self.frame_stack = 1
+            self.obs_norm = 0.0
+            self.rollout_length = 0
+            self.actor_mode = False
+            self.agents = []
+            self.obs_schema = []
+            self.act_schema = []
 
             for part in parts:
                 if part.startswith("OBS="):
@@ -120,10 +211,39 @@ class AdminManager:
                         self.env_count = int(part.split("=")[1])
                     except:
                         pass
+                elif part.startswith("AUTO_RESET="):
+                    self.auto_reset = part.split("=")[1].strip() == "1"
+                elif part.startswith("OBS_SCHEMA="):
+                    self.obs_schema = parse_obs_schema(part.split("=", 1)[1])
+                elif part.startswith("ACT_SCHEMA="):
+                    self.act_schema = parse_act_schema(part.split("=", 1)[1])
+                elif part.startswith("AGENTS="):
+                    for entry in part.split("=", 1)[1].split(","):
+                        name, obs, act = entry.split(":")
+                        self.agents.append((name, int(obs), int(act)))
+                elif part.startswith("ASYNC_BATCH="):
+                    try:
+                        self.async_batch = int(part.split("=")[1])
+                    except:
+                        pass
+                elif part.startswith("FRAME_STACK="):
+                    self.frame_stack = max(int(part.split("=")[1]), 1)
+                elif part.startswith("OBS_NORM="):
+                    # Unreal normalizes, don't wrap the env in VecNormalize on top
+                    self.obs_norm = float(part.split("=")[1]) or float("inf")
+                elif part.startswith("ROLLOUT="):
+                    self.rollout_length = int(part.split("=")[1])
+                elif part.startswith("ACTOR="):
+                    self.actor_mode = part.split("=")[1].strip() == "1"
+
+            # OBS is the size of one frame, flat observations on the wire hold all stacked frames
+            self.obs_shape *= self.frame_stack
 
             self.handshake_completed = True
             print(f"[AdminManager] Parsed handshake -> ENV_TYPE={self.env_type}, "
-                  f"OBS={self.obs_shape}, ACT={self.act_shape}, ENV_COUNT={self.env_count}")
+                  f"OBS={self.obs_shape}, ACT={self.act_shape}, ENV_COUNT={self.env_count}, "
+                  f"AUTO_RESET={self.auto_reset}, ASYNC_BATCH={self.async_batch}, FRAME_STACK={self.frame_stack}, "
+                  f"OBS_NORM={self.obs_norm}, ROLLOUT={self.rollout_length}, ACTOR={self.actor_mode}")
         except Exception as e:
             print(f"[AdminManager] Error parsing CONFIG: {e}")
 
@@ -131,10 +251,7 @@ class AdminManager:
         """
         Check if command from Unreal was received, then runs it.
         """
-        # CURRENTLY BLOCKS UNTIL A MESSAGE FROM UNREAL WAS RECEIVED
-        # IN FUTURE, ADMIN SHOULD BE MOVED TO ITS OWN THREAD, AND THIS SHOULD BE RUN CONTINOUSLY
-        # TO CHECK IF ANY COMMANDS WERE RECEIVED
-        # FOR NOW AVOID USING OR ITLL JUST BLOCK EVERYTHING
+        # BLOCKS UNTIL A MESSAGE FROM UNREAL WAS RECEIVED, bridge.AdminTHD runs it continuously on its own thread
         self.process_message(self.receive_msg())
 
     def wait_for_handshake(self):
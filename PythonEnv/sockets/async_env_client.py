@@ -0,0 +1,117 @@
+# async_env_client.py
+
+import numpy as np
+
+from sockets.admin_manager import AdminManager
+from sockets.socket_factory import create_unreal_socket
+
+class AsyncEnvClient:
+    """
+    EnvPool-style asynchronous client for a MultiEnvBridge with ASYNC_BATCH=K.
+      - Opens the admin socket, waits for the handshake, then opens one socket per env.
+      - recv() blocks until Unreal ships a batch of K ready envs over the admin socket:
+          "BATCH:OBS=...;REW=..;DONE=..;TRUNC=..;ENV=i||OBS=...;ENV=j||..."
+      - send(env_ids, actions) writes "ACT=<...>" (or "ACT=RESET") to each env's socket.
+    The trainer only waits for the first K envs to finish, never for the slowest one.
+    TCP uses and expects "\n" (newline char) as delimiter.
+    """
+
+    def __init__(self, ip="127.0.0.1", port=7777, bridge_id=None):
+        self.ip = ip
+        self.port = port
+        self.bridge_id = bridge_id
+        self.admin = AdminManager(ip=ip, port=port, bridge_id=bridge_id)
+        self.env_socks = []
+
+        self.obs_shape = 0
+        self.act_shape = 0
+        self.env_count = 0
+        self.batch_size = 0
+        self.auto_reset = False
+
+    def connect(self):
+        """Connect admin + env sockets. Returns (obs_shape, act_shape, env_count, batch_size)."""
+        self.admin.connect()
+        env_type, self.obs_shape, self.act_shape, self.env_count = self.admin.wait_for_handshake()
+        if env_type != "MULTI" or self.admin.async_batch <= 0:
+            raise ValueError(f"[AsyncEnvClient] Bridge is not in async mode (ENV_TYPE={env_type}, "
+                             f"ASYNC_BATCH={self.admin.async_batch}).")
+        self.batch_size = self.admin.async_batch
+        self.auto_reset = self.admin.auto_reset
+
+        # env ids are assigned by Unreal in connection order
+        self.env_socks = [create_unreal_socket(self.ip, self.port, self.bridge_id) for _ in range(self.env_count)]
+        return self.obs_shape, self.act_shape, self.env_count, self.batch_size
+
+    def close(self):
+        for sock in self.env_socks:
+            try:
+                sock.close()
+            except Exception:
+                pass
+        self.env_socks = []
+        self.admin.close()
+
+    def reset_all(self):
+        """Ask every env for a fresh episode, observations arrive through recv()."""
+        self.send(list(range(self.env_count)), None)
+
+    def send(self, env_ids, actions, values=None, log_probs=None, terminal_values=None):
+        """
+        :param env_ids: Env ids returned by recv()
+        :param actions: Array [len(env_ids) x act_shape], or None to reset those envs
+        :param values, log_probs: Arrays [len(env_ids)] stored with the actions when Unreal keeps rollouts (ROLLOUT=T)
+        :param terminal_values: Array [len(env_ids)], value of the terminal observation for envs whose previous step
+                                was truncated (NaN for the others)
+        """
+        for row, env_id in enumerate(env_ids):
+            if actions is None:
+                msg = "ACT=RESET"
+            else:
+                msg = "ACT=" + ",".join(f"{a:.2f}" for a in np.asarray(actions[row]).ravel())
+                if values is not None:
+                    msg += f";VAL={float(values[row]):.6g};LOGP={float(log_probs[row]):.6g}"
+                if terminal_values is not None and not np.isnan(terminal_values[row]):
+                    msg += f";TVAL={float(terminal_values[row]):.6g}"
+            self.env_socks[env_id].sendall((msg + "\n").encode("utf-8"))
+
+    def recv(self):
+        """
+        Blocks until the next batch of ready envs arrives.
+        Returns:
+            env_ids   (np.ndarray[int32]  [K]),
+            obs       (np.ndarray[float32][K x obs_shape]),
+            rewards   (np.ndarray[float32][K]),
+            dones     (np.ndarray[bool]   [K]),
+            truncated (np.ndarray[bool]   [K]),
+            infos     (list of dict, "reset_obs" set for auto-reset envs)
+        """
+        while True:
+            msg, payload = self.admin.receive_frame()
+            if msg.startswith("BATCH:"):
+                return self._parse_batch(msg[len("BATCH:"):])
+            self.admin.process_message(msg, payload)
+
+    def _parse_batch(self, body: str):
+        entries = [e for e in body.split("||") if e.strip()]
+        k = len(entries)
+
+        env_ids = np.zeros(k, dtype=np.int32)
+        obs = np.zeros((k, self.obs_shape), dtype=np.float32)
+        rewards = np.zeros(k, dtype=np.float32)
+        dones = np.zeros(k, dtype=bool)
+        truncated = np.zeros(k, dtype=bool)
+        infos = [{} for _ in range(k)]
+
+        for row, entry in enumerate(entries):
+            kv = {key: v for key, _, v in (seg.strip().partition("=") for seg in entry.split(";")) if key}
+            env_ids[row] = int(kv.get("ENV", "-1"))
+            values = np.fromstring(kv.get("OBS", ""), sep=",", dtype=np.float32)
+            obs[row, :min(values.size, self.obs_shape)] = values[:self.obs_shape]
+            rewards[row] = float(kv.get("REW", "0"))
+            dones[row] = bool(int(kv.get("DONE", "0")))
+            truncated[row] = bool(int(kv.get("TRUNC", "0")))
+            if "RESET_OBS" in kv:
+                infos[row]["reset_obs"] = np.fromstring(kv["RESET_OBS"], sep=",", dtype=np.float32)
+
+        return env_ids, obs, rewards, dones, truncated, infos
@@ -2,12 +2,22 @@
 
 import socket
 
-def create_unreal_socket(ip, port):
+def send_hello(sock, bridge_id):
+    """
+    Identifies the target bridge on a port shared by several Unreal bridges.
+    Must be the first line sent on the socket.
+    """
+    sock.sendall(f"HELLO:BRIDGE={bridge_id}\n".encode("utf-8"))
+
+def create_unreal_socket(ip, port, bridge_id=None):
     """
     Creates and returns a new TCP socket connected to the given IP/port.
+    If bridge_id is given the socket says hello to that bridge (Unreal SharedBridgeId).
     Raises an exception if the connection fails.
     """
     s = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
     s.connect((ip, port))
+    if bridge_id:
+        send_hello(s, bridge_id)
     print(f"[SocketFactory] Created new socket to {ip}:{port}")
     return s
@@ -1,8 +1,9 @@
 import argparse as ap
 import sys, pathlib, queue, yaml
 from bridge import AdminTHD, envTHD
+from gym_wrappers.obs_normalization import export_vec_normalize, import_vec_normalize
 
-from stable_baselines3.common.vec_env import DummyVecEnv, SubprocVecEnv
+from stable_baselines3.common.vec_env import DummyVecEnv, SubprocVecEnv, VecNormalize
 from stable_baselines3 import PPO, A2C, SAC, TD3, DDPG
 from stable_baselines3.common.callbacks import CheckpointCallback
 
@@ -62,10 +63,12 @@ def load_config(cfg_file):
     resume = cfg.get("load_from_checkpoint", False)
     total_timesteps = cfg["total_timesteps"]
     checkpt_freq =cfg["checkpoint_freq"]
+    bridge_id = cfg.get("bridge_id")  # only needed when Unreal shares the port between bridges
+    normalize = cfg.get("normalize_observations", False)
 
     pathlib.Path(paths["save_dir"]).mkdir(parents=True, exist_ok=True)
 
-    return algo_class, hps, paths, resume, total_timesteps, checkpt_freq
+    return algo_class, hps, paths, resume, total_timesteps, checkpt_freq, bridge_id, normalize
 
 # -------------------- TRAINING SCRIPT -------------------- #
 def main():
@@ -84,17 +87,33 @@ def main():
         print(f"Config file not found: {cfg_file}")
         sys.exit(1)
 
-    algo, hps, paths, resume, total_timesteps, checkpt_freq = load_config(cfg_file)
+    algo, hps, paths, resume, total_timesteps, checkpt_freq, bridge_id, normalize = load_config(cfg_file)
 
     #Set up Admin daemon thread and block for handshake
     meta_q = queue.Queue(maxsize=1)
-    master = AdminTHD(ENV_IP, ENV_PORT, meta_q)
+    master = AdminTHD(ENV_IP, ENV_PORT, meta_q, bridge_id)
     master.start()
     meta_data = meta_q.get() #blocking for master
     if meta_data["env_type"] is None or meta_data["obs_shape"] == 0 or meta_data["act_shape"] == 0:
         print("[ERROR] Invalid handshake – aborting.")
         sys.exit(1)
     
+    if meta_data["env_type"] == "MULTIAGENT":
+        # per-agent dict spaces need a multi-agent trainer around gym_wrappers.gym_wrapper_multi_agent.GymWrapperMultiAgent
+        print("[ERROR] MULTIAGENT bridges are not supported by the SB3 training script.")
+        sys.exit(1)
+
+    if meta_data["actor_mode"]:
+        # actor mode acts with Unreal's local policy and only ships rollouts, it needs an off-policy learner
+        print("[ERROR] Actor mode bridges (ACTOR=1) are not supported by the SB3 training script.")
+        sys.exit(1)
+
+    if meta_data["rollout_length"]:
+        # SB3 keeps its own rollout buffer, it neither sends VAL/LOGP with actions nor consumes ROLLOUT frames
+        print("[ERROR] Rollout storage in Unreal (ROLLOUT=) is not supported by the SB3 training script, "
+              "set RolloutLength to 0.")
+        sys.exit(1)
+
     #With admin meta data returned from the queue, set up the sb3 vec_env with gymwrapper 
     env_fns, is_multi = envTHD(ENV_IP, ENV_PORT, meta_data).build()
     if is_multi:
@@ -102,6 +121,18 @@ def main():
     else:
         vec_env = DummyVecEnv(env_fns)
 
+    #Observation normalization, either Unreal normalizes (OBS_NORM in the handshake) or VecNormalize does, never both
+    if normalize and meta_data["obs_norm"]:
+        print("[Training] Unreal normalizes observations (OBS_NORM), skipping VecNormalize.")
+        normalize = False
+    elif normalize and meta_data["obs_schema"]:
+        print("[Training] VecNormalize statistics can only be shared with Unreal for flat observations, skipping VecNormalize.")
+        normalize = False
+    if normalize:
+        vec_env = VecNormalize(vec_env, norm_obs=True, norm_reward=False)
+        if resume and paths.get("previous_obs_stats"):
+            import_vec_normalize(vec_env, paths["previous_obs_stats"])
+
     #Begin training, decide wether to continue training from a checkpoint or start fresh
     if resume:
         print("\n =====================Continue training from previous checkpoint======================\n")
@@ -123,6 +154,12 @@ def main():
     model.save(path=paths["save_dir"])
     print(f"[Training] Model saved to '{paths['save_dir']}'")
 
+    #Save the statistics in the format of UBaseBridge::ImportNormalizationStats, so inference in Unreal normalizes the same way
+    if normalize:
+        stats_path = pathlib.Path(paths["save_dir"]) / "obs_norm_stats.txt"
+        export_vec_normalize(vec_env, stats_path)
+        print(f"[Training] Observation statistics saved to '{stats_path}'")
+
     #Close off bridge connection to UE and end training session
     meta_data["admin"].close()
     vec_env.close()
@@ -78,15 +78,35 @@ FString UBPFL_DataHelpers::AppendToStateString_Int(const FString& BaseState, int
 
 FString UBPFL_DataHelpers::ArrayToStateString(const TArray<float>& FloatArray, int32 Precision)
 {
-    TArray<FString> StringArray;
+    return ArrayViewToStateString(FloatArray, Precision);
+}
+
+FString UBPFL_DataHelpers::ArrayViewToStateString(TConstArrayView<float> Values, int32 Precision)
+{
+    FString Result;
+    Result.Reserve(Values.Num() * (Precision + 4));
 
     // Convert each float to a string using comma separation.
-    for (float Value : FloatArray)
+    for (int32 i = 0; i < Values.Num(); i++)
+    {
+        if (i > 0)
+        {
+            Result += TEXT(",");
+        }
+        Result += FString::Printf(TEXT("%.*f"), Precision, Values[i]);
+    }
+    return Result;
+}
+
+int32 UBPFL_DataHelpers::ParseStateStringInto(const FString& MixedString, TArrayView<float> OutValues)
+{
+    const TArray<float> Parsed = ParseStateString(MixedString);
+    const int32 NumToCopy = FMath::Min(Parsed.Num(), OutValues.Num());
+    for (int32 i = 0; i < OutValues.Num(); i++)
     {
-        StringArray.Add(FString::Printf(TEXT("%.*f"), Precision, Value));
+        OutValues[i] = i < NumToCopy ? Parsed[i] : 0.f;
     }
-    // Join the array elements with a comma.
-    return FString::Join(StringArray, TEXT(","));
+    return Parsed.Num();
 }
 
 FString UBPFL_DataHelpers::AppendToStateString_Array(const FString& BaseState, const TArray<float>& FloatArray, int32 Precision)
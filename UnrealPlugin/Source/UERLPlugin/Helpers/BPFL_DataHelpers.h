@@ -82,6 +82,19 @@ public:
     UFUNCTION(BlueprintCallable, Category = "DataHelpers")
     static FString ArrayToStateString(const TArray<float>& FloatArray, int32 Precision = 2);
 
+    /**
+     * Same as ArrayToStateString, for values that live inside a larger buffer (C++ only).
+     */
+    static FString ArrayViewToStateString(TConstArrayView<float> Values, int32 Precision = 2);
+
+    /**
+     * Parses a state string (see ParseStateString) straight into a fixed size buffer (C++ only).
+     * Extra values are dropped and missing values are zero filled.
+     *
+     * @return The number of values found in the string.
+     */
+    static int32 ParseStateStringInto(const FString& MixedString, TArrayView<float> OutValues);
+
     /**
      * Appends an array of floats (converted to a string with comma separation) to an existing state string.
      * The array portion is appended using ";" as the delimiter.
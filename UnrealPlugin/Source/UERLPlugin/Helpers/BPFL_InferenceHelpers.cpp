@@ -0,0 +1,222 @@
+#include "BPFL_InferenceHelpers.h"
+#include "Inference/InferenceInterfaces/InferenceInterface.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/FileManager.h"
+#include "Math/RandomStream.h"
+#include "Misc/FileHelper.h"
+#include "UERLPlugin/Helpers/BPFL_DataHelpers.h"
+
+namespace
+{
+    constexpr int32 WarmupRuns = 10;
+
+    void MakeBatch(int32 ObservationSize, int32 BatchSize, TArray<int32>& OutAgentIds, TArray<float>& OutObservations)
+    {
+        FRandomStream Stream(1234);
+        OutAgentIds.SetNumUninitialized(BatchSize);
+        OutObservations.SetNumUninitialized(BatchSize * ObservationSize);
+        for (int32 i = 0; i < BatchSize; i++)
+        {
+            OutAgentIds[i] = i;
+        }
+        for (float& Value : OutObservations)
+        {
+            Value = Stream.FRandRange(-1.f, 1.f);
+        }
+    }
+
+    /** Microseconds per run, negative on failure. OutActions holds the actions of the last run. */
+    double TimeRuns(UInferenceInterface* Interface, TConstArrayView<int32> AgentIds, TConstArrayView<float> Observations, int32 Iterations, TArray<float>& OutActions)
+    {
+        for (int32 i = 0; i < WarmupRuns; i++)
+        {
+            if (!Interface->RunInferenceBatch(AgentIds, Observations, OutActions))
+            {
+                return -1.0;
+            }
+        }
+
+        const double Start = FPlatformTime::Seconds();
+        for (int32 i = 0; i < Iterations; i++)
+        {
+            Interface->RunInferenceBatch(AgentIds, Observations, OutActions);
+        }
+        return (FPlatformTime::Seconds() - Start) * 1e6 / FMath::Max(Iterations, 1);
+    }
+
+    /** "max <d>, mean <d>, identical <p>%" over two action arrays of the same size. */
+    FString DescribeDivergence(TConstArrayView<float> Reference, TConstArrayView<float> Candidate)
+    {
+        double MaxDifference = 0.0;
+        double SumDifference = 0.0;
+        int32 NumIdentical = 0;
+        for (int32 i = 0; i < Reference.Num(); i++)
+        {
+            const double Difference = FMath::Abs(Reference[i] - Candidate[i]);
+            MaxDifference = FMath::Max(MaxDifference, Difference);
+            SumDifference += Difference;
+            NumIdentical += Reference[i] == Candidate[i] ? 1 : 0;
+        }
+        const int32 Count = FMath::Max(Reference.Num(), 1);
+        return FString::Printf(TEXT("max action difference %g, mean %g, identical %.1f%%"),
+            MaxDifference, SumDifference / Count, 100.0 * NumIdentical / Count);
+    }
+}
+
+float UBPFL_InferenceHelpers::BenchmarkInference(UInferenceInterface* Interface, int32 ObservationSize, int32 BatchSize, int32 Iterations)
+{
+    if (!Interface || ObservationSize <= 0 || BatchSize <= 0)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("[UBPFL_InferenceHelpers] BenchmarkInference: Needs an interface and positive sizes."));
+        return -1.f;
+    }
+
+    TArray<int32> AgentIds;
+    TArray<float> Observations;
+    TArray<float> Actions;
+    MakeBatch(ObservationSize, BatchSize, AgentIds, Observations);
+    const double Microseconds = TimeRuns(Interface, AgentIds, Observations, Iterations, Actions);
+
+    UE_LOG(LogTemp, Log, TEXT("[UBPFL_InferenceHelpers] %s batch %d: %.2f us per run (%.3f us per observation)."),
+        *Interface->GetClass()->GetName(), BatchSize, Microseconds, Microseconds / BatchSize);
+    return static_cast<float>(Microseconds);
+}
+
+FString UBPFL_InferenceHelpers::CompareInferenceBackends(UInferenceInterface* Reference, UInferenceInterface* Candidate, int32 ObservationSize, int32 Iterations)
+{
+    if (!Reference || !Candidate || ObservationSize <= 0)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("[UBPFL_InferenceHelpers] CompareInferenceBackends: Needs two interfaces and a positive observation size."));
+        return FString();
+    }
+
+    // sampled actions would differ by design, compare the distribution modes
+    const bool bReferenceDeterministic = Reference->bDeterministicActions;
+    const bool bCandidateDeterministic = Candidate->bDeterministicActions;
+    Reference->bDeterministicActions = true;
+    Candidate->bDeterministicActions = true;
+
+    FString Report = FString::Printf(TEXT("%s vs %s, %d inputs\n"), *Reference->GetClass()->GetName(), *Candidate->GetClass()->GetName(), ObservationSize);
+    const int32 BatchSizes[] = { 1, 256 };
+    for (const int32 BatchSize : BatchSizes)
+    {
+        TArray<int32> AgentIds;
+        TArray<float> Observations;
+        TArray<float> ReferenceActions;
+        TArray<float> CandidateActions;
+        MakeBatch(ObservationSize, BatchSize, AgentIds, Observations);
+
+        const double ReferenceTime = TimeRuns(Reference, AgentIds, Observations, Iterations, ReferenceActions);
+        const double CandidateTime = TimeRuns(Candidate, AgentIds, Observations, Iterations, CandidateActions);
+        if (ReferenceTime < 0.0 || CandidateTime < 0.0 || ReferenceActions.Num() != CandidateActions.Num())
+        {
+            Report += FString::Printf(TEXT("batch %d: failed (%d vs %d action values)\n"), BatchSize, ReferenceActions.Num(), CandidateActions.Num());
+            continue;
+        }
+
+        Report += FString::Printf(TEXT("batch %d: %.2f us vs %.2f us (x%.2f), %s\n"), BatchSize, ReferenceTime, CandidateTime,
+            ReferenceTime / FMath::Max(CandidateTime, 1e-3), *DescribeDivergence(ReferenceActions, CandidateActions));
+    }
+
+    Reference->bDeterministicActions = bReferenceDeterministic;
+    Candidate->bDeterministicActions = bCandidateDeterministic;
+
+    UE_LOG(LogTemp, Log, TEXT("[UBPFL_InferenceHelpers] %s"), *Report);
+    return Report;
+}
+
+bool UBPFL_InferenceHelpers::AppendObservationToFile(const FString& FilePath, const TArray<float>& Observation)
+{
+    const FString Line = UBPFL_DataHelpers::ArrayToStateString(Observation, 6) + LINE_TERMINATOR;
+    return FFileHelper::SaveStringToFile(Line, *FilePath, FFileHelper::EEncodingOptions::AutoDetect, &IFileManager::Get(), FILEWRITE_Append);
+}
+
+FString UBPFL_InferenceHelpers::CompareOnRecordedObservations(UInferenceInterface* Reference, UInferenceInterface* Candidate, const FString& ObservationFile, int32 BatchSize)
+{
+    TArray<FString> Lines;
+    if (!Reference || !Candidate || !FFileHelper::LoadFileToStringArray(Lines, *ObservationFile))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("[UBPFL_InferenceHelpers] CompareOnRecordedObservations: Needs two interfaces and a readable observation file."));
+        return FString();
+    }
+
+    // one observation per line, all of the first line's size
+    TArray<float> Observations;
+    int32 ObservationSize = 0;
+    int32 NumObservations = 0;
+    for (const FString& Line : Lines)
+    {
+        const TArray<float> Observation = UBPFL_DataHelpers::ParseStateString(Line);
+        if (Observation.Num() == 0 || (ObservationSize > 0 && Observation.Num() != ObservationSize))
+        {
+            continue;
+        }
+        ObservationSize = Observation.Num();
+        Observations.Append(Observation);
+        NumObservations++;
+    }
+    BatchSize = FMath::Clamp(BatchSize, 1, FMath::Max(NumObservations, 1));
+    if (NumObservations == 0)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("[UBPFL_InferenceHelpers] CompareOnRecordedObservations: No observations in %s"), *ObservationFile);
+        return FString();
+    }
+
+    const bool bReferenceDeterministic = Reference->bDeterministicActions;
+    const bool bCandidateDeterministic = Candidate->bDeterministicActions;
+    Reference->bDeterministicActions = true;
+    Candidate->bDeterministicActions = true;
+
+    TArray<int32> AgentIds;
+    TArray<float> ReferenceActions;
+    TArray<float> CandidateActions;
+    TArray<float> AllReferenceActions;
+    TArray<float> AllCandidateActions;
+    double ReferenceSeconds = 0.0;
+    double CandidateSeconds = 0.0;
+    int32 NumBatches = 0;
+    bool bFailed = false;
+    for (int32 First = 0; First < NumObservations && !bFailed; First += BatchSize)
+    {
+        const int32 Count = FMath::Min(BatchSize, NumObservations - First);
+        AgentIds.SetNumUninitialized(Count);
+        for (int32 i = 0; i < Count; i++)
+        {
+            AgentIds[i] = i;
+        }
+        const TConstArrayView<float> Batch = TConstArrayView<float>(Observations).Slice(First * ObservationSize, Count * ObservationSize);
+
+        double Start = FPlatformTime::Seconds();
+        bFailed |= !Reference->RunInferenceBatch(AgentIds, Batch, ReferenceActions);
+        ReferenceSeconds += FPlatformTime::Seconds() - Start;
+
+        Start = FPlatformTime::Seconds();
+        bFailed |= !Candidate->RunInferenceBatch(AgentIds, Batch, CandidateActions);
+        CandidateSeconds += FPlatformTime::Seconds() - Start;
+
+        bFailed |= ReferenceActions.Num() != CandidateActions.Num();
+        AllReferenceActions.Append(ReferenceActions);
+        AllCandidateActions.Append(CandidateActions);
+        NumBatches++;
+    }
+
+    Reference->bDeterministicActions = bReferenceDeterministic;
+    Candidate->bDeterministicActions = bCandidateDeterministic;
+
+    FString Report = FString::Printf(TEXT("%s vs %s, %d recorded observations of %d values, batch %d\n"),
+        *Reference->GetClass()->GetName(), *Candidate->GetClass()->GetName(), NumObservations, ObservationSize, BatchSize);
+    if (bFailed)
+    {
+        Report += TEXT("failed, the backends rejected the observations or returned different action sizes\n");
+    }
+    else
+    {
+        const double ReferenceTime = ReferenceSeconds * 1e6 / NumBatches;
+        const double CandidateTime = CandidateSeconds * 1e6 / NumBatches;
+        Report += FString::Printf(TEXT("%.2f us vs %.2f us per batch (x%.2f), %s\n"), ReferenceTime, CandidateTime,
+            ReferenceTime / FMath::Max(CandidateTime, 1e-3), *DescribeDivergence(AllReferenceActions, AllCandidateActions));
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("[UBPFL_InferenceHelpers] %s"), *Report);
+    return Report;
+}
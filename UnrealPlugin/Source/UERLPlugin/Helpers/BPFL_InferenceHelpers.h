@@ -0,0 +1,55 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Kismet/BlueprintFunctionLibrary.h"
+#include "BPFL_InferenceHelpers.generated.h"
+
+class UInferenceInterface;
+
+/**
+ * A Blueprint Function Library for measuring inference backends.
+ * - Observations are uniform random in [-1, 1] from a fixed seed, so runs are comparable.
+ * - Batches use agent ids 0..BatchSize-1, recurrent models keep their state between iterations.
+ * - Timings are wall clock per RunInferenceBatch call, after a few warm-up runs.
+ */
+UCLASS()
+class UERLPLUGIN_API UBPFL_InferenceHelpers : public UBlueprintFunctionLibrary
+{
+    GENERATED_BODY()
+
+public:
+    /**
+     * Average time of one batched inference run.
+     *
+     * @param Interface A loaded inference interface.
+     * @param ObservationSize Values per observation the model expects.
+     * @param BatchSize Observations per run.
+     * @param Iterations Timed runs.
+     * @return Microseconds per run, negative if the interface failed.
+     */
+    UFUNCTION(BlueprintCallable, Category = "InferenceHelpers")
+    static float BenchmarkInference(UInferenceInterface* Interface, int32 ObservationSize, int32 BatchSize = 1, int32 Iterations = 1000);
+
+    /**
+     * Times Reference and Candidate at batch 1 and 256 on the same observations and reports the largest
+     * action difference between them. The report is also written to the log.
+     */
+    UFUNCTION(BlueprintCallable, Category = "InferenceHelpers")
+    static FString CompareInferenceBackends(UInferenceInterface* Reference, UInferenceInterface* Candidate, int32 ObservationSize, int32 Iterations = 1000);
+
+    /**
+     * Appends one observation as a comma separated line to FilePath, building a recorded observation set
+     * for CompareOnRecordedObservations(). Call it with the observations your agents actually see.
+     */
+    UFUNCTION(BlueprintCallable, Category = "InferenceHelpers")
+    static bool AppendObservationToFile(const FString& FilePath, const TArray<float>& Observation);
+
+    /**
+     * Runs Reference (e.g. the FP32 model) and Candidate (e.g. its INT8 or FP16 version) over every recorded
+     * observation in batches of BatchSize and reports the time per batch of each, and the max / mean action
+     * difference and share of identical action values (meaningful for discrete heads) in deterministic mode.
+     * The report is also written to the log.
+     */
+    UFUNCTION(BlueprintCallable, Category = "InferenceHelpers")
+    static FString CompareOnRecordedObservations(UInferenceInterface* Reference, UInferenceInterface* Candidate, const FString& ObservationFile, int32 BatchSize = 256);
+};
@@ -0,0 +1,164 @@
+#include "BPFL_PackingHelpers.h"
+#include "Math/Float16.h"
+
+namespace
+{
+    template <typename T>
+    void WriteValue(uint8* Dest, T Value)
+    {
+        FMemory::Memcpy(Dest, &Value, sizeof(T));
+    }
+
+    template <typename T>
+    T ReadValue(const uint8* Src)
+    {
+        T Value;
+        FMemory::Memcpy(&Value, Src, sizeof(T));
+        return Value;
+    }
+
+    int32 Quantize(float Value, const FObservationField& Field, int32 MinCode, int32 MaxCode)
+    {
+        // Scale is non zero (checked by FObservationSchema::Validate), clamp before rounding so
+        // out of range values cannot overflow the int conversion, NaN maps to the Offset code
+        const float Code = (Value - Field.Offset) / Field.Scale;
+        if (FMath::IsNaN(Code))
+        {
+            return FMath::Clamp(0, MinCode, MaxCode);
+        }
+        return FMath::RoundToInt(FMath::Clamp(Code, static_cast<float>(MinCode), static_cast<float>(MaxCode)));
+    }
+}
+
+FObservationField UBPFL_PackingHelpers::MakeQuantizedField(const FString& Name, EObservationDType DType, const TArray<int32>& Shape, float MinValue, float MaxValue)
+{
+    FObservationField Field;
+    Field.Name = Name;
+    Field.DType = DType;
+    Field.Shape = Shape;
+    if (!Field.IsQuantized())
+    {
+        return Field;
+    }
+
+    // map MinValue to the lowest code and MaxValue to the highest
+    const int32 MinCode = DType == EObservationDType::QInt8 ? -128 : 0;
+    const int32 MaxCode = DType == EObservationDType::QInt8 ? 127 : 65535;
+    const float Range = FMath::Max(MaxValue - MinValue, UE_SMALL_NUMBER);
+    Field.Scale = Range / static_cast<float>(MaxCode - MinCode);
+    Field.Offset = MinValue - MinCode * Field.Scale;
+    return Field;
+}
+
+TArray<uint8> UBPFL_PackingHelpers::PackObservation(const FObservationSchema& Schema, const TArray<float>& Observation)
+{
+    TArray<uint8> Bytes;
+    PackObservationAppend(Schema, Observation, Bytes);
+    return Bytes;
+}
+
+void UBPFL_PackingHelpers::PackObservationAppend(const FObservationSchema& Schema, TConstArrayView<float> Observation, TArray<uint8>& OutBytes)
+{
+    const int32 Start = OutBytes.Num();
+    OutBytes.AddUninitialized(Schema.GetPackedObservationBytes());
+    PackFieldsInto(Schema.Fields, Observation, TArrayView<uint8>(OutBytes.GetData() + Start, OutBytes.Num() - Start));
+}
+
+void UBPFL_PackingHelpers::PackFieldsInto(TConstArrayView<FObservationField> Fields, TConstArrayView<float> Values, TArrayView<uint8> OutBytes)
+{
+    uint8* Dest = OutBytes.GetData();
+    const uint8* End = Dest + OutBytes.Num();
+
+    int32 ValueIdx = 0;
+    for (const FObservationField& Field : Fields)
+    {
+        check(Dest + Field.GetNumElements() * Field.GetElementSize() <= End);
+        const int32 NumElements = Field.GetNumElements();
+        for (int32 i = 0; i < NumElements; i++, ValueIdx++)
+        {
+            const float Value = ValueIdx < Values.Num() ? Values[ValueIdx] : 0.f;
+            switch (Field.DType)
+            {
+            case EObservationDType::Float16:
+                WriteValue<uint16>(Dest, FFloat16(Value).Encoded);
+                Dest += 2;
+                break;
+            case EObservationDType::UInt8:
+                *Dest = static_cast<uint8>(FMath::Clamp(FMath::RoundToInt(Value), 0, 255));
+                Dest += 1;
+                break;
+            case EObservationDType::Int32:
+                WriteValue<int32>(Dest, FMath::RoundToInt(Value));
+                Dest += 4;
+                break;
+            case EObservationDType::QInt8:
+                WriteValue<int8>(Dest, static_cast<int8>(Quantize(Value, Field, -128, 127)));
+                Dest += 1;
+                break;
+            case EObservationDType::QUInt16:
+                WriteValue<uint16>(Dest, static_cast<uint16>(Quantize(Value, Field, 0, 65535)));
+                Dest += 2;
+                break;
+            default:
+                WriteValue<float>(Dest, Value);
+                Dest += 4;
+                break;
+            }
+        }
+    }
+}
+
+int32 UBPFL_PackingHelpers::UnpackObservation(const FObservationSchema& Schema, TConstArrayView<uint8> Bytes, TArrayView<float> OutObservation)
+{
+    if (Bytes.Num() < Schema.GetPackedObservationBytes())
+    {
+        return 0;
+    }
+
+    const uint8* Src = Bytes.GetData();
+    int32 ValueIdx = 0;
+    for (const FObservationField& Field : Schema.Fields)
+    {
+        const int32 NumElements = Field.GetNumElements();
+        for (int32 i = 0; i < NumElements; i++, ValueIdx++)
+        {
+            float Value = 0.f;
+            switch (Field.DType)
+            {
+            case EObservationDType::Float16:
+            {
+                FFloat16 Half;
+                Half.Encoded = ReadValue<uint16>(Src);
+                Value = Half.GetFloat();
+                Src += 2;
+                break;
+            }
+            case EObservationDType::UInt8:
+                Value = *Src;
+                Src += 1;
+                break;
+            case EObservationDType::Int32:
+                Value = static_cast<float>(ReadValue<int32>(Src));
+                Src += 4;
+                break;
+            case EObservationDType::QInt8:
+                Value = ReadValue<int8>(Src) * Field.Scale + Field.Offset;
+                Src += 1;
+                break;
+            case EObservationDType::QUInt16:
+                Value = ReadValue<uint16>(Src) * Field.Scale + Field.Offset;
+                Src += 2;
+                break;
+            default:
+                Value = ReadValue<float>(Src);
+                Src += 4;
+                break;
+            }
+            if (ValueIdx < OutObservation.Num())
+            {
+                OutObservation[ValueIdx] = Value;
+            }
+        }
+    }
+    return static_cast<int32>(Src - Bytes.GetData());
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Kismet/BlueprintFunctionLibrary.h"
+#include "TrainingBridges/Schema/ObservationSchema.h"
+#include "BPFL_PackingHelpers.generated.h"
+
+/**
+ * A Blueprint Function Library for packing observations into their schema dtypes.
+ * - Values are taken from the flat float observation, field after field.
+ * - uint8 and int32 values are rounded (uint8 clamped to 0..255), float16 keeps the nearest half.
+ * - qint8/quint16 are linear quantized with the field's Scale/Offset and clamped to the type range.
+ * - Output is little endian, matching numpy's default on every platform we ship.
+ */
+UCLASS()
+class UERLPLUGIN_API UBPFL_PackingHelpers : public UBlueprintFunctionLibrary
+{
+    GENERATED_BODY()
+
+public:
+    /**
+     * Packs a flat observation into bytes as described by Schema.
+     * Missing values are packed as zero, extra values are ignored.
+     *
+     * @param Schema The observation layout.
+     * @param Observation Flat float observation.
+     * @return The packed bytes.
+     */
+    UFUNCTION(BlueprintCallable, Category = "PackingHelpers")
+    static TArray<uint8> PackObservation(const FObservationSchema& Schema, const TArray<float>& Observation);
+
+    /**
+     * Makes a quantized field whose codes cover [MinValue, MaxValue] evenly.
+     * The worst case error is half a step, (MaxValue - MinValue) / 255 / 2 for QInt8.
+     *
+     * @param DType QInt8 or QUInt16, other dtypes are returned unquantized.
+     */
+    UFUNCTION(BlueprintCallable, Category = "PackingHelpers")
+    static FObservationField MakeQuantizedField(const FString& Name, EObservationDType DType, const TArray<int32>& Shape, float MinValue, float MaxValue);
+
+    /**
+     * Appends the packed observation to OutBytes without reallocating when capacity allows (C++ only).
+     */
+    static void PackObservationAppend(const FObservationSchema& Schema, TConstArrayView<float> Observation, TArray<uint8>& OutBytes);
+
+    /**
+     * Packs Values field after field into OutBytes, which must hold the packed size of Fields (C++ only).
+     * Lets callers pack a slice of a schema, e.g. the state fields ahead of sensors that pack themselves.
+     */
+    static void PackFieldsInto(TConstArrayView<FObservationField> Fields, TConstArrayView<float> Values, TArrayView<uint8> OutBytes);
+
+    /**
+     * Reverses PackObservationAppend, mostly for debugging and round trip checks (C++ only).
+     *
+     * @return Number of bytes consumed.
+     */
+    static int32 UnpackObservation(const FObservationSchema& Schema, TConstArrayView<uint8> Bytes, TArrayView<float> OutObservation);
+};
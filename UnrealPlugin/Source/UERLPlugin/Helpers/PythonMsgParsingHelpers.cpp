@@ -18,6 +18,22 @@ int32 UPythonMsgParsingHelpers::ParseEnvId(const FString& Message)
     return -1;
 }
 
+int32 UPythonMsgParsingHelpers::ParseAgentId(const FString& Message)
+{
+    TArray<FString> Parts;
+    Message.ParseIntoArray(Parts, TEXT(";"), true);
+
+    // Find the token that starts with "AGENT="
+    for (const FString& Part : Parts)
+    {
+        if (Part.TrimStart().StartsWith(TEXT("AGENT="), ESearchCase::IgnoreCase))
+        {
+            return FCString::Atoi(*Part.TrimStart().Mid(6));
+        }
+    }
+    return -1;
+}
+
 
 FString UPythonMsgParsingHelpers::ParseActionString(const FString& Message)
 {
@@ -37,6 +53,44 @@ FString UPythonMsgParsingHelpers::ParseActionString(const FString& Message)
 }
 
 
+bool UPythonMsgParsingHelpers::ParseFloatValue(const FString& Message, const FString& Key, float& OutValue)
+{
+    TArray<FString> Parts;
+    Message.ParseIntoArray(Parts, TEXT(";"), true);
+
+    // Find the token that starts with "<Key>="
+    const FString Prefix = Key + TEXT("=");
+    for (const FString& Part : Parts)
+    {
+        if (Part.TrimStart().StartsWith(Prefix, ESearchCase::IgnoreCase))
+        {
+            OutValue = FCString::Atof(*Part.TrimStart().Mid(Prefix.Len()));
+            return true;
+        }
+    }
+    return false;
+}
+
+
+bool UPythonMsgParsingHelpers::ParseStringValue(const FString& Message, const FString& Key, FString& OutValue)
+{
+    TArray<FString> Parts;
+    Message.ParseIntoArray(Parts, TEXT(";"), true);
+
+    // Find the token that starts with "<Key>=", the value runs to the end of the token
+    const FString Prefix = Key + TEXT("=");
+    for (const FString& Part : Parts)
+    {
+        if (Part.TrimStart().StartsWith(Prefix, ESearchCase::IgnoreCase))
+        {
+            OutValue = Part.TrimStart().Mid(Prefix.Len()).TrimEnd();
+            return true;
+        }
+    }
+    return false;
+}
+
+
 TArray<float> UPythonMsgParsingHelpers::ParseActionFloatArray(const FString& ActionString)
 {
     TArray<float> OutValues;
@@ -25,6 +25,16 @@ public:
     UFUNCTION(BlueprintCallable, Category = "PythonMsgParsingHelpers")
     static int32 ParseEnvId(const FString& Message);
 
+    /**
+     * Parses the agent ID from a multi-agent message string.
+     * Expected format: "AGENT=1;ACT=0.10,-0.20"
+     *
+     * @param Message The message string of one agent.
+     * @return The extracted agent ID, -1 if missing.
+     */
+    UFUNCTION(BlueprintCallable, Category = "PythonMsgParsingHelpers")
+    static int32 ParseAgentId(const FString& Message);
+
     /**
      * Parses the action substring from a message string.
      * Expected format: "ENV=x;ACT=0.10,-0.20"
@@ -35,6 +45,30 @@ public:
     UFUNCTION(BlueprintCallable, Category = "PythonMsgParsingHelpers")
     static FString ParseActionString(const FString& Message);
 
+    /**
+     * Parses a float stored under Key from a message string.
+     * Expected format: "ACT=0.10,-0.20;VAL=0.53;LOGP=-1.2"
+     *
+     * @param Message The complete message string to parse.
+     * @param Key The key without "=", e.g. "VAL".
+     * @param OutValue Receives the value, unchanged if Key is missing.
+     * @return True if Key was found.
+     */
+    UFUNCTION(BlueprintCallable, Category = "PythonMsgParsingHelpers")
+    static bool ParseFloatValue(const FString& Message, const FString& Key, float& OutValue);
+
+    /**
+     * Parses the string stored under Key from a message string, up to the next ";" (spaces included).
+     * Expected format: "PATH=C:/My Policies/policy.onnx;VERSION=3"
+     *
+     * @param Message The complete message string to parse.
+     * @param Key The key without "=", e.g. "PATH".
+     * @param OutValue Receives the value, unchanged if Key is missing.
+     * @return True if Key was found.
+     */
+    UFUNCTION(BlueprintCallable, Category = "PythonMsgParsingHelpers")
+    static bool ParseStringValue(const FString& Message, const FString& Key, FString& OutValue);
+
     /**
      * Converts a comma-separated action string into an array of float values.
      *
@@ -0,0 +1,203 @@
+#include "Inference/ActionSampling/PolicyActionSampler.h"
+
+namespace
+{
+	// 0.5 * log(2 * pi)
+	constexpr float HalfLog2Pi = 0.91893853f;
+}
+
+int32 FPolicyHead::GetNumInputs() const
+{
+	const bool bGaussian = Type == EPolicyHeadType::Gaussian || Type == EPolicyHeadType::SquashedGaussian;
+	return bGaussian && LogStd.Num() == 0 ? 2 * Size : Size;
+}
+
+bool FPolicyActionSampler::Configure(const TArray<FPolicyHead>& InHeads, int32 InSeed)
+{
+	Heads = InHeads;
+	Seed = InSeed;
+	NumInputs = 0;
+	NumActions = 0;
+	Streams.Reset();
+	for (FPolicyHead& Head : Heads)
+	{
+		Head.Size = FMath::Max(Head.Size, 1);
+
+		// Sample() reads one log std per value, or the same one for all
+		const bool bGaussian = Head.Type == EPolicyHeadType::Gaussian || Head.Type == EPolicyHeadType::SquashedGaussian;
+		if (bGaussian && Head.LogStd.Num() > 1 && Head.LogStd.Num() != Head.Size)
+		{
+			UE_LOG(LogTemp, Error, TEXT("FPolicyActionSampler: Head '%s' has %d log stds, expected 0, 1 or %d. Policy heads rejected."),
+				*Head.Name, Head.LogStd.Num(), Head.Size);
+			Heads.Reset();
+			NumInputs = 0;
+			NumActions = 0;
+			return false;
+		}
+
+		NumInputs += Head.GetNumInputs();
+		NumActions += Head.GetNumActions();
+	}
+	return true;
+}
+
+void FPolicyActionSampler::ResetStreams(int32 AgentId)
+{
+	for (int32 i = 0; i < Streams.Num(); i++)
+	{
+		if (AgentId < 0 || AgentId == i)
+		{
+			Streams[i].Initialize(static_cast<int32>(HashCombine(GetTypeHash(Seed), GetTypeHash(i))));
+		}
+	}
+}
+
+FRandomStream& FPolicyActionSampler::GetStream(int32 AgentId)
+{
+	while (Streams.Num() <= AgentId)
+	{
+		const int32 NewAgentId = Streams.Num();
+		Streams.Emplace(static_cast<int32>(HashCombine(GetTypeHash(Seed), GetTypeHash(NewAgentId))));
+	}
+	return Streams[AgentId];
+}
+
+float FPolicyActionSampler::SampleNormal(FRandomStream& Stream)
+{
+	// 1 - u keeps the log argument in (0, 1]
+	const float U1 = 1.f - Stream.GetFraction();
+	const float U2 = Stream.GetFraction();
+	return FMath::Sqrt(-2.f * FMath::Loge(U1)) * FMath::Cos(2.f * PI * U2);
+}
+
+bool FPolicyActionSampler::Sample(TConstArrayView<int32> AgentIds, TConstArrayView<float> ModelOutputs, bool bDeterministic,
+	TArray<float>& OutActions, TArray<float>* OutLogProbs)
+{
+	OutActions.Reset();
+	if (OutLogProbs)
+	{
+		OutLogProbs->Reset();
+	}
+
+	const int32 BatchSize = AgentIds.Num();
+	if (BatchSize == 0 || ModelOutputs.Num() != BatchSize * NumInputs)
+	{
+		UE_LOG(LogTemp, Error, TEXT("FPolicyActionSampler: Model output has %d values, policy heads expect %d x %d."),
+			ModelOutputs.Num(), BatchSize, NumInputs);
+		return false;
+	}
+
+	OutActions.SetNumUninitialized(BatchSize * NumActions);
+	if (OutLogProbs)
+	{
+		OutLogProbs->SetNumUninitialized(BatchSize);
+	}
+
+	for (int32 Agent = 0; Agent < BatchSize; Agent++)
+	{
+		const float* Inputs = ModelOutputs.GetData() + Agent * NumInputs;
+		float* Actions = OutActions.GetData() + Agent * NumActions;
+		FRandomStream* Stream = bDeterministic ? nullptr : &GetStream(FMath::Max(AgentIds[Agent], 0));
+		float LogProb = 0.f;
+
+		for (const FPolicyHead& Head : Heads)
+		{
+			switch (Head.Type)
+			{
+			case EPolicyHeadType::Categorical:
+			{
+				// log softmax with the max subtracted, the choice is the argmax or drawn from the CDF
+				float MaxLogit = Inputs[0];
+				int32 Choice = 0;
+				for (int32 i = 1; i < Head.Size; i++)
+				{
+					if (Inputs[i] > MaxLogit)
+					{
+						MaxLogit = Inputs[i];
+						Choice = i;
+					}
+				}
+				ProbabilityScratch.SetNumUninitialized(Head.Size);
+				float SumExp = 0.f;
+				for (int32 i = 0; i < Head.Size; i++)
+				{
+					ProbabilityScratch[i] = FMath::Exp(Inputs[i] - MaxLogit);
+					SumExp += ProbabilityScratch[i];
+				}
+				if (Stream)
+				{
+					float Remaining = Stream->GetFraction() * SumExp;
+					Choice = Head.Size - 1;
+					for (int32 i = 0; i < Head.Size; i++)
+					{
+						Remaining -= ProbabilityScratch[i];
+						if (Remaining < 0.f)
+						{
+							Choice = i;
+							break;
+						}
+					}
+				}
+				*Actions++ = static_cast<float>(Choice);
+				LogProb += Inputs[Choice] - MaxLogit - FMath::Loge(SumExp);
+				break;
+			}
+			case EPolicyHeadType::Gaussian:
+			case EPolicyHeadType::SquashedGaussian:
+			{
+				const bool bSquashed = Head.Type == EPolicyHeadType::SquashedGaussian;
+				const float* LogStds = Head.LogStd.Num() > 0 ? Head.LogStd.GetData() : Inputs + Head.Size;
+				const int32 LogStdStride = Head.LogStd.Num() == 1 ? 0 : 1;
+				for (int32 i = 0; i < Head.Size; i++)
+				{
+					const float LogStd = FMath::Clamp(LogStds[i * LogStdStride], Head.LogStdMin, Head.LogStdMax);
+					const float Noise = Stream ? SampleNormal(*Stream) : 0.f;
+					float Value = Inputs[i] + FMath::Exp(LogStd) * Noise;
+					LogProb += -0.5f * Noise * Noise - LogStd - HalfLog2Pi;
+
+					if (bSquashed)
+					{
+						// change of variables for tanh, same epsilon as stable-baselines3
+						Value = FMath::Tanh(Value);
+						LogProb -= FMath::Loge(1.f - Value * Value + 1e-6f);
+						Value = Head.ActionLow + 0.5f * (Value + 1.f) * (Head.ActionHigh - Head.ActionLow);
+					}
+					*Actions++ = Value;
+				}
+				break;
+			}
+			default:
+				FMemory::Memcpy(Actions, Inputs, Head.Size * sizeof(float));
+				Actions += Head.Size;
+				break;
+			}
+			Inputs += Head.GetNumInputs();
+		}
+
+		if (OutLogProbs)
+		{
+			(*OutLogProbs)[Agent] = LogProb;
+		}
+	}
+	return true;
+}
+
+FString FPolicyActionSampler::ToActionString(TConstArrayView<float> Actions) const
+{
+	FString Result;
+	int32 Index = 0;
+	for (const FPolicyHead& Head : Heads)
+	{
+		for (int32 i = 0; i < Head.GetNumActions() && Index < Actions.Num(); i++, Index++)
+		{
+			if (!Result.IsEmpty())
+			{
+				Result += TEXT(",");
+			}
+			Result += Head.Type == EPolicyHeadType::Categorical
+				? FString::FromInt(FMath::RoundToInt(Actions[Index]))
+				: FString::Printf(TEXT("%.2f"), Actions[Index]);
+		}
+	}
+	return Result;
+}
@@ -17,7 +17,20 @@ void UInferenceModelActorComponents::BeginPlay()
 FString UInferenceModelActorComponents::RunLocalModelInference(const FString& Observation)
 {
     if (InferenceInterface) {
-        return InferenceInterface->RunInference(UBPFL_DataHelpers::ParseStateString(Observation));
+        const TArray<float> Parsed = UBPFL_DataHelpers::ParseStateString(Observation);
+        if (FrameStackDepth <= 1) {
+            return InferenceInterface->RunInference(Parsed);
+        }
+
+        // same stacked layout the bridge sent during training
+        if (FrameStack.GetFrameSize() != Parsed.Num() || FrameStack.GetDepth() != FrameStackDepth) {
+            FrameStack.Initialize(1, Parsed.Num(), FrameStackDepth);
+        }
+        const int32 AgentIds[] = { 0 };
+        if (!InferenceInterface->RunInferenceBatch(AgentIds, FrameStack.Push(0, Parsed), ActionScratch)) {
+            return "";
+        }
+        return UBPFL_DataHelpers::ArrayToStateString(ActionScratch, 2);
     }
     else {
         UE_LOG(LogTemp, Warning, TEXT("InferenceModelActorComponents: Empty InferenceInterface ptr."));
@@ -51,9 +64,19 @@ void UInferenceModelActorComponents::TickComponent(float DeltaTime, ELevelTick T
 
 void UInferenceModelActorComponents::StartInference()
 {
+    // every inference run starts from a fresh history
+    ResetObservationHistory();
     SetComponentTickEnabled(true);
 }
 
+void UInferenceModelActorComponents::ResetObservationHistory()
+{
+    FrameStack.ResetAll();
+    if (InferenceInterface) {
+        InferenceInterface->ResetState();
+    }
+}
+
 void UInferenceModelActorComponents::StopInference()
 {
     SetComponentTickEnabled(false);
@@ -1,5 +1,6 @@
 
 #include "Inference/InferenceInterfaces/InferenceInterface.h"
+#include "UERLPlugin/Helpers/BPFL_DataHelpers.h"
 
 bool UInferenceInterface::LoadModel(const FString& ModelPath)
 {
@@ -7,8 +8,113 @@ bool UInferenceInterface::LoadModel(const FString& ModelPath)
 	return false;
 }
 
+bool UInferenceInterface::LoadModelFromMemory(TConstArrayView<uint8> ModelBytes)
+{
+	UE_LOG(LogTemp, Warning, TEXT("UInferenceInterface: This model type can not be loaded from memory."));
+	return false;
+}
+
+bool UInferenceInterface::LoadModelFromMemoryAsync(TArray<uint8>&& ModelBytes, int32 Version)
+{
+	// Without a background path the model is active right away, ApplyPendingModel() still reports it once
+	LoadedModelResult = LoadModelFromMemory(ModelBytes) ? EPendingModelResult::Loaded : EPendingModelResult::Failed;
+	LoadedModelVersion = Version;
+	return true;
+}
+
+EPendingModelResult UInferenceInterface::ApplyPendingModel(int32& OutVersion)
+{
+	const EPendingModelResult Result = LoadedModelResult;
+	OutVersion = LoadedModelVersion;
+	LoadedModelResult = EPendingModelResult::None;
+	return Result;
+}
+
 FString UInferenceInterface::RunInference(const TArray<float>& Observation)
 {
 	// Base implementation for blueprint requirements
 	return FString();
 }
+
+FString UInferenceInterface::RunInferenceForAgent(int32 AgentId, const TArray<float>& Observation)
+{
+	// Stateless models have nothing per agent
+	return RunInference(Observation);
+}
+
+bool UInferenceInterface::RunInferenceBatch(TConstArrayView<int32> AgentIds, TConstArrayView<float> Observations, TArray<float>& OutActions)
+{
+	OutActions.Reset();
+	if (AgentIds.Num() == 0 || Observations.Num() % AgentIds.Num() != 0)
+	{
+		UE_LOG(LogTemp, Error, TEXT("UInferenceInterface: %d observation values do not split into %d agents."), Observations.Num(), AgentIds.Num());
+		return false;
+	}
+
+	const int32 ObsSize = Observations.Num() / AgentIds.Num();
+	TArray<float> Observation;
+	for (int32 i = 0; i < AgentIds.Num(); i++)
+	{
+		Observation.Reset();
+		Observation.Append(Observations.Slice(i * ObsSize, ObsSize));
+		const FString Actions = RunInferenceForAgent(AgentIds[i], Observation);
+		if (Actions.IsEmpty())
+		{
+			return false;
+		}
+		OutActions.Append(UBPFL_DataHelpers::ParseStateString(Actions));
+	}
+	return true;
+}
+
+void UInferenceInterface::ResetState(int32 AgentId)
+{
+	// Base implementation is stateless
+}
+
+bool UInferenceInterface::IsRecurrent() const
+{
+	return false;
+}
+
+void UInferenceInterface::SetPolicyHeads(const TArray<FPolicyHead>& Heads, int32 Seed)
+{
+	PolicyHeads = Heads;
+	SamplingSeed = Seed;
+	ConfigurePolicyHeads();
+}
+
+void UInferenceInterface::ResetSampling(int32 AgentId)
+{
+	ActionSampler.ResetStreams(AgentId);
+}
+
+void UInferenceInterface::ConfigurePolicyHeads()
+{
+	ActionSampler.Configure(PolicyHeads, SamplingSeed);
+	LastLogProbs.Reset();
+}
+
+bool UInferenceInterface::ApplyPolicyHeads(TConstArrayView<int32> AgentIds, TConstArrayView<float> ModelOutputs, TArray<float>& OutActions)
+{
+	if (!ActionSampler.IsConfigured())
+	{
+		// rejected heads must not turn distribution parameters into actions, Configure() logged why
+		if (PolicyHeads.Num() > 0)
+		{
+			LastLogProbs.Reset();
+			OutActions.Reset();
+			return false;
+		}
+		LastLogProbs.Reset();
+		OutActions.Reset();
+		OutActions.Append(ModelOutputs.GetData(), ModelOutputs.Num());
+		return true;
+	}
+	return ActionSampler.Sample(AgentIds, ModelOutputs, bDeterministicActions, OutActions, &LastLogProbs);
+}
+
+FString UInferenceInterface::FormatActions(TConstArrayView<float> Actions) const
+{
+	return ActionSampler.IsConfigured() ? ActionSampler.ToActionString(Actions) : UBPFL_DataHelpers::ArrayViewToStateString(Actions, 2);
+}
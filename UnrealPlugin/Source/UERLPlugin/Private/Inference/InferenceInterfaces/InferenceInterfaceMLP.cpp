@@ -0,0 +1,277 @@
+#include "Inference/InferenceInterfaces/InferenceInterfaceMLP.h"
+#include "Misc/FileHelper.h"
+
+namespace
+{
+	const uint8 MLPFileMagic[8] = { 'U', 'E', 'M', 'L', 'P', '1', 0, 0 };
+	const uint8 MLPFileMagicTyped[8] = { 'U', 'E', 'M', 'L', 'P', '2', 0, 0 };
+
+	/** Reads little endian values from a byte view, fails once the view is exhausted. */
+	struct FWeightReader
+	{
+		TConstArrayView<uint8> Data;
+		int64 Offset = 0;
+
+		bool Read(void* Out, int64 NumBytes)
+		{
+			if (Offset + NumBytes > Data.Num())
+			{
+				return false;
+			}
+			FMemory::Memcpy(Out, Data.GetData() + Offset, NumBytes);
+			Offset += NumBytes;
+			return true;
+		}
+	};
+}
+
+bool UInferenceInterfaceMLP::LoadModel(const FString& ModelPath)
+{
+	TArray<uint8> Data;
+	if (!FFileHelper::LoadFileToArray(Data, *ModelPath))
+	{
+		UE_LOG(LogTemp, Error, TEXT("UInferenceInterfaceMLP: Failed to read %s"), *ModelPath);
+		return false;
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("UInferenceInterfaceMLP: Loading MLP weights from %s"), *ModelPath);
+	return LoadFromMemory(Data);
+}
+
+bool UInferenceInterfaceMLP::LoadFromMemory(TConstArrayView<uint8> Data)
+{
+	Layers.Reset();
+	MaxStride = 0;
+
+	FWeightReader Reader{ Data };
+	uint8 Magic[8];
+	uint32 NumLayers = 0;
+	const bool bReadMagic = Reader.Read(Magic, sizeof(Magic));
+	const bool bTyped = bReadMagic && FMemory::Memcmp(Magic, MLPFileMagicTyped, sizeof(Magic)) == 0;
+	if (!bReadMagic || (!bTyped && FMemory::Memcmp(Magic, MLPFileMagic, sizeof(Magic)) != 0) || !Reader.Read(&NumLayers, sizeof(NumLayers)) || NumLayers == 0)
+	{
+		UE_LOG(LogTemp, Error, TEXT("UInferenceInterfaceMLP: Not an MLP weight file."));
+		return false;
+	}
+
+	TArray<FDenseLayer> NewLayers;
+	NewLayers.SetNum(NumLayers);
+	for (uint32 LayerIndex = 0; LayerIndex < NumLayers; LayerIndex++)
+	{
+		FDenseLayer& Layer = NewLayers[LayerIndex];
+		uint32 Header[4] = { 0, 0, 0, 0 };
+		if (!Reader.Read(Header, (bTyped ? 4 : 3) * sizeof(uint32)) || Header[0] == 0 || Header[1] == 0
+			|| Header[2] > static_cast<uint32>(EMLPActivation::Sigmoid) || Header[3] > static_cast<uint32>(EMLPWeightType::Int8))
+		{
+			UE_LOG(LogTemp, Error, TEXT("UInferenceInterfaceMLP: Invalid header of layer %u."), LayerIndex);
+			return false;
+		}
+		Layer.InSize = static_cast<int32>(Header[0]);
+		Layer.OutSize = static_cast<int32>(Header[1]);
+		Layer.Activation = static_cast<EMLPActivation>(Header[2]);
+		Layer.WeightType = static_cast<EMLPWeightType>(Header[3]);
+		Layer.InStride = Align(Layer.InSize, 4);
+		if (LayerIndex > 0 && Layer.InSize != NewLayers[LayerIndex - 1].OutSize)
+		{
+			UE_LOG(LogTemp, Error, TEXT("UInferenceInterfaceMLP: Layer %u takes %d inputs, previous layer has %d outputs."),
+				LayerIndex, Layer.InSize, NewLayers[LayerIndex - 1].OutSize);
+			return false;
+		}
+
+		// rows are read one by one into their padded slot
+		const int32 PaddedOut = Align(Layer.OutSize, 4);
+		Layer.Bias.SetNumZeroed(PaddedOut);
+		bool bComplete = true;
+		uint8* WeightData = nullptr;
+		int32 ElementSize = sizeof(float);
+		switch (Layer.WeightType)
+		{
+		case EMLPWeightType::Float16:
+			Layer.HalfWeights.SetNumZeroed(PaddedOut * Layer.InStride);
+			WeightData = reinterpret_cast<uint8*>(Layer.HalfWeights.GetData());
+			ElementSize = sizeof(FFloat16);
+			break;
+		case EMLPWeightType::Int8:
+			Layer.Int8Weights.SetNumZeroed(PaddedOut * Layer.InStride);
+			Layer.RowScales.SetNumZeroed(PaddedOut);
+			bComplete = Reader.Read(Layer.RowScales.GetData(), Layer.OutSize * sizeof(float));
+			WeightData = reinterpret_cast<uint8*>(Layer.Int8Weights.GetData());
+			ElementSize = sizeof(int8);
+			break;
+		default:
+			Layer.Weights.SetNumZeroed(PaddedOut * Layer.InStride);
+			WeightData = reinterpret_cast<uint8*>(Layer.Weights.GetData());
+			break;
+		}
+		for (int32 Row = 0; Row < Layer.OutSize && bComplete; Row++)
+		{
+			bComplete = Reader.Read(WeightData + Row * Layer.InStride * ElementSize, Layer.InSize * ElementSize);
+		}
+		if (!bComplete || !Reader.Read(Layer.Bias.GetData(), Layer.OutSize * sizeof(float)))
+		{
+			UE_LOG(LogTemp, Error, TEXT("UInferenceInterfaceMLP: Weight file ends inside layer %u."), LayerIndex);
+			return false;
+		}
+		MaxStride = FMath::Max3(MaxStride, Layer.InStride, PaddedOut);
+	}
+
+	Layers = MoveTemp(NewLayers);
+	ConfigurePolicyHeads();
+
+	UE_LOG(LogTemp, Log, TEXT("UInferenceInterfaceMLP: Loaded %d layers, %d inputs, %d outputs."), Layers.Num(), GetInputSize(), GetOutputSize());
+	return true;
+}
+
+int32 UInferenceInterfaceMLP::GetInputSize() const
+{
+	return Layers.Num() > 0 ? Layers[0].InSize : 0;
+}
+
+int32 UInferenceInterfaceMLP::GetOutputSize() const
+{
+	return Layers.Num() > 0 ? Layers.Last().OutSize : 0;
+}
+
+FString UInferenceInterfaceMLP::RunInference(const TArray<float>& Observation)
+{
+	const int32 AgentIds[] = { 0 };
+	if (!RunInferenceBatch(AgentIds, Observation, ActionScratch))
+	{
+		return FString();
+	}
+	return FormatActions(ActionScratch);
+}
+
+bool UInferenceInterfaceMLP::RunInferenceBatch(TConstArrayView<int32> AgentIds, TConstArrayView<float> Observations, TArray<float>& OutActions)
+{
+	OutActions.Reset();
+	if (!IsModelLoaded())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("UInferenceInterfaceMLP: Model not loaded."));
+		return false;
+	}
+
+	const int32 BatchSize = AgentIds.Num();
+	const int32 InSize = GetInputSize();
+	if (BatchSize == 0 || Observations.Num() != BatchSize * InSize)
+	{
+		UE_LOG(LogTemp, Error, TEXT("UInferenceInterfaceMLP: Got %d observation values, expected %d agents x %d."), Observations.Num(), BatchSize, InSize);
+		return false;
+	}
+
+	ActivationsA.SetNumUninitialized(BatchSize * MaxStride);
+	ActivationsB.SetNumUninitialized(BatchSize * MaxStride);
+	TileScratch.SetNumUninitialized(4 * MaxStride);
+
+	// observations into padded rows, the padding must be zero because it is part of every dot product
+	const int32 InStride = Layers[0].InStride;
+	for (int32 Row = 0; Row < BatchSize; Row++)
+	{
+		float* Dest = ActivationsA.GetData() + Row * InStride;
+		FMemory::Memcpy(Dest, Observations.GetData() + Row * InSize, InSize * sizeof(float));
+		FMemory::Memzero(Dest + InSize, (InStride - InSize) * sizeof(float));
+	}
+
+	float* Input = ActivationsA.GetData();
+	float* Output = ActivationsB.GetData();
+	for (const FDenseLayer& Layer : Layers)
+	{
+		EvaluateLayer(Layer, Input, BatchSize, Output, Align(Layer.OutSize, 4), TileScratch.GetData());
+		Swap(Input, Output);
+	}
+
+	// drop the row padding of the last layer
+	const FDenseLayer& Last = Layers.Last();
+	const int32 OutStride = Align(Last.OutSize, 4);
+	OutputScratch.SetNumUninitialized(BatchSize * Last.OutSize);
+	for (int32 Row = 0; Row < BatchSize; Row++)
+	{
+		FMemory::Memcpy(OutputScratch.GetData() + Row * Last.OutSize, Input + Row * OutStride, Last.OutSize * sizeof(float));
+	}
+	return ApplyPolicyHeads(AgentIds, OutputScratch, OutActions);
+}
+
+void UInferenceInterfaceMLP::EvaluateLayer(const FDenseLayer& Layer, const float* Input, int32 BatchSize, float* Output, int32 OutStride, float* TileScratch)
+{
+	const int32 InStride = Layer.InStride;
+	const int32 PaddedOut = Align(Layer.OutSize, 4);
+	const VectorRegister4Float Zero = VectorZeroFloat();
+
+	// tile of four weight rows, reused for every row of the batch while it is hot in cache
+	for (int32 Out = 0; Out < PaddedOut; Out += 4)
+	{
+		const float* W0 = TileScratch;
+		if (Layer.WeightType == EMLPWeightType::Float16)
+		{
+			const FFloat16* Half = Layer.HalfWeights.GetData() + Out * InStride;
+			for (int32 i = 0; i < 4 * InStride; i++)
+			{
+				TileScratch[i] = Half[i].GetFloat();
+			}
+		}
+		else if (Layer.WeightType == EMLPWeightType::Int8)
+		{
+			const int8* Quantized = Layer.Int8Weights.GetData() + Out * InStride;
+			for (int32 Row = 0; Row < 4; Row++)
+			{
+				const float Scale = Layer.RowScales[Out + Row];
+				for (int32 i = 0; i < InStride; i++)
+				{
+					TileScratch[Row * InStride + i] = Quantized[Row * InStride + i] * Scale;
+				}
+			}
+		}
+		else
+		{
+			W0 = Layer.Weights.GetData() + Out * InStride;
+		}
+		const float* W1 = W0 + InStride;
+		const float* W2 = W1 + InStride;
+		const float* W3 = W2 + InStride;
+		const VectorRegister4Float Bias = VectorLoadAligned(Layer.Bias.GetData() + Out);
+
+		for (int32 Row = 0; Row < BatchSize; Row++)
+		{
+			const float* X = Input + Row * InStride;
+			VectorRegister4Float Acc0 = Zero;
+			VectorRegister4Float Acc1 = Zero;
+			VectorRegister4Float Acc2 = Zero;
+			VectorRegister4Float Acc3 = Zero;
+			for (int32 i = 0; i < InStride; i += 4)
+			{
+				const VectorRegister4Float XVec = VectorLoadAligned(X + i);
+				Acc0 = VectorMultiplyAdd(VectorLoadAligned(W0 + i), XVec, Acc0);
+				Acc1 = VectorMultiplyAdd(VectorLoadAligned(W1 + i), XVec, Acc1);
+				Acc2 = VectorMultiplyAdd(VectorLoadAligned(W2 + i), XVec, Acc2);
+				Acc3 = VectorMultiplyAdd(VectorLoadAligned(W3 + i), XVec, Acc3);
+			}
+
+			// reduce the four accumulators into one vector of four dot products
+			const VectorRegister4Float Sum01 = VectorAdd(VectorShuffle(Acc0, Acc1, 0, 1, 0, 1), VectorShuffle(Acc0, Acc1, 2, 3, 2, 3));
+			const VectorRegister4Float Sum23 = VectorAdd(VectorShuffle(Acc2, Acc3, 0, 1, 0, 1), VectorShuffle(Acc2, Acc3, 2, 3, 2, 3));
+			VectorRegister4Float Result = VectorAdd(VectorShuffle(Sum01, Sum23, 0, 2, 0, 2), VectorShuffle(Sum01, Sum23, 1, 3, 1, 3));
+			Result = VectorAdd(Result, Bias);
+
+			float* Y = Output + Row * OutStride + Out;
+			if (Layer.Activation == EMLPActivation::ReLU)
+			{
+				Result = VectorMax(Result, Zero);
+			}
+			VectorStoreAligned(Result, Y);
+			if (Layer.Activation == EMLPActivation::Tanh)
+			{
+				for (int32 i = 0; i < 4; i++)
+				{
+					Y[i] = FMath::Tanh(Y[i]);
+				}
+			}
+			else if (Layer.Activation == EMLPActivation::Sigmoid)
+			{
+				for (int32 i = 0; i < 4; i++)
+				{
+					Y[i] = 1.f / (1.f + FMath::Exp(-Y[i]));
+				}
+			}
+		}
+	}
+}
@@ -3,6 +3,7 @@
 #include "UERLPlugin/Helpers/BPFL_DataHelpers.h" 
 #include "Misc/Paths.h"
 #include "HAL/PlatformFilemanager.h"
+#include "Async/Async.h"
 
 #include <onnxruntime_cxx_api.h>
 #include <string>
@@ -18,10 +19,14 @@ UInferenceInterfaceOnnx::UInferenceInterfaceOnnx()
 UInferenceInterfaceOnnx::~UInferenceInterfaceOnnx()
 {
 	// SessionPtr will automatically be cleaned up since is unique ptr
-	// add any logic for cleaning up Onnx logic here
+	// A background build writes into this object, let it finish first
+	if (PendingBuild.IsValid())
+	{
+		PendingBuild.Wait();
+	}
 }
 
-bool UInferenceInterfaceOnnx::LoadModel(const FString& ModelPath)
+void UInferenceInterfaceOnnx::EnsureEnvironment()
 {
 	if (!GEnv)
 	{
@@ -32,6 +37,11 @@ bool UInferenceInterfaceOnnx::LoadModel(const FString& ModelPath)
 		GSessionOptions = std::make_unique<Ort::SessionOptions>();
 		GSessionOptions->SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_EXTENDED);
 	}
+}
+
+bool UInferenceInterfaceOnnx::LoadModel(const FString& ModelPath)
+{
+	EnsureEnvironment();
 
 #if PLATFORM_WINDOWS
 	const std::wstring WideModelPath = *ModelPath;
@@ -54,71 +64,498 @@ bool UInferenceInterfaceOnnx::LoadModel(const FString& ModelPath)
 		return false;
 	}
 
+	if (!BindModelIO())
+	{
+		SessionPtr.reset();
+		return false;
+	}
+
+	ConfigurePolicyHeads();
+	return true;
+}
+
+bool UInferenceInterfaceOnnx::LoadModelFromMemory(TConstArrayView<uint8> ModelBytes)
+{
+	EnsureEnvironment();
+	UE_LOG(LogTemp, Log, TEXT("UInferenceInterfaceOnnx: Loading ONNX model from memory (%d bytes)"), ModelBytes.Num());
+
+	std::unique_ptr<Ort::Session> NewSession;
+	try
+	{
+		NewSession = std::make_unique<Ort::Session>(*GEnv, ModelBytes.GetData(), ModelBytes.Num(), *GSessionOptions);
+	}
+	catch (const Ort::Exception& e)
+	{
+		UE_LOG(LogTemp, Error, TEXT("UInferenceInterfaceOnnx: Failed to load ONNX model: %s"), *FString(e.what()));
+		return false;
+	}
+	return InstallSession(std::move(NewSession));
+}
+
+bool UInferenceInterfaceOnnx::LoadModelFromMemoryAsync(TArray<uint8>&& ModelBytes, int32 Version)
+{
+	if (ModelBytes.Num() == 0)
+	{
+		return false;
+	}
+
+	// Environment and options are created here, workers only read them
+	EnsureEnvironment();
+	if (PendingBuild.IsValid())
+	{
+		if (bHasQueuedModel)
+		{
+			UE_LOG(LogTemp, Log, TEXT("UInferenceInterfaceOnnx: Queued model version %d replaced by version %d before its build"), QueuedModelVersion, Version);
+		}
+		QueuedModelBytes = MoveTemp(ModelBytes);
+		QueuedModelVersion = Version;
+		bHasQueuedModel = true;
+		return true;
+	}
+	StartPendingBuild(MoveTemp(ModelBytes), Version);
+	return true;
+}
+
+void UInferenceInterfaceOnnx::StartPendingBuild(TArray<uint8>&& ModelBytes, int32 Version)
+{
+	UE_LOG(LogTemp, Log, TEXT("UInferenceInterfaceOnnx: Building ONNX model version %d from memory (%d bytes) in the background"), Version, ModelBytes.Num());
+
+	PendingBuildVersion = Version;
+	PendingBuild = Async(EAsyncExecution::ThreadPool, [this, Bytes = MoveTemp(ModelBytes)]()
+	{
+		// Graph optimization is the slow part, it runs here while the active session keeps serving
+		std::unique_ptr<Ort::Session> NewSession;
+		try
+		{
+			NewSession = std::make_unique<Ort::Session>(*GEnv, Bytes.GetData(), Bytes.Num(), *GSessionOptions);
+		}
+		catch (const Ort::Exception& e)
+		{
+			UE_LOG(LogTemp, Error, TEXT("UInferenceInterfaceOnnx: Failed to build ONNX model: %s"), *FString(e.what()));
+		}
+
+		FScopeLock Lock(&PendingSessionLock);
+		PendingSession = std::move(NewSession);
+	});
+}
+
+EPendingModelResult UInferenceInterfaceOnnx::ApplyPendingModel(int32& OutVersion)
+{
+	if (!PendingBuild.IsValid() || !PendingBuild.IsReady())
+	{
+		return EPendingModelResult::None;
+	}
+	PendingBuild.Reset();
+	OutVersion = PendingBuildVersion;
+
+	std::unique_ptr<Ort::Session> NewSession;
+	{
+		FScopeLock Lock(&PendingSessionLock);
+		NewSession = std::move(PendingSession);
+	}
+
+	// The finished model serves while a newer one that arrived during its build is built next
+	const bool bInstalled = NewSession && InstallSession(std::move(NewSession));
+	if (bHasQueuedModel)
+	{
+		bHasQueuedModel = false;
+		StartPendingBuild(MoveTemp(QueuedModelBytes), QueuedModelVersion);
+	}
+	return bInstalled ? EPendingModelResult::Loaded : EPendingModelResult::Failed;
+}
+
+bool UInferenceInterfaceOnnx::InstallSession(std::unique_ptr<Ort::Session> NewSession)
+{
+	std::unique_ptr<Ort::Session> PreviousSession = std::move(SessionPtr);
+	SessionPtr = std::move(NewSession);
+	if (!BindModelIO())
+	{
+		SessionPtr = std::move(PreviousSession);
+		if (SessionPtr)
+		{
+			BindModelIO();
+		}
+		return false;
+	}
+
+	// Keep the agents' random streams across weight updates, only configure heads on the first model
+	if (!ActionSampler.IsConfigured())
+	{
+		ConfigurePolicyHeads();
+	}
 	return true;
 }
 
 
 FString UInferenceInterfaceOnnx::RunInference(const TArray<float>& Observation)
 {
+	return RunInferenceForAgent(0, Observation);
+}
+
+FString UInferenceInterfaceOnnx::RunInferenceForAgent(int32 AgentId, const TArray<float>& Observation)
+{
+	const int32 AgentIds[] = { AgentId };
+	if (!RunInferenceBatch(AgentIds, Observation, ActionScratch))
+	{
+		return FString();
+	}
+
+	// Convert the output array to a comma-separated string.
+	return FormatActions(ActionScratch);
+}
+
+bool UInferenceInterfaceOnnx::RunInferenceBatch(TConstArrayView<int32> AgentIds, TConstArrayView<float> Observations, TArray<float>& OutActions)
+{
+	OutActions.Reset();
 	if (!SessionPtr)
 	{
 		UE_LOG(LogTemp, Warning, TEXT("UInferenceInterfaceOnnx: Model not loaded."));
-		return FString();
+		return false;
 	}
 
-	// Convert the TArray<float> to a std::vector<float>.
-	std::vector<float> InputData(Observation.GetData(), Observation.GetData() + Observation.Num());
-	// Assume the model expects an input shape of [1, N].
-	std::vector<int64_t> InputShape = { 1, static_cast<int64_t>(Observation.Num()) };
+	const int32 BatchSize = AgentIds.Num();
+	if (BatchSize == 0 || Observations.Num() % BatchSize != 0)
+	{
+		UE_LOG(LogTemp, Error, TEXT("UInferenceInterfaceOnnx: %d observation values do not split into %d agents."), Observations.Num(), BatchSize);
+		return false;
+	}
 
-	// NOTE: do we need to pass the observation space size here? or is it already baked into the model?
+	int32 MaxAgentId = 0;
+	for (int32 AgentId : AgentIds)
+	{
+		if (AgentId < 0)
+		{
+			UE_LOG(LogTemp, Error, TEXT("UInferenceInterfaceOnnx: Invalid agent id %d."), AgentId);
+			return false;
+		}
+		MaxAgentId = FMath::Max(MaxAgentId, AgentId);
+	}
+	EnsureAgentCapacity(MaxAgentId + 1);
 
-	// Create an input tensor.
+	// The observation batch is [BatchSize, ObsSize].
 	static Ort::MemoryInfo MemoryInfo = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
-	Ort::Value InputTensor = Ort::Value::CreateTensor<float>(
-		MemoryInfo,
-		InputData.data(),
-		InputData.size(),
-		InputShape.data(),
-		InputShape.size()
-	);
+	const std::vector<int64_t> ObservationShape = { BatchSize, static_cast<int64_t>(Observations.Num() / BatchSize) };
+
+	std::vector<Ort::Value> InputValues;
+	std::vector<Ort::Value> OutputValues;
+	InputValues.reserve(InputNames.size());
+	OutputValues.reserve(OutputNames.size());
 
-	const char* InputNames[] = { "obs" };
-	const char* OutputNames[] = { "actions" };
+	if (ObservationElementType == ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16)
+	{
+		ObservationHalfScratch.SetNumUninitialized(Observations.Num());
+		for (int32 i = 0; i < Observations.Num(); i++)
+		{
+			ObservationHalfScratch[i] = Ort::Float16_t(Observations[i]);
+		}
+		InputValues.push_back(Ort::Value::CreateTensor<Ort::Float16_t>(MemoryInfo, ObservationHalfScratch.GetData(),
+			ObservationHalfScratch.Num(), ObservationShape.data(), ObservationShape.size()));
+	}
+	else
+	{
+		InputValues.push_back(Ort::Value::CreateTensor<float>(MemoryInfo, const_cast<float*>(Observations.GetData()),
+			Observations.Num(), ObservationShape.data(), ObservationShape.size()));
+	}
+	// Actions are allocated by ONNX Runtime, their size is only known after the run
+	OutputValues.emplace_back(nullptr);
+
+	std::vector<std::vector<int64_t>> StateShapes;
+	StateShapes.reserve(StateTensors.size());
+	for (FStateTensor& State : StateTensors)
+	{
+		std::vector<int64_t>& Shape = StateShapes.emplace_back(State.Shape);
+		Shape[State.BatchAxis] = BatchSize;
+		const int64 NumValues = BatchSize * State.RowSize();
+
+		InputValues.push_back(Ort::Value::CreateTensor<float>(MemoryInfo, GatherState(State, AgentIds), NumValues, Shape.data(), Shape.size()));
+
+		// Outputs can not alias the inputs, the next state lands in scratch and is scattered afterwards
+		State.OutputScratch.SetNumUninitialized(NumValues);
+		OutputValues.push_back(Ort::Value::CreateTensor<float>(MemoryInfo, State.OutputScratch.GetData(), NumValues, Shape.data(), Shape.size()));
+	}
 
 	Ort::RunOptions RunOptions;
-	std::vector<Ort::Value> OutputTensors;
 	try
 	{
-		OutputTensors = SessionPtr->Run(RunOptions, InputNames, &InputTensor, 1, OutputNames, 1);
+		SessionPtr->Run(RunOptions, InputNames.data(), InputValues.data(), InputValues.size(), OutputNames.data(), OutputValues.data(), OutputValues.size());
 	}
 	catch (const Ort::Exception& e)
 	{
 		UE_LOG(LogTemp, Error, TEXT("UInferenceInterfaceOnnx: RunInference error: %s"), *FString(e.what()));
-		return FString();
+		return false;
 	}
 
-	if (OutputTensors.empty() || !OutputTensors[0].IsTensor())
+	if (!OutputValues[0] || !OutputValues[0].IsTensor())
 	{
 		UE_LOG(LogTemp, Error, TEXT("UInferenceInterfaceOnnx: Invalid tensor output."));
-		return FString();
+		return false;
 	}
 
-	// Extract output data.
-	float* OutPtr = OutputTensors[0].GetTensorMutableData<float>();
-	auto TensorInfo = OutputTensors[0].GetTensorTypeAndShapeInfo();
-	size_t NumElements = TensorInfo.GetElementCount();
+	// Extract output data, distribution parameters are sampled into actions if policy heads are set.
+	const int32 NumElements = static_cast<int32>(OutputValues[0].GetTensorTypeAndShapeInfo().GetElementCount());
+	bool bApplied = false;
+	if (ActionElementType == ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16)
+	{
+		const Ort::Float16_t* HalfPtr = OutputValues[0].GetTensorData<Ort::Float16_t>();
+		ActionFloatScratch.SetNumUninitialized(NumElements);
+		for (int32 i = 0; i < NumElements; i++)
+		{
+			ActionFloatScratch[i] = HalfPtr[i].ToFloat();
+		}
+		bApplied = ApplyPolicyHeads(AgentIds, ActionFloatScratch, OutActions);
+	}
+	else
+	{
+		const float* OutPtr = OutputValues[0].GetTensorData<float>();
+		bApplied = ApplyPolicyHeads(AgentIds, TConstArrayView<float>(OutPtr, NumElements), OutActions);
+	}
 
-	TArray<float> OutputValues;
-	OutputValues.SetNum(NumElements);
-	for (size_t i = 0; i < NumElements; ++i)
+	// A step without actions must not advance the hidden state
+	if (bApplied)
 	{
-		OutputValues[i] = OutPtr[i];
+		for (FStateTensor& State : StateTensors)
+		{
+			ScatterState(State, AgentIds);
+		}
 	}
+	return bApplied;
+}
 
-	// Convert the output array to a comma-separated string.
-	FString ActionString = UBPFL_DataHelpers::ArrayToStateString(OutputValues, 2);
-	return ActionString;
+void UInferenceInterfaceOnnx::ResetState(int32 AgentId)
+{
+	for (FStateTensor& State : StateTensors)
+	{
+		if (AgentId < 0)
+		{
+			FMemory::Memzero(State.Buffer.GetData(), State.Buffer.Num() * sizeof(float));
+		}
+		else if (AgentId < NumAgentRows)
+		{
+			FMemory::Memzero(State.Buffer.GetData() + AgentId * State.RowSize(), State.RowSize() * sizeof(float));
+		}
+	}
+}
+
+bool UInferenceInterfaceOnnx::IsRecurrent() const
+{
+	return !StateTensors.empty();
+}
+
+bool UInferenceInterfaceOnnx::BindModelIO()
+{
+	try
+	{
+		return BindModelIOUnguarded();
+	}
+	catch (const Ort::Exception& e)
+	{
+		UE_LOG(LogTemp, Error, TEXT("UInferenceInterfaceOnnx: Failed to read model inputs and outputs: %s"), *FString(e.what()));
+		StateTensors.clear();
+		NumAgentRows = 0;
+		InputNames.clear();
+		OutputNames.clear();
+		return false;
+	}
+}
+
+bool UInferenceInterfaceOnnx::BindModelIOUnguarded()
+{
+	StateTensors.clear();
+	NumAgentRows = 0;
+	InputNames.clear();
+	OutputNames.clear();
+
+	Ort::AllocatorWithDefaultOptions Allocator;
+	TMap<FString, int32> InputIndices;
+	TMap<FString, int32> OutputIndices;
+	for (size_t i = 0; i < SessionPtr->GetInputCount(); i++)
+	{
+		InputIndices.Add(FString(SessionPtr->GetInputNameAllocated(i, Allocator).get()), static_cast<int32>(i));
+	}
+	for (size_t i = 0; i < SessionPtr->GetOutputCount(); i++)
+	{
+		OutputIndices.Add(FString(SessionPtr->GetOutputNameAllocated(i, Allocator).get()), static_cast<int32>(i));
+	}
+
+	if (!InputIndices.Contains(ObservationInputName) || !OutputIndices.Contains(ActionOutputName))
+	{
+		UE_LOG(LogTemp, Error, TEXT("UInferenceInterfaceOnnx: Model needs input \"%s\" and output \"%s\"."), *ObservationInputName, *ActionOutputName);
+		return false;
+	}
+
+	// FP16 graphs exported without float IO take and return halves, converted around the run.
+	// INT8 graphs from onnxruntime.quantization (dynamic or QDQ) keep float IO and need nothing extra.
+	ObservationElementType = SessionPtr->GetInputTypeInfo(InputIndices[ObservationInputName]).GetTensorTypeAndShapeInfo().GetElementType();
+	ActionElementType = SessionPtr->GetOutputTypeInfo(OutputIndices[ActionOutputName]).GetTensorTypeAndShapeInfo().GetElementType();
+	for (const ONNXTensorElementDataType ElementType : { ObservationElementType, ActionElementType })
+	{
+		if (ElementType != ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT && ElementType != ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16)
+		{
+			UE_LOG(LogTemp, Error, TEXT("UInferenceInterfaceOnnx: Observation and action tensors must be float or float16, got element type %d."), static_cast<int32>(ElementType));
+			return false;
+		}
+	}
+
+	// Pair remaining "<x>_in" inputs with "<x>_out" outputs unless the pairs are given
+	TArray<FRecurrentStateSpec> Specs = RecurrentStates;
+	if (Specs.Num() == 0)
+	{
+		for (const TPair<FString, int32>& Input : InputIndices)
+		{
+			if (Input.Key == ObservationInputName)
+			{
+				continue;
+			}
+			const FString OutputName = Input.Key.EndsWith(TEXT("_in")) ? Input.Key.LeftChop(3) + TEXT("_out") : FString();
+			if (OutputName.IsEmpty() || !OutputIndices.Contains(OutputName))
+			{
+				UE_LOG(LogTemp, Error, TEXT("UInferenceInterfaceOnnx: Input \"%s\" has no matching state output, set RecurrentStates."), *Input.Key);
+				return false;
+			}
+			FRecurrentStateSpec& Spec = Specs.AddDefaulted_GetRef();
+			Spec.InputName = Input.Key;
+			Spec.OutputName = OutputName;
+		}
+		// keep the graph's input order
+		Specs.Sort([&InputIndices](const FRecurrentStateSpec& A, const FRecurrentStateSpec& B)
+		{
+			return InputIndices[A.InputName] < InputIndices[B.InputName];
+		});
+	}
+
+	StateTensors.reserve(Specs.Num());
+	for (const FRecurrentStateSpec& Spec : Specs)
+	{
+		const int32* InputIndex = InputIndices.Find(Spec.InputName);
+		if (!InputIndex || !OutputIndices.Contains(Spec.OutputName))
+		{
+			UE_LOG(LogTemp, Error, TEXT("UInferenceInterfaceOnnx: State %s -> %s not found in the model."), *Spec.InputName, *Spec.OutputName);
+			return false;
+		}
+
+		FStateTensor& State = StateTensors.emplace_back();
+		State.InputName = TCHAR_TO_UTF8(*Spec.InputName);
+		State.OutputName = TCHAR_TO_UTF8(*Spec.OutputName);
+		State.Shape = SessionPtr->GetInputTypeInfo(*InputIndex).GetTensorTypeAndShapeInfo().GetShape();
+		if (SessionPtr->GetInputTypeInfo(*InputIndex).GetTensorTypeAndShapeInfo().GetElementType() != ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT)
+		{
+			UE_LOG(LogTemp, Error, TEXT("UInferenceInterfaceOnnx: State %s must be float, export recurrent models with float state IO."), *Spec.InputName);
+			return false;
+		}
+
+		// The batch axis is the dynamic one, [batch, hidden] or [layers, batch, hidden];
+		// fully static exports use the first dim of size 1.
+		State.BatchAxis = INDEX_NONE;
+		for (int32 Axis = 0; Axis < static_cast<int32>(State.Shape.size()) && State.BatchAxis == INDEX_NONE; Axis++)
+		{
+			if (State.Shape[Axis] < 0)
+			{
+				State.BatchAxis = Axis;
+			}
+		}
+		for (int32 Axis = 0; Axis < static_cast<int32>(State.Shape.size()) && State.BatchAxis == INDEX_NONE; Axis++)
+		{
+			if (State.Shape[Axis] == 1)
+			{
+				State.BatchAxis = Axis;
+			}
+		}
+		if (State.BatchAxis == INDEX_NONE)
+		{
+			UE_LOG(LogTemp, Error, TEXT("UInferenceInterfaceOnnx: State %s has no batch dimension."), *Spec.InputName);
+			return false;
+		}
+
+		for (int32 Axis = 0; Axis < static_cast<int32>(State.Shape.size()); Axis++)
+		{
+			if (Axis == State.BatchAxis)
+			{
+				continue;
+			}
+			if (State.Shape[Axis] < 0)
+			{
+				UE_LOG(LogTemp, Error, TEXT("UInferenceInterfaceOnnx: State %s has more than one dynamic dimension."), *Spec.InputName);
+				return false;
+			}
+			(Axis < State.BatchAxis ? State.OuterSize : State.InnerSize) *= State.Shape[Axis];
+		}
+
+		UE_LOG(LogTemp, Log, TEXT("UInferenceInterfaceOnnx: Recurrent state %s -> %s, %lld values per agent."),
+			*Spec.InputName, *Spec.OutputName, State.RowSize());
+	}
+
+	// Names are stable now, StateTensors is not resized until the next load
+	ObservationName = TCHAR_TO_UTF8(*ObservationInputName);
+	ActionName = TCHAR_TO_UTF8(*ActionOutputName);
+	InputNames.push_back(ObservationName.c_str());
+	OutputNames.push_back(ActionName.c_str());
+	for (const FStateTensor& State : StateTensors)
+	{
+		InputNames.push_back(State.InputName.c_str());
+		OutputNames.push_back(State.OutputName.c_str());
+	}
+
+	EnsureAgentCapacity(FMath::Max(MaxAgents, 1));
+	return true;
+}
+
+void UInferenceInterfaceOnnx::EnsureAgentCapacity(int32 NumAgents)
+{
+	if (NumAgents <= NumAgentRows)
+	{
+		return;
+	}
+
+	for (FStateTensor& State : StateTensors)
+	{
+		State.Buffer.SetNumZeroed(NumAgents * State.RowSize());
+	}
+	NumAgentRows = NumAgents;
+}
+
+float* UInferenceInterfaceOnnx::GatherState(FStateTensor& State, TConstArrayView<int32> AgentIds)
+{
+	const int32 BatchSize = AgentIds.Num();
+	const int64 RowSize = State.RowSize();
+
+	// Consecutive agents on a batch-major state already sit in batch layout
+	bool bConsecutive = State.OuterSize == 1;
+	for (int32 i = 1; i < BatchSize && bConsecutive; i++)
+	{
+		bConsecutive = AgentIds[i] == AgentIds[0] + i;
+	}
+	if (bConsecutive)
+	{
+		return State.Buffer.GetData() + AgentIds[0] * RowSize;
+	}
+
+	// [Outer, Batch, Inner] from agent rows of [Outer, Inner]
+	State.InputScratch.SetNumUninitialized(BatchSize * RowSize);
+	for (int64 Outer = 0; Outer < State.OuterSize; Outer++)
+	{
+		for (int32 i = 0; i < BatchSize; i++)
+		{
+			FMemory::Memcpy(State.InputScratch.GetData() + (Outer * BatchSize + i) * State.InnerSize,
+				State.Buffer.GetData() + AgentIds[i] * RowSize + Outer * State.InnerSize,
+				State.InnerSize * sizeof(float));
+		}
+	}
+	return State.InputScratch.GetData();
+}
+
+void UInferenceInterfaceOnnx::ScatterState(FStateTensor& State, TConstArrayView<int32> AgentIds)
+{
+	const int32 BatchSize = AgentIds.Num();
+	const int64 RowSize = State.RowSize();
+	for (int64 Outer = 0; Outer < State.OuterSize; Outer++)
+	{
+		for (int32 i = 0; i < BatchSize; i++)
+		{
+			FMemory::Memcpy(State.Buffer.GetData() + AgentIds[i] * RowSize + Outer * State.InnerSize,
+				State.OutputScratch.GetData() + (Outer * BatchSize + i) * State.InnerSize,
+				State.InnerSize * sizeof(float));
+		}
+	}
 }
 
 bool UInferenceInterfaceOnnx::IsModelLoaded() const
@@ -0,0 +1,357 @@
+#include "Inference/Training/OnnxPolicyTrainer.h"
+#include "Inference/InferenceInterfaces/InferenceInterfaceOnnx.h"
+#include "Math/RandomStream.h"
+#include "Misc/Paths.h"
+
+std::unique_ptr<Ort::Env> UOnnxPolicyTrainer::GEnv = nullptr;
+
+namespace
+{
+	std::basic_string<ORTCHAR_T> ToOrtPath(const FString& Path)
+	{
+#if PLATFORM_WINDOWS
+		return std::wstring(*Path);
+#else
+		return std::string(TCHAR_TO_UTF8(*Path));
+#endif
+	}
+}
+
+UOnnxPolicyTrainer::UOnnxPolicyTrainer()
+{
+}
+
+UOnnxPolicyTrainer::~UOnnxPolicyTrainer()
+{
+	// The session has to go before the checkpoint it trains on
+	SessionPtr.reset();
+	CheckpointPtr.reset();
+}
+
+bool UOnnxPolicyTrainer::IsTrainingSupported()
+{
+	// Plain inference builds of ONNX Runtime return no training api, Ort::GetTrainingApi() would dereference null
+	return Ort::GetApi().GetTrainingApi(ORT_API_VERSION) != nullptr;
+}
+
+bool UOnnxPolicyTrainer::LoadArtifacts(const FString& ArtifactsDirectory)
+{
+	SessionPtr.reset();
+	CheckpointPtr.reset();
+	InputNames.clear();
+	InputShapes.clear();
+
+	if (!IsTrainingSupported())
+	{
+		UE_LOG(LogTemp, Error, TEXT("UOnnxPolicyTrainer: The linked ONNX Runtime has no training support, install the onnxruntime-training binaries."));
+		return false;
+	}
+	if (!GEnv)
+	{
+		GEnv = std::make_unique<Ort::Env>(ORT_LOGGING_LEVEL_WARNING, "UnrealONNXTraining");
+	}
+
+	const FString TrainingModel = FPaths::Combine(ArtifactsDirectory, TEXT("training_model.onnx"));
+	const FString EvalModel = FPaths::Combine(ArtifactsDirectory, TEXT("eval_model.onnx"));
+	const FString OptimizerModel = FPaths::Combine(ArtifactsDirectory, TEXT("optimizer_model.onnx"));
+	const FString Checkpoint = FPaths::Combine(ArtifactsDirectory, TEXT("checkpoint"));
+
+	UE_LOG(LogTemp, Log, TEXT("UOnnxPolicyTrainer: Loading training artifacts from %s"), *ArtifactsDirectory);
+
+	try
+	{
+		CheckpointPtr = std::make_unique<Ort::CheckpointState>(Ort::CheckpointState::LoadCheckpoint(ToOrtPath(Checkpoint)));
+		Ort::SessionOptions SessionOptions;
+		SessionPtr = std::make_unique<Ort::TrainingSession>(*GEnv, SessionOptions, *CheckpointPtr,
+			ToOrtPath(TrainingModel), ToOrtPath(EvalModel), ToOrtPath(OptimizerModel));
+		InputNames = SessionPtr->InputNames(true);
+
+		// The training session has no type info, the eval graph takes the same user inputs and declares their shapes
+		Ort::Session EvalSession(*GEnv, ToOrtPath(EvalModel).c_str(), SessionOptions);
+		Ort::AllocatorWithDefaultOptions Allocator;
+		InputShapes.resize(InputNames.size());
+		for (size_t Input = 0; Input < InputNames.size(); Input++)
+		{
+			// an input named like a policy output makes ExportPolicy() prune to the input instead of the head
+			if (PolicyOutputNames.Contains(FString(InputNames[Input].c_str())))
+			{
+				UE_LOG(LogTemp, Error, TEXT("UOnnxPolicyTrainer: Training input '%s' is also a policy output name. Re-export the artifacts, taken actions are fed as \"taken_actions\"."),
+					*FString(InputNames[Input].c_str()));
+				SessionPtr.reset();
+				CheckpointPtr.reset();
+				InputNames.clear();
+				InputShapes.clear();
+				return false;
+			}
+
+			bool bFound = false;
+			for (size_t i = 0; i < EvalSession.GetInputCount() && !bFound; i++)
+			{
+				if (InputNames[Input] == EvalSession.GetInputNameAllocated(i, Allocator).get())
+				{
+					InputShapes[Input] = EvalSession.GetInputTypeInfo(i).GetTensorTypeAndShapeInfo().GetShape();
+					bFound = true;
+				}
+			}
+			if (!bFound || InputShapes[Input].empty())
+			{
+				UE_LOG(LogTemp, Error, TEXT("UOnnxPolicyTrainer: No batched shape for training input '%s' in the eval model."), *FString(InputNames[Input].c_str()));
+				SessionPtr.reset();
+				CheckpointPtr.reset();
+				InputNames.clear();
+				InputShapes.clear();
+				return false;
+			}
+		}
+	}
+	catch (const Ort::Exception& e)
+	{
+		UE_LOG(LogTemp, Error, TEXT("UOnnxPolicyTrainer: Failed to load training artifacts: %s"), *FString(e.what()));
+		SessionPtr.reset();
+		CheckpointPtr.reset();
+		InputNames.clear();
+		InputShapes.clear();
+		return false;
+	}
+
+	BatchScratch.assign(InputNames.size(), std::vector<float>());
+	NumUpdates = 0;
+	NumTrainCalls = 0;
+
+	FString InputList;
+	for (const std::string& Name : InputNames)
+	{
+		InputList += (InputList.IsEmpty() ? TEXT("") : TEXT(", ")) + FString(Name.c_str());
+	}
+	UE_LOG(LogTemp, Log, TEXT("UOnnxPolicyTrainer: Training graph inputs: %s"), *InputList);
+	return true;
+}
+
+TArray<FString> UOnnxPolicyTrainer::GetTrainingInputNames() const
+{
+	TArray<FString> Names;
+	for (const std::string& Name : InputNames)
+	{
+		Names.Add(FString(Name.c_str()));
+	}
+	return Names;
+}
+
+bool UOnnxPolicyTrainer::AddSample(const FString& InputName, const TArray<float>& Values)
+{
+	if (Values.Num() == 0)
+	{
+		return false;
+	}
+
+	int32& Width = SampleWidths.FindOrAdd(InputName, Values.Num());
+	if (Width != Values.Num())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("UOnnxPolicyTrainer: Sample of %d values for '%s', the column holds rows of %d."), Values.Num(), *InputName, Width);
+		return false;
+	}
+	SampleColumns.FindOrAdd(InputName).Append(Values);
+	return true;
+}
+
+void UOnnxPolicyTrainer::ClearSamples()
+{
+	SampleColumns.Reset();
+	SampleWidths.Reset();
+}
+
+int32 UOnnxPolicyTrainer::GetNumSamples(const FString& InputName) const
+{
+	const TArray<float>* Column = SampleColumns.Find(InputName);
+	const int32* Width = SampleWidths.Find(InputName);
+	return Column && Width ? Column->Num() / *Width : 0;
+}
+
+float UOnnxPolicyTrainer::TrainOnSamples()
+{
+	const int32 NumSamples = InputNames.empty() ? 0 : GetNumSamples(FString(InputNames[0].c_str()));
+	const float Loss = Train(SampleColumns, NumSamples);
+	ClearSamples();
+	return Loss;
+}
+
+float UOnnxPolicyTrainer::Train(const TMap<FString, TArray<float>>& Columns, int32 NumSamples)
+{
+	if (!SessionPtr)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("UOnnxPolicyTrainer: No training artifacts loaded."));
+		return -1.f;
+	}
+	if (NumSamples <= 0)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("UOnnxPolicyTrainer: Nothing to train on."));
+		return -1.f;
+	}
+
+	// Resolve one column per graph input, every column must hold whole rows of NumSamples
+	const int32 NumInputs = static_cast<int32>(InputNames.size());
+	TArray<const float*, TInlineAllocator<8>> ColumnData;
+	TArray<int32, TInlineAllocator<8>> Widths;
+	std::vector<std::vector<int64_t>> Shapes(NumInputs);
+	for (int32 Input = 0; Input < NumInputs; Input++)
+	{
+		const FString Name(InputNames[Input].c_str());
+		const TArray<float>* Column = Columns.Find(Name);
+		if (!Column || Column->Num() == 0 || Column->Num() % NumSamples != 0)
+		{
+			UE_LOG(LogTemp, Error, TEXT("UOnnxPolicyTrainer: Input '%s' needs %d rows, got %d values."),
+				*Name, NumSamples, Column ? Column->Num() : 0);
+			return -1.f;
+		}
+		ColumnData.Add(Column->GetData());
+		Widths.Add(Column->Num() / NumSamples);
+
+		// Rows take the declared shape behind the batch dim, [N] inputs like advantages hold one value per row
+		std::vector<int64_t>& Shape = Shapes[Input];
+		Shape = InputShapes[Input];
+		int64 RowSize = 1;
+		for (size_t Dim = 1; Dim < Shape.size(); Dim++)
+		{
+			if (Shape[Dim] < 0)
+			{
+				Shape[Dim] = Shape.size() == 2 ? Widths.Last() : 1;
+			}
+			RowSize *= Shape[Dim];
+		}
+		if (RowSize != Widths.Last())
+		{
+			UE_LOG(LogTemp, Error, TEXT("UOnnxPolicyTrainer: Input '%s' takes rows of %lld values, the column holds rows of %d."),
+				*Name, RowSize, Widths.Last());
+			return -1.f;
+		}
+	}
+
+	FRandomStream Stream(HashCombine(GetTypeHash(ShuffleSeed), GetTypeHash(NumTrainCalls++)));
+	TArray<int32> Order;
+	Order.SetNumUninitialized(NumSamples);
+	for (int32 i = 0; i < NumSamples; i++)
+	{
+		Order[i] = i;
+	}
+
+	static Ort::MemoryInfo MemoryInfo = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+	const int32 BatchSize = FMath::Clamp(MiniBatchSize, 1, NumSamples);
+	double LossSum = 0.0;
+	int32 NumSteps = 0;
+
+	try
+	{
+		SessionPtr->SetLearningRate(LearningRate);
+
+		for (int32 Epoch = 0; Epoch < FMath::Max(NumEpochs, 1); Epoch++)
+		{
+			for (int32 i = NumSamples - 1; i > 0; i--)
+			{
+				Order.Swap(i, Stream.RandRange(0, i));
+			}
+
+			for (int32 First = 0, Count = 0; First < NumSamples; First += Count)
+			{
+				// A lone trailing sample joins this mini-batch, per batch statistics like the advantage std need two
+				Count = FMath::Min(BatchSize, NumSamples - First);
+				if (NumSamples - First - Count == 1)
+				{
+					Count++;
+				}
+
+				std::vector<Ort::Value> InputValues;
+				InputValues.reserve(NumInputs);
+				for (int32 Input = 0; Input < NumInputs; Input++)
+				{
+					// Gather the shuffled rows into the input's shape with Count as the batch dim
+					const int32 Width = Widths[Input];
+					std::vector<float>& Batch = BatchScratch[Input];
+					Batch.resize(static_cast<size_t>(Count) * Width);
+					for (int32 Row = 0; Row < Count; Row++)
+					{
+						FMemory::Memcpy(Batch.data() + Row * Width, ColumnData[Input] + Order[First + Row] * Width, Width * sizeof(float));
+					}
+
+					std::vector<int64_t>& Shape = Shapes[Input];
+					Shape[0] = Count;
+					InputValues.push_back(Ort::Value::CreateTensor<float>(MemoryInfo, Batch.data(), Batch.size(), Shape.data(), Shape.size()));
+				}
+
+				std::vector<Ort::Value> Outputs = SessionPtr->TrainStep(InputValues);
+				SessionPtr->OptimizerStep();
+				SessionPtr->LazyResetGrad();
+				NumUpdates++;
+
+				if (!Outputs.empty() && Outputs[0].IsTensor())
+				{
+					LossSum += Outputs[0].GetTensorData<float>()[0];
+				}
+				NumSteps++;
+			}
+		}
+	}
+	catch (const Ort::Exception& e)
+	{
+		UE_LOG(LogTemp, Error, TEXT("UOnnxPolicyTrainer: Training step failed: %s"), *FString(e.what()));
+		return -1.f;
+	}
+
+	const float MeanLoss = static_cast<float>(LossSum / FMath::Max(NumSteps, 1));
+	UE_LOG(LogTemp, Verbose, TEXT("UOnnxPolicyTrainer: %d steps on %d samples, mean loss %f"), NumSteps, NumSamples, MeanLoss);
+	return MeanLoss;
+}
+
+bool UOnnxPolicyTrainer::SaveCheckpoint(const FString& CheckpointPath, bool bIncludeOptimizerState)
+{
+	if (!CheckpointPtr)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("UOnnxPolicyTrainer: No training artifacts loaded."));
+		return false;
+	}
+
+	try
+	{
+		Ort::CheckpointState::SaveCheckpoint(*CheckpointPtr, ToOrtPath(CheckpointPath), bIncludeOptimizerState);
+	}
+	catch (const Ort::Exception& e)
+	{
+		UE_LOG(LogTemp, Error, TEXT("UOnnxPolicyTrainer: Failed to save checkpoint: %s"), *FString(e.what()));
+		return false;
+	}
+	return true;
+}
+
+bool UOnnxPolicyTrainer::ExportPolicy(const FString& ModelPath)
+{
+	if (!SessionPtr)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("UOnnxPolicyTrainer: No training artifacts loaded."));
+		return false;
+	}
+
+	std::vector<std::string> OutputNames;
+	for (const FString& Name : PolicyOutputNames)
+	{
+		OutputNames.push_back(TCHAR_TO_UTF8(*Name));
+	}
+
+	try
+	{
+		SessionPtr->ExportModelForInferencing(ToOrtPath(ModelPath), OutputNames);
+	}
+	catch (const Ort::Exception& e)
+	{
+		UE_LOG(LogTemp, Error, TEXT("UOnnxPolicyTrainer: Failed to export the policy: %s"), *FString(e.what()));
+		return false;
+	}
+	return true;
+}
+
+bool UOnnxPolicyTrainer::UpdateInferenceInterface(UInferenceInterfaceOnnx* Interface, const FString& ModelPath)
+{
+	if (!Interface)
+	{
+		return false;
+	}
+	return ExportPolicy(ModelPath) && Interface->LoadModel(ModelPath);
+}
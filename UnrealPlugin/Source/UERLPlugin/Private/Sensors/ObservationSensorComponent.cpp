@@ -0,0 +1,14 @@
+#include "Sensors/ObservationSensorComponent.h"
+
+int32 UObservationSensorComponent::GetNumObservationValues() const
+{
+    TArray<FObservationField> Fields;
+    GetObservationFields(Fields);
+
+    int32 NumValues = 0;
+    for (const FObservationField& Field : Fields)
+    {
+        NumValues += Field.GetNumElements();
+    }
+    return NumValues;
+}
@@ -0,0 +1,391 @@
+#include "Sensors/PixelObservationComponent.h"
+#include "Components/SceneCaptureComponent2D.h"
+#include "Engine/TextureRenderTarget2D.h"
+#include "TextureResource.h"
+#include "RenderingThread.h"
+#include "RHI.h"
+#include "RHIGPUReadback.h"
+#include "Misc/App.h"
+
+/**
+ * Readback ring and output frames.
+ * Readbacks, sizes, formats, ring indices and Staging are only touched by the render thread
+ * (or by the game thread in software fallback mode); Latest and FrameNumber are guarded by Lock.
+ */
+struct FPixelReadbackState
+{
+    TArray<TUniquePtr<FRHIGPUTextureReadback>> Readbacks;
+    TArray<FIntPoint> ReadbackSizes;
+    TArray<EPixelFormat> ReadbackFormats;
+    int32 ReadIndex = 0;
+    int32 NumInFlight = 0;
+    bool bWarnedFormat = false;
+
+    /** Output layout, fixed in BeginPlay. */
+    int32 Width = 0;
+    int32 Height = 0;
+    int32 Channels = 3;
+
+    /** Frame being written, swapped into Latest when complete. */
+    TArray<uint8> Staging;
+
+    mutable FCriticalSection Lock;
+    TArray<uint8> Latest;
+    int64 FrameNumber = 0;
+
+    /** Makes Staging the latest frame, the previous frame buffer is reused as the next Staging. */
+    void Publish()
+    {
+        FScopeLock ScopeLock(&Lock);
+        Swap(Latest, Staging);
+        FrameNumber++;
+    }
+};
+
+namespace
+{
+    FORCEINLINE uint8 ToByte(float Value)
+    {
+        return static_cast<uint8>(FMath::Clamp(FMath::RoundToInt(Value), 0, 255));
+    }
+
+    /**
+     * Box-downsamples the source image into State.Staging as uint8 CHW.
+     * ReadPixel(X, Y, OutRGB) writes one source pixel as 0..255 floats.
+     */
+    template <typename ReadPixelFn>
+    void DownsampleToCHW(FPixelReadbackState& State, int32 SrcWidth, int32 SrcHeight, ReadPixelFn ReadPixel)
+    {
+        const int32 PlaneSize = State.Width * State.Height;
+        State.Staging.SetNumUninitialized(PlaneSize * State.Channels);
+        uint8* Out = State.Staging.GetData();
+
+        for (int32 Y = 0; Y < State.Height; Y++)
+        {
+            const int32 Y0 = Y * SrcHeight / State.Height;
+            const int32 Y1 = FMath::Max(Y0 + 1, (Y + 1) * SrcHeight / State.Height);
+            for (int32 X = 0; X < State.Width; X++)
+            {
+                const int32 X0 = X * SrcWidth / State.Width;
+                const int32 X1 = FMath::Max(X0 + 1, (X + 1) * SrcWidth / State.Width);
+
+                float Sum[3] = { 0.f, 0.f, 0.f };
+                float RGB[3];
+                for (int32 SrcY = Y0; SrcY < Y1; SrcY++)
+                {
+                    for (int32 SrcX = X0; SrcX < X1; SrcX++)
+                    {
+                        ReadPixel(SrcX, SrcY, RGB);
+                        Sum[0] += RGB[0];
+                        Sum[1] += RGB[1];
+                        Sum[2] += RGB[2];
+                    }
+                }
+
+                const float InvCount = 1.f / static_cast<float>((Y1 - Y0) * (X1 - X0));
+                const int32 OutIndex = Y * State.Width + X;
+                if (State.Channels == 1)
+                {
+                    // Rec. 601 luma
+                    Out[OutIndex] = ToByte((0.299f * Sum[0] + 0.587f * Sum[1] + 0.114f * Sum[2]) * InvCount);
+                }
+                else
+                {
+                    Out[OutIndex] = ToByte(Sum[0] * InvCount);
+                    Out[PlaneSize + OutIndex] = ToByte(Sum[1] * InvCount);
+                    Out[2 * PlaneSize + OutIndex] = ToByte(Sum[2] * InvCount);
+                }
+            }
+        }
+    }
+
+    /** Maps a finished readback, converts it into Staging and publishes it. Render thread only. */
+    void ResolveReadback(FPixelReadbackState& State, int32 Index)
+    {
+        FRHIGPUTextureReadback& Readback = *State.Readbacks[Index];
+        const FIntPoint Size = State.ReadbackSizes[Index];
+        const EPixelFormat Format = State.ReadbackFormats[Index];
+
+        int32 RowPitchInPixels = 0;
+        const void* Data = Readback.Lock(RowPitchInPixels);
+        if (!Data)
+        {
+            return;
+        }
+
+        bool bConverted = true;
+        switch (Format)
+        {
+        case PF_B8G8R8A8:
+        {
+            const FColor* Pixels = static_cast<const FColor*>(Data);
+            DownsampleToCHW(State, Size.X, Size.Y, [Pixels, RowPitchInPixels](int32 X, int32 Y, float* OutRGB)
+            {
+                const FColor& Pixel = Pixels[Y * RowPitchInPixels + X];
+                OutRGB[0] = Pixel.R;
+                OutRGB[1] = Pixel.G;
+                OutRGB[2] = Pixel.B;
+            });
+            break;
+        }
+        case PF_R8G8B8A8:
+        {
+            const uint8* Bytes = static_cast<const uint8*>(Data);
+            DownsampleToCHW(State, Size.X, Size.Y, [Bytes, RowPitchInPixels](int32 X, int32 Y, float* OutRGB)
+            {
+                const uint8* Pixel = Bytes + 4 * (Y * RowPitchInPixels + X);
+                OutRGB[0] = Pixel[0];
+                OutRGB[1] = Pixel[1];
+                OutRGB[2] = Pixel[2];
+            });
+            break;
+        }
+        case PF_FloatRGBA:
+        {
+            // default scene capture format, linear values clamped to 0..1
+            const FFloat16Color* Pixels = static_cast<const FFloat16Color*>(Data);
+            DownsampleToCHW(State, Size.X, Size.Y, [Pixels, RowPitchInPixels](int32 X, int32 Y, float* OutRGB)
+            {
+                const FFloat16Color& Pixel = Pixels[Y * RowPitchInPixels + X];
+                OutRGB[0] = FMath::Clamp(Pixel.R.GetFloat(), 0.f, 1.f) * 255.f;
+                OutRGB[1] = FMath::Clamp(Pixel.G.GetFloat(), 0.f, 1.f) * 255.f;
+                OutRGB[2] = FMath::Clamp(Pixel.B.GetFloat(), 0.f, 1.f) * 255.f;
+            });
+            break;
+        }
+        default:
+            bConverted = false;
+            break;
+        }
+        Readback.Unlock();
+
+        if (!bConverted)
+        {
+            if (!State.bWarnedFormat)
+            {
+                State.bWarnedFormat = true;
+                UE_LOG(LogTemp, Warning, TEXT("[UPixelObservationComponent] Unsupported render target format %s, use RTF_RGBA8 or RTF_RGBA16f."),
+                    GetPixelFormatString(Format));
+            }
+            return;
+        }
+        State.Publish();
+    }
+}
+
+UPixelObservationComponent::UPixelObservationComponent()
+{
+    PrimaryComponentTick.bCanEverTick = true;
+    // after the scene capture had its chance to update this frame
+    PrimaryComponentTick.TickGroup = TG_PostUpdateWork;
+    FieldName = TEXT("pixels");
+}
+
+void UPixelObservationComponent::BeginPlay()
+{
+    Super::BeginPlay();
+
+    if (!SceneCapture && GetOwner())
+    {
+        SceneCapture = GetOwner()->FindComponentByClass<USceneCaptureComponent2D>();
+    }
+
+    ReadbackState = MakeShared<FPixelReadbackState, ESPMode::ThreadSafe>();
+    ReadbackState->Width = FMath::Max(OutputWidth, 1);
+    ReadbackState->Height = FMath::Max(OutputHeight, 1);
+    ReadbackState->Channels = GetNumChannels();
+
+    bUseSoftwareFallback = bForceSoftwareFallback || GUsingNullRHI || !FApp::CanEverRender();
+    if (!bUseSoftwareFallback && (!SceneCapture || !SceneCapture->TextureTarget))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("[UPixelObservationComponent] %s has no scene capture with a render target, using the software fallback."),
+            *GetNameSafe(GetOwner()));
+        bUseSoftwareFallback = true;
+    }
+
+    if (!bUseSoftwareFallback)
+    {
+        const int32 Depth = FMath::Clamp(PipelineDepth, 1, 8);
+        for (int32 i = 0; i < Depth; i++)
+        {
+            ReadbackState->Readbacks.Add(MakeUnique<FRHIGPUTextureReadback>(TEXT("PixelObservationReadback")));
+        }
+        ReadbackState->ReadbackSizes.Init(FIntPoint::ZeroValue, Depth);
+        ReadbackState->ReadbackFormats.Init(PF_Unknown, Depth);
+    }
+}
+
+void UPixelObservationComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    if (ReadbackState && !bUseSoftwareFallback)
+    {
+        // readbacks may still be referenced by queued commands, release them on the render thread
+        ENQUEUE_RENDER_COMMAND(ReleasePixelObservationReadback)(
+            [State = MoveTemp(ReadbackState)](FRHICommandListImmediate& RHICmdList) mutable
+            {
+                State.Reset();
+            });
+    }
+    ReadbackState.Reset();
+
+    Super::EndPlay(EndPlayReason);
+}
+
+void UPixelObservationComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+    Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+    if (!ReadbackState)
+    {
+        return;
+    }
+
+    if (bUseSoftwareFallback)
+    {
+        WriteSoftwareFrame();
+        return;
+    }
+
+    // the capture may have been destroyed after BeginPlay
+    if (!SceneCapture)
+    {
+        return;
+    }
+
+    if (!SceneCapture->bCaptureEveryFrame)
+    {
+        SceneCapture->CaptureScene();
+    }
+    EnqueueReadback();
+}
+
+void UPixelObservationComponent::EnqueueReadback()
+{
+    UTextureRenderTarget2D* Target = SceneCapture ? SceneCapture->TextureTarget : nullptr;
+    FTextureRenderTargetResource* Resource = Target ? Target->GameThread_GetRenderTargetResource() : nullptr;
+    if (!Resource)
+    {
+        return;
+    }
+
+    ENQUEUE_RENDER_COMMAND(PixelObservationReadback)(
+        [State = ReadbackState, Resource](FRHICommandListImmediate& RHICmdList)
+        {
+            const int32 Depth = State->Readbacks.Num();
+
+            // resolve finished readbacks oldest first, mapping them no longer waits on the GPU
+            while (State->NumInFlight > 0 && State->Readbacks[State->ReadIndex]->IsReady())
+            {
+                ResolveReadback(*State, State->ReadIndex);
+                State->ReadIndex = (State->ReadIndex + 1) % Depth;
+                State->NumInFlight--;
+            }
+
+            // every buffer still in flight: drop this frame rather than stall
+            if (State->NumInFlight == Depth)
+            {
+                return;
+            }
+
+            FRHITexture* Texture = Resource->GetRenderTargetTexture();
+            if (!Texture)
+            {
+                return;
+            }
+
+            const int32 WriteIndex = (State->ReadIndex + State->NumInFlight) % Depth;
+            State->ReadbackSizes[WriteIndex] = Texture->GetSizeXY();
+            State->ReadbackFormats[WriteIndex] = Texture->GetFormat();
+            State->Readbacks[WriteIndex]->EnqueueCopy(RHICmdList, Texture);
+            State->NumInFlight++;
+        });
+}
+
+void UPixelObservationComponent::WriteSoftwareFrame()
+{
+    FPixelReadbackState& State = *ReadbackState;
+    const int32 PlaneSize = State.Width * State.Height;
+    const int64 Frame = State.FrameNumber;
+
+    State.Staging.SetNumUninitialized(PlaneSize * State.Channels);
+    uint8* Out = State.Staging.GetData();
+    for (int32 C = 0; C < State.Channels; C++)
+    {
+        for (int32 Y = 0; Y < State.Height; Y++)
+        {
+            for (int32 X = 0; X < State.Width; X++)
+            {
+                *Out++ = static_cast<uint8>((X + Y + 85 * C + Frame) & 0xFF);
+            }
+        }
+    }
+    State.Publish();
+}
+
+bool UPixelObservationComponent::CopyLatestFrame(TArray<uint8>& OutPixels) const
+{
+    if (!ReadbackState)
+    {
+        return false;
+    }
+
+    FScopeLock ScopeLock(&ReadbackState->Lock);
+    if (ReadbackState->Latest.Num() == 0)
+    {
+        return false;
+    }
+    OutPixels = ReadbackState->Latest;
+    return true;
+}
+
+int64 UPixelObservationComponent::GetFrameNumber() const
+{
+    if (!ReadbackState)
+    {
+        return 0;
+    }
+
+    FScopeLock ScopeLock(&ReadbackState->Lock);
+    return ReadbackState->FrameNumber;
+}
+
+void UPixelObservationComponent::GetObservationFields(TArray<FObservationField>& OutFields) const
+{
+    FObservationField& Field = OutFields.AddDefaulted_GetRef();
+    Field.Name = FieldName;
+    Field.DType = EObservationDType::UInt8;
+    Field.Shape = { GetNumChannels(), OutputHeight, OutputWidth };
+}
+
+void UPixelObservationComponent::WriteObservation(TArrayView<float> OutValues) const
+{
+    if (!ReadbackState)
+    {
+        for (float& Value : OutValues)
+        {
+            Value = 0.f;
+        }
+        return;
+    }
+
+    FScopeLock ScopeLock(&ReadbackState->Lock);
+    const TArray<uint8>& Latest = ReadbackState->Latest;
+    const int32 NumToCopy = FMath::Min(Latest.Num(), OutValues.Num());
+    for (int32 i = 0; i < OutValues.Num(); i++)
+    {
+        OutValues[i] = i < NumToCopy ? static_cast<float>(Latest[i]) : 0.f;
+    }
+}
+
+bool UPixelObservationComponent::WritePackedObservation(TArrayView<uint8> OutBytes) const
+{
+    int32 NumCopied = 0;
+    if (ReadbackState)
+    {
+        FScopeLock ScopeLock(&ReadbackState->Lock);
+        NumCopied = FMath::Min(ReadbackState->Latest.Num(), OutBytes.Num());
+        FMemory::Memcpy(OutBytes.GetData(), ReadbackState->Latest.GetData(), NumCopied);
+    }
+    FMemory::Memzero(OutBytes.GetData() + NumCopied, OutBytes.Num() - NumCopied);
+    return true;
+}
@@ -0,0 +1,160 @@
+#include "Sensors/RaySensorComponent.h"
+#include "UERLPlugin/Helpers/BPFL_PackingHelpers.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "Components/PrimitiveComponent.h"
+
+URaySensorComponent::URaySensorComponent()
+{
+    PrimaryComponentTick.bCanEverTick = true;
+    FieldName = TEXT("rays");
+}
+
+void URaySensorComponent::BeginPlay()
+{
+    Super::BeginPlay();
+
+    const int32 Rays = FMath::Clamp(NumRays, 1, 65535);
+
+    if (GetFieldDType() != DType)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("[URaySensorComponent] %s: %s would round the 0..1 readings away, sending float32."),
+            *GetNameSafe(GetOwner()), FObservationSchema::DTypeToString(DType));
+    }
+
+    // spread evenly over the FOV, a full circle must not repeat its first ray at the end
+    const bool bFullCircle = HorizontalFOVDegrees >= 360.f;
+    const float Step = Rays > 1 ? HorizontalFOVDegrees / (bFullCircle ? Rays : Rays - 1) : 0.f;
+    const float FirstYaw = Rays > 1 && !bFullCircle ? -0.5f * HorizontalFOVDegrees : 0.f;
+
+    LocalDirections.SetNumUninitialized(Rays);
+    for (int32 i = 0; i < Rays; i++)
+    {
+        LocalDirections[i] = FRotator(PitchDegrees, FirstYaw + i * Step, 0.f).Vector();
+    }
+
+    const int32 NumValues = Rays * GetValuesPerRay();
+    PendingValues.Init(0.f, NumValues);
+    LatestValues.Init(0.f, NumValues);
+    NumPendingRays = 0;
+
+    QueryParams = FCollisionQueryParams(SCENE_QUERY_STAT(RaySensor), false, GetOwner());
+    TraceDelegate.BindUObject(this, &URaySensorComponent::OnTraceCompleted);
+}
+
+void URaySensorComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+    Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+    // wait for the whole previous batch, rays of one reading always share a frame
+    if (NumPendingRays == 0)
+    {
+        IssueTraceBatch();
+    }
+    else if (GFrameCounter - BatchIssueFrame >= static_cast<uint64>(FMath::Max(BatchTimeoutFrames, 1)))
+    {
+        // a lost result would stall the sensor forever, start over with a new batch
+        UE_LOG(LogTemp, Verbose, TEXT("[URaySensorComponent] %s: batch %d timed out with %d rays pending, reissuing."),
+            *GetNameSafe(GetOwner()), BatchId, NumPendingRays);
+        IssueTraceBatch();
+    }
+}
+
+void URaySensorComponent::IssueTraceBatch()
+{
+    UWorld* World = GetWorld();
+    const AActor* Owner = GetOwner();
+    if (!World || !Owner || LocalDirections.Num() == 0)
+    {
+        return;
+    }
+
+    const FTransform& OwnerTransform = Owner->GetActorTransform();
+    const FVector Start = OwnerTransform.TransformPosition(StartOffset);
+
+    BatchId++;
+    BatchIssueFrame = GFrameCounter;
+    NumPendingRays = LocalDirections.Num();
+    for (int32 i = 0; i < LocalDirections.Num(); i++)
+    {
+        const FVector End = Start + OwnerTransform.TransformVectorNoScale(LocalDirections[i]) * RayLength;
+        World->AsyncLineTraceByChannel(EAsyncTraceType::Single, Start, End, TraceChannel, QueryParams,
+            FCollisionResponseParams::DefaultResponseParam, &TraceDelegate, (static_cast<uint32>(BatchId) << 16) | static_cast<uint32>(i));
+    }
+}
+
+void URaySensorComponent::OnTraceCompleted(const FTraceHandle& Handle, FTraceDatum& Data)
+{
+    if (static_cast<uint16>(Data.UserData >> 16) != BatchId || NumPendingRays <= 0)
+    {
+        // result of an abandoned batch
+        return;
+    }
+
+    const int32 RayIndex = static_cast<int32>(Data.UserData & 0xFFFF);
+    const int32 ValuesPerRay = GetValuesPerRay();
+    if ((RayIndex + 1) * ValuesPerRay > PendingValues.Num())
+    {
+        return;
+    }
+
+    float* RayValues = PendingValues.GetData() + RayIndex * ValuesPerRay;
+    for (int32 i = 0; i < ValuesPerRay; i++)
+    {
+        RayValues[i] = 0.f;
+    }
+    RayValues[0] = 1.f;
+
+    for (const FHitResult& Hit : Data.OutHits)
+    {
+        if (!Hit.bBlockingHit)
+        {
+            continue;
+        }
+
+        RayValues[0] = FMath::Clamp(Hit.Distance / RayLength, 0.f, 1.f);
+        const AActor* HitActor = Hit.GetActor();
+        const UPrimitiveComponent* HitComponent = Hit.GetComponent();
+        for (int32 TagIndex = 0; TagIndex < DetectableTags.Num(); TagIndex++)
+        {
+            const FName& Tag = DetectableTags[TagIndex];
+            const bool bHasTag = (HitActor && HitActor->ActorHasTag(Tag)) || (HitComponent && HitComponent->ComponentHasTag(Tag));
+            RayValues[1 + TagIndex] = bHasTag ? 1.f : 0.f;
+        }
+        break;
+    }
+
+    if (--NumPendingRays == 0)
+    {
+        FScopeLock ScopeLock(&ReadingLock);
+        Swap(LatestValues, PendingValues);
+    }
+}
+
+TArray<float> URaySensorComponent::GetLatestReading() const
+{
+    FScopeLock ScopeLock(&ReadingLock);
+    return LatestValues;
+}
+
+void URaySensorComponent::GetObservationFields(TArray<FObservationField>& OutFields) const
+{
+    const TArray<int32> Shape = { FMath::Clamp(NumRays, 1, 65535), GetValuesPerRay() };
+    // all values lie in 0..1, which also fixes the quantization range
+    OutFields.Add(UBPFL_PackingHelpers::MakeQuantizedField(FieldName, GetFieldDType(), Shape, 0.f, 1.f));
+}
+
+EObservationDType URaySensorComponent::GetFieldDType() const
+{
+    return DType == EObservationDType::UInt8 || DType == EObservationDType::Int32 ? EObservationDType::Float32 : DType;
+}
+
+void URaySensorComponent::WriteObservation(TArrayView<float> OutValues) const
+{
+    FScopeLock ScopeLock(&ReadingLock);
+    const int32 NumToCopy = FMath::Min(LatestValues.Num(), OutValues.Num());
+    for (int32 i = 0; i < OutValues.Num(); i++)
+    {
+        OutValues[i] = i < NumToCopy ? LatestValues[i] : 0.f;
+    }
+}
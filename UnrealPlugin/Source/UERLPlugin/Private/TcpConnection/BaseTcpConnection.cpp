@@ -1,5 +1,9 @@
 #include "TcpConnection/BaseTcpConnection.h"
 #include "SocketSubsystem.h"
+#include "Misc/Parse.h"
+#include "Misc/ScopeLock.h"
+#include "TcpConnection/Threads/AcceptRunnable.h"
+#include "TcpConnection/BridgeConnectionSubsystem.h"
 
 bool UBaseTcpConnection::AcceptConnection()
 {
@@ -25,6 +29,18 @@ bool UBaseTcpConnection::AcceptConnection()
         return false;
     }
 
+    return AssignSocket(NewSock);
+}
+
+bool UBaseTcpConnection::AssignSocket(FSocket* NewSock)
+{
+    if (!NewSock)
+    {
+        return false;
+    }
+
+    FScopeLock Lock(&SocketMutex);
+
     // If we have no admin yet, this new socket becomes the admin client.
     if (!AdminSocket)
     {
@@ -42,6 +58,7 @@ bool UBaseTcpConnection::AcceptConnection()
 
 bool UBaseTcpConnection::SendMessageAdmin(const FString& Data)
 {
+    FScopeLock Lock(&SocketMutex);
     if (!AdminSocket)
     {
         UE_LOG(LogTemp, Warning, TEXT("[UBaseTcpConnection] No admin socket to send to."));
@@ -56,6 +73,7 @@ bool UBaseTcpConnection::SendMessageAdmin(const FString& Data)
     if (!bSuccess || BytesSent <= 0)
     {
         UE_LOG(LogTemp, Warning, TEXT("[UBaseTcpConnection] Failed to send data to admin."));
+        ReleaseAdminSocket();
         return false;
     }
 
@@ -63,8 +81,60 @@ bool UBaseTcpConnection::SendMessageAdmin(const FString& Data)
     return true;
 }
 
+bool UBaseTcpConnection::SendMessageAdminBinary(const FString& Header, TConstArrayView<uint8> Payload)
+{
+    FScopeLock Lock(&SocketMutex);
+    if (!AdminSocket)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("[UBaseTcpConnection] No admin socket to send to."));
+        return false;
+    }
+
+    TArray<uint8> Frame;
+    BuildBinaryFrame(Header, Payload, Frame);
+    if (!SendAllBytes(AdminSocket, Frame))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("[UBaseTcpConnection] Failed to send binary frame to admin."));
+        ReleaseAdminSocket();
+        return false;
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("[UBaseTcpConnection] Sent to admin => %s (%d bytes)"), *Header, Payload.Num());
+    return true;
+}
+
+bool UBaseTcpConnection::SendMessageEnvBinary(const FString& Header, TConstArrayView<uint8> Payload)
+{
+    UE_LOG(LogTemp, Warning, TEXT("[UBaseTcpConnection] Binary frames are not supported by this connection."));
+    return false;
+}
+
+void UBaseTcpConnection::BuildBinaryFrame(const FString& Header, TConstArrayView<uint8> Payload, TArray<uint8>& OutFrame)
+{
+    FTCHARToUTF8 Converter(*FString::Printf(TEXT("%s;BYTES=%d\n"), *Header, Payload.Num()));
+    OutFrame.Reset(Converter.Length() + Payload.Num());
+    OutFrame.Append(reinterpret_cast<const uint8*>(Converter.Get()), Converter.Length());
+    OutFrame.Append(Payload.GetData(), Payload.Num());
+}
+
+bool UBaseTcpConnection::SendAllBytes(FSocket* Socket, TConstArrayView<uint8> Bytes)
+{
+    int32 TotalSent = 0;
+    while (Socket && TotalSent < Bytes.Num())
+    {
+        int32 BytesSent = 0;
+        if (!Socket->Send(Bytes.GetData() + TotalSent, Bytes.Num() - TotalSent, BytesSent) || BytesSent <= 0)
+        {
+            return false;
+        }
+        TotalSent += BytesSent;
+    }
+    return TotalSent == Bytes.Num();
+}
+
 FString UBaseTcpConnection::ReceiveMessageAdmin(int32 BufSize)
 {
+    FScopeLock Lock(&SocketMutex);
     if (!AdminSocket)
     {
         UE_LOG(LogTemp, Warning, TEXT("[UBaseTcpConnection] No admin socket to receive from."));
@@ -87,16 +157,100 @@ FString UBaseTcpConnection::ReceiveMessageAdmin(int32 BufSize)
         return TEXT("");
     }
 
-    FString ReceivedString = FString(UTF8_TO_TCHAR(reinterpret_cast<const char*>(DataBuffer.GetData())));
+    // the buffer is not null terminated, convert exactly the bytes read
+    const FUTF8ToTCHAR Converter(reinterpret_cast<const ANSICHAR*>(DataBuffer.GetData()), BytesRead);
+    FString ReceivedString(Converter.Length(), Converter.Get());
     UE_LOG(LogTemp, Log, TEXT("[UBaseTcpConnection] Received from admin => %s"), *ReceivedString);
     return ReceivedString;
 }
 
+bool UBaseTcpConnection::ReceiveAdminFrame(FAdminFrame& OutFrame)
+{
+    FScopeLock Lock(&SocketMutex);
+
+    // drain whatever arrived, frames are cut from the front of the buffer
+    uint32 PendingSize = 0;
+    while (AdminSocket && AdminSocket->HasPendingData(PendingSize) && PendingSize > 0)
+    {
+        const int32 Offset = AdminReceiveBuffer.Num();
+        AdminReceiveBuffer.AddUninitialized(PendingSize);
+
+        int32 BytesRead = 0;
+        const bool bOk = AdminSocket->Recv(AdminReceiveBuffer.GetData() + Offset, PendingSize, BytesRead);
+        AdminReceiveBuffer.SetNum(Offset + FMath::Max(BytesRead, 0), false);
+        if (!bOk || BytesRead <= 0)
+        {
+            break;
+        }
+    }
+
+    const int32 LineEnd = AdminReceiveBuffer.Find(static_cast<uint8>('\n'));
+    if (LineEnd == INDEX_NONE)
+    {
+        return false;
+    }
+
+    const FUTF8ToTCHAR Converter(reinterpret_cast<const ANSICHAR*>(AdminReceiveBuffer.GetData()), LineEnd);
+    const FString Header = FString(Converter.Length(), Converter.Get()).TrimStartAndEnd();
+
+    int32 PayloadSize = 0;
+    FParse::Value(*Header, TEXT("BYTES="), PayloadSize);
+    const int32 FrameSize = LineEnd + 1 + FMath::Max(PayloadSize, 0);
+    if (AdminReceiveBuffer.Num() < FrameSize)
+    {
+        return false;
+    }
+
+    OutFrame.Header = Header;
+    OutFrame.Payload.Reset(FrameSize - LineEnd - 1);
+    OutFrame.Payload.Append(AdminReceiveBuffer.GetData() + LineEnd + 1, FrameSize - LineEnd - 1);
+    AdminReceiveBuffer.RemoveAt(0, FrameSize, false);
+    return true;
+}
+
 FSocket* UBaseTcpConnection::GetListeningSocket()
 {
     return ListeningSocket;
 }
 
+void UBaseTcpConnection::SetSharedBridgeId(const FString& InBridgeId)
+{
+    SharedBridgeId = InBridgeId;
+}
+
+bool UBaseTcpConnection::StartSharedListening(const FString& IPAddress, int32 Port)
+{
+    UBridgeConnectionSubsystem* Subsystem = UBridgeConnectionSubsystem::Get();
+    if (!Subsystem)
+    {
+        UE_LOG(LogTemp, Error, TEXT("[UBaseTcpConnection] Bridge connection subsystem not available."));
+        return false;
+    }
+
+    if (!Subsystem->RegisterConnection(Port, SharedBridgeId, this))
+    {
+        return false;
+    }
+
+    SharedPort = Port;
+    UE_LOG(LogTemp, Log, TEXT("[UBaseTcpConnection] Listening on shared %s:%d as bridge '%s'."), *IPAddress, Port, *SharedBridgeId);
+    return true;
+}
+
+void UBaseTcpConnection::StopSharedListening()
+{
+    if (SharedPort == INDEX_NONE)
+    {
+        return;
+    }
+
+    if (UBridgeConnectionSubsystem* Subsystem = UBridgeConnectionSubsystem::Get())
+    {
+        Subsystem->UnregisterConnection(SharedPort, SharedBridgeId);
+    }
+    SharedPort = INDEX_NONE;
+}
+
 void UBaseTcpConnection::SendHandshake()
 {
     SendMessageAdmin(HandshakeMessage);
@@ -106,3 +260,94 @@ void UBaseTcpConnection::SetHandshake(const FString& InHandshakeMsg)
 {
     HandshakeMessage = InHandshakeMsg;
 }
+
+void UBaseTcpConnection::PollDisconnects()
+{
+    FScopeLock Lock(&SocketMutex);
+    if (AdminSocket && !IsSocketAlive(AdminSocket))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("[UBaseTcpConnection] Admin socket disconnected."));
+        ReleaseAdminSocket();
+    }
+}
+
+bool UBaseTcpConnection::IsSocketAlive(FSocket* Socket) const
+{
+    if (!Socket)
+    {
+        return false;
+    }
+
+    uint32 PendingSize = 0;
+    if (Socket->HasPendingData(PendingSize) && PendingSize > 0)
+    {
+        return true;
+    }
+
+    // Readable with nothing pending means the peer closed the connection (or it errored),
+    // peek so we never eat real data
+    if (Socket->Wait(ESocketWaitConditions::WaitForRead, FTimespan::Zero()))
+    {
+        uint8 Probe = 0;
+        int32 BytesRead = 0;
+        if (!Socket->Recv(&Probe, 1, BytesRead, ESocketReceiveFlags::Peek) || BytesRead == 0)
+        {
+            return false;
+        }
+    }
+
+    return Socket->GetConnectionState() != SCS_ConnectionError;
+}
+
+void UBaseTcpConnection::ReleaseAdminSocket()
+{
+    FScopeLock Lock(&SocketMutex);
+    if (!AdminSocket)
+    {
+        return;
+    }
+
+    AdminSocket->Close();
+    ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(AdminSocket);
+    AdminSocket = nullptr;
+    AdminReceiveBuffer.Reset();
+
+    // Next accepted connection becomes the admin again and receives the handshake
+    RearmAcceptThread();
+}
+
+void UBaseTcpConnection::CloseAdminSocket()
+{
+    FScopeLock Lock(&SocketMutex);
+    if (AdminSocket)
+    {
+        AdminSocket->Close();
+        ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(AdminSocket);
+        AdminSocket = nullptr;
+    }
+    AdminReceiveBuffer.Reset();
+}
+
+bool UBaseTcpConnection::HasAdminSocket() const
+{
+    FScopeLock Lock(&SocketMutex);
+    return AdminSocket != nullptr;
+}
+
+void UBaseTcpConnection::RearmAcceptThread()
+{
+    if (bStopAcceptThreadRef || UsesSharedListener())
+    {
+        // Connection is shutting down, or the shared listener keeps accepting for us
+        return;
+    }
+
+    if (AcceptRunnableRef.IsValid() && AcceptThreadRef)
+    {
+        AcceptRunnableRef->Resume();
+    }
+    else
+    {
+        StartAcceptThread();
+    }
+}
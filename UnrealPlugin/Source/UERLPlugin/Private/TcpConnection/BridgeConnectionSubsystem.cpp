@@ -0,0 +1,240 @@
+#include "TcpConnection/BridgeConnectionSubsystem.h"
+#include "TcpConnection/BaseTcpConnection.h"
+#include "TcpConnection/Threads/SharedAcceptRunnable.h"
+#include "Common/TcpSocketBuilder.h"
+#include "SocketSubsystem.h"
+#include "Engine/Engine.h"
+#include "Misc/ScopeLock.h"
+
+UBridgeConnectionSubsystem* UBridgeConnectionSubsystem::Get()
+{
+    return GEngine ? GEngine->GetEngineSubsystem<UBridgeConnectionSubsystem>() : nullptr;
+}
+
+void UBridgeConnectionSubsystem::Deinitialize()
+{
+    TMap<int32, FSharedListener> ClosingListeners;
+    TArray<FRoutedSocket> DroppedSockets;
+    {
+        FScopeLock Lock(&ListenerMutex);
+        ClosingListeners = MoveTemp(Listeners);
+        Listeners.Reset();
+        DroppedSockets = MoveTemp(RoutedSockets);
+        RoutedSockets.Reset();
+    }
+    DestroyRoutedSockets(DroppedSockets);
+
+    // Accept threads take ListenerMutex while routing, so join them without holding it
+    for (TPair<int32, FSharedListener>& Pair : ClosingListeners)
+    {
+        ShutdownListener(Pair.Value);
+    }
+
+    Super::Deinitialize();
+}
+
+bool UBridgeConnectionSubsystem::RegisterConnection(int32 Port, const FString& BridgeId, UBaseTcpConnection* Connection)
+{
+    if (!Connection || BridgeId.IsEmpty())
+    {
+        UE_LOG(LogTemp, Error, TEXT("[UBridgeConnectionSubsystem] RegisterConnection needs a connection and a bridge id."));
+        return false;
+    }
+
+    FScopeLock Lock(&ListenerMutex);
+
+    FSharedListener* Listener = Listeners.Find(Port);
+    if (!Listener)
+    {
+        // First bridge on this port, open the shared listener.
+        // The backlog has to absorb the admin + env connections of every bridge arriving together.
+        FSocket* ListeningSocket = FTcpSocketBuilder(TEXT("SharedBridgeListener"))
+            .AsReusable()
+            .BoundToAddress(FIPv4Address::Any)
+            .BoundToPort(Port)
+            .Listening(64);
+
+        if (!ListeningSocket)
+        {
+            UE_LOG(LogTemp, Error, TEXT("[UBridgeConnectionSubsystem] Failed to create shared listening socket on port %d."), Port);
+            return false;
+        }
+
+        Listener = &Listeners.Add(Port);
+        Listener->ListeningSocket = ListeningSocket;
+        Listener->AcceptRunnable = MakeShareable(new FSharedAcceptRunnable(this, ListeningSocket, Port));
+        Listener->AcceptThread = FRunnableThread::Create(
+            Listener->AcceptRunnable.Get(),
+            *FString::Printf(TEXT("SharedBridgeAcceptThread_%d"), Port),
+            0,
+            TPri_Normal
+        );
+
+        if (!Listener->AcceptThread)
+        {
+            UE_LOG(LogTemp, Error, TEXT("[UBridgeConnectionSubsystem] Failed to start accept thread for port %d."), Port);
+        }
+        else
+        {
+            UE_LOG(LogTemp, Log, TEXT("[UBridgeConnectionSubsystem] Shared listener started on port %d."), Port);
+        }
+    }
+
+    // A stale entry of a destroyed connection can be taken over
+    const TWeakObjectPtr<UBaseTcpConnection>* Existing = Listener->Connections.Find(BridgeId);
+    if (Existing && Existing->IsValid())
+    {
+        UE_LOG(LogTemp, Error, TEXT("[UBridgeConnectionSubsystem] Bridge id '%s' is already registered on port %d."), *BridgeId, Port);
+        return false;
+    }
+
+    Listener->Connections.Add(BridgeId, Connection);
+    UE_LOG(LogTemp, Log, TEXT("[UBridgeConnectionSubsystem] Bridge '%s' registered on port %d (%d bridge(s))."),
+        *BridgeId, Port, Listener->Connections.Num());
+    return true;
+}
+
+void UBridgeConnectionSubsystem::UnregisterConnection(int32 Port, const FString& BridgeId)
+{
+    FSharedListener ClosingListener;
+    bool bLastBridge = false;
+    TArray<FRoutedSocket> DroppedSockets;
+    {
+        FScopeLock Lock(&ListenerMutex);
+
+        FSharedListener* Listener = Listeners.Find(Port);
+        if (!Listener || Listener->Connections.Remove(BridgeId) == 0)
+        {
+            return;
+        }
+        UE_LOG(LogTemp, Log, TEXT("[UBridgeConnectionSubsystem] Bridge '%s' unregistered from port %d."), *BridgeId, Port);
+
+        // sockets that were accepted for this bridge but not handed over yet
+        for (int32 i = RoutedSockets.Num() - 1; i >= 0; i--)
+        {
+            if (RoutedSockets[i].Port == Port && RoutedSockets[i].BridgeId == BridgeId)
+            {
+                DroppedSockets.Add(RoutedSockets[i]);
+                RoutedSockets.RemoveAt(i);
+            }
+        }
+
+        if (Listener->Connections.Num() == 0)
+        {
+            ClosingListener = MoveTemp(*Listener);
+            Listeners.Remove(Port);
+            bLastBridge = true;
+        }
+    }
+    DestroyRoutedSockets(DroppedSockets);
+
+    if (!bLastBridge)
+    {
+        return;
+    }
+
+    // Last bridge on this port is gone
+    ShutdownListener(ClosingListener);
+    UE_LOG(LogTemp, Log, TEXT("[UBridgeConnectionSubsystem] Shared listener on port %d closed."), Port);
+}
+
+bool UBridgeConnectionSubsystem::RouteSocket(int32 Port, const FString& BridgeId, FSocket* Socket)
+{
+    // The connection is a UObject the game thread may destroy at any time, so it is never resolved here
+    FScopeLock Lock(&ListenerMutex);
+    const FSharedListener* Listener = Listeners.Find(Port);
+    if (!Listener || !Listener->Connections.Contains(BridgeId))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("[UBridgeConnectionSubsystem] No bridge '%s' registered on port %d."), *BridgeId, Port);
+        return false;
+    }
+
+    FRoutedSocket& Routed = RoutedSockets.AddDefaulted_GetRef();
+    Routed.Port = Port;
+    Routed.BridgeId = BridgeId;
+    Routed.Socket = Socket;
+    return true;
+}
+
+void UBridgeConnectionSubsystem::Tick(float DeltaTime)
+{
+    TArray<FRoutedSocket> Sockets;
+    TArray<TWeakObjectPtr<UBaseTcpConnection>> Targets;
+    {
+        FScopeLock Lock(&ListenerMutex);
+        if (RoutedSockets.Num() == 0)
+        {
+            return;
+        }
+        Sockets = MoveTemp(RoutedSockets);
+        RoutedSockets.Reset();
+
+        for (const FRoutedSocket& Routed : Sockets)
+        {
+            const FSharedListener* Listener = Listeners.Find(Routed.Port);
+            const TWeakObjectPtr<UBaseTcpConnection>* Found = Listener ? Listener->Connections.Find(Routed.BridgeId) : nullptr;
+            Targets.Add(Found ? *Found : nullptr);
+        }
+    }
+
+    // AssignSocket() sends the handshake and must not stall the accept threads, so it runs unlocked
+    TArray<FRoutedSocket> DroppedSockets;
+    for (int32 i = 0; i < Sockets.Num(); i++)
+    {
+        UBaseTcpConnection* Connection = Targets[i].Get();
+        if (!Connection)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("[UBridgeConnectionSubsystem] Bridge '%s' on port %d is gone, dropping its connection."),
+                *Sockets[i].BridgeId, Sockets[i].Port);
+            DroppedSockets.Add(Sockets[i]);
+            continue;
+        }
+
+        // a connection that rejects the socket destroys it itself
+        UE_LOG(LogTemp, Log, TEXT("[UBridgeConnectionSubsystem] Routing connection on port %d to bridge '%s'."), Sockets[i].Port, *Sockets[i].BridgeId);
+        Connection->AssignSocket(Sockets[i].Socket);
+    }
+    DestroyRoutedSockets(DroppedSockets);
+}
+
+TStatId UBridgeConnectionSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UBridgeConnectionSubsystem, STATGROUP_Tickables);
+}
+
+void UBridgeConnectionSubsystem::DestroyRoutedSockets(TArray<FRoutedSocket>& Sockets)
+{
+    for (FRoutedSocket& Routed : Sockets)
+    {
+        if (Routed.Socket)
+        {
+            Routed.Socket->Close();
+            ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(Routed.Socket);
+            Routed.Socket = nullptr;
+        }
+    }
+    Sockets.Reset();
+}
+
+void UBridgeConnectionSubsystem::ShutdownListener(FSharedListener& Listener)
+{
+    if (Listener.AcceptRunnable.IsValid())
+    {
+        Listener.AcceptRunnable->Stop();
+    }
+    if (Listener.AcceptThread)
+    {
+        Listener.AcceptThread->Kill(true);
+        delete Listener.AcceptThread;
+        Listener.AcceptThread = nullptr;
+    }
+    Listener.AcceptRunnable = nullptr;
+
+    if (Listener.ListeningSocket)
+    {
+        Listener.ListeningSocket->Close();
+        ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(Listener.ListeningSocket);
+        Listener.ListeningSocket = nullptr;
+    }
+    Listener.Connections.Empty();
+}
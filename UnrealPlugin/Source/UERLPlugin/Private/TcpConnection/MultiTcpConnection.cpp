@@ -3,6 +3,8 @@
 #include "SocketSubsystem.h"
 #include "TcpConnection/Threads/AcceptRunnable.h"
 #include "Misc/ScopeLock.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
 
 bool UMultiTcpConnection::StartListening(const FString& IPAddress, int32 Port)
 {
@@ -25,6 +27,14 @@ bool UMultiTcpConnection::StartListening(const FString& IPAddress, int32 Port)
             EnvSockets[i] = nullptr;
             PartialData[i] = TEXT("");
         }
+        NumConnectedEnvs = 0;
+        JoinedEnvs.Empty();
+    }
+
+    // Port is shared with other bridges, sockets are routed to us by bridge id
+    if (UsesSharedListener())
+    {
+        return StartSharedListening(IPAddress, Port);
     }
 
     // Build a listening socket just like USingleTcpConnection
@@ -78,14 +88,17 @@ bool UMultiTcpConnection::AcceptEnvConnection(FSocket* InNewSocket)
 
     // Assign new socket to this free slot
     EnvSockets[FreeIndex] = InNewSocket;
+    PartialData[FreeIndex] = TEXT("");
+    NumConnectedEnvs++;
+    JoinedEnvs.AddUnique(FreeIndex);
     UE_LOG(LogTemp, Log, TEXT("[UMultiTcpConnection] Accepted environment socket => EnvId=%d. (Array slot %d/%d filled)"),
         FreeIndex, FreeIndex + 1, NumEnvironments);
 
     // If that was the last free slot, we can stop accepting more
     if (AreAllEnvsAssigned() && AcceptRunnableRef.IsValid())
     {
-        UE_LOG(LogTemp, Log, TEXT("[UMultiTcpConnection] All env sockets assigned. Stopping accept thread."));
-        AcceptRunnableRef->Stop(); // This means no further AcceptConnection calls
+        UE_LOG(LogTemp, Log, TEXT("[UMultiTcpConnection] All env sockets assigned. Pausing accept thread."));
+        AcceptRunnableRef->Pause(); // No further AcceptConnection calls until a slot is vacated
     }
 
     return true;
@@ -129,6 +142,8 @@ bool UMultiTcpConnection::SendMessageEnv(const FString& Data)
     if (!bSuccess || BytesSent <= 0)
     {
         UE_LOG(LogTemp, Warning, TEXT("[UMultiTcpConnection] Failed to send data to EnvId=%d => %s"), EnvId, *DataWithStep);
+        // Worker is gone, free the slot so the bridge stops stepping this env
+        ReleaseEnvSocket(EnvId);
         return false;
     }
 
@@ -136,6 +151,36 @@ bool UMultiTcpConnection::SendMessageEnv(const FString& Data)
     return true;
 }
 
+bool UMultiTcpConnection::SendMessageEnvBinary(const FString& Header, TConstArrayView<uint8> Payload)
+{
+    int32 EnvId = ExtractEnvIdFromData(Header);
+    if (EnvId < 0)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("[UMultiTcpConnection] SendMessageEnvBinary: Could not parse ENV=%%d in => %s"), *Header);
+        return false;
+    }
+
+    TArray<uint8> Frame;
+    BuildBinaryFrame(Header, Payload, Frame);
+
+    FScopeLock Lock(&EnvSocketMutex);
+
+    if (EnvId >= EnvSockets.Num() || !EnvSockets[EnvId])
+    {
+        UE_LOG(LogTemp, Warning, TEXT("[UMultiTcpConnection] SendMessageEnvBinary: EnvId=%d is out of range or not connected."), EnvId);
+        return false;
+    }
+
+    if (!SendAllBytes(EnvSockets[EnvId], Frame))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("[UMultiTcpConnection] Failed to send binary data to EnvId=%d => %s"), EnvId, *Header);
+        ReleaseEnvSocket(EnvId);
+        return false;
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("[UMultiTcpConnection] Sent to EnvId=%d => %s (%d bytes)"), EnvId, *Header, Payload.Num());
+    return true;
+}
 
 FString UMultiTcpConnection::ReceiveMessageEnv(int32 BufSize)
 {
@@ -152,6 +197,12 @@ FString UMultiTcpConnection::ReceiveMessageEnv(int32 BufSize)
             {
                 continue;
             }
+            // A late joiner is read only after the bridge took its join through ConsumeJoinedEnvs() and reset the env,
+            // otherwise its first RESET could be handled before the join and then undone by it
+            if (JoinedEnvs.Contains(i))
+            {
+                continue;
+            }
             FString line = ReadFromSocket(i, EnvSock, BufSize);
             if (!line.IsEmpty()) {
                 // Env no longer added on Python side
@@ -175,8 +226,37 @@ FString UMultiTcpConnection::ReceiveMessageEnv(int32 BufSize)
     return Combined;
 }
 
+bool UMultiTcpConnection::WaitForEnvData(float TimeoutSeconds)
+{
+    const double Deadline = FPlatformTime::Seconds() + FMath::Max(TimeoutSeconds, 0.f);
+    do
+    {
+        {
+            FScopeLock Lock(&EnvSocketMutex);
+            for (int32 i = 0; i < EnvSockets.Num(); i++)
+            {
+                // same slots ReceiveMessageEnv() reads
+                if (!EnvSockets[i] || JoinedEnvs.Contains(i))
+                {
+                    continue;
+                }
+                int32 NewlineIdx;
+                uint32 Pending = 0;
+                if (PartialData[i].FindChar('\n', NewlineIdx) || (EnvSockets[i]->HasPendingData(Pending) && Pending > 0))
+                {
+                    return true;
+                }
+            }
+        }
+        FPlatformProcess::YieldThread();
+    }
+    while (FPlatformTime::Seconds() < Deadline);
+    return false;
+}
+
 void UMultiTcpConnection::CloseConnection()
 {
+    StopSharedListening();
     bStopAcceptThreadRef = true;
 
     if (AcceptRunnableRef.IsValid())
@@ -201,13 +281,8 @@ void UMultiTcpConnection::CloseConnection()
         ListeningSocket = nullptr;
     }
 
-    // admin
-    if (AdminSocket)
-    {
-        AdminSocket->Close();
-        SocketSubsystem->DestroySocket(AdminSocket);
-        AdminSocket = nullptr;
-    }
+    // admin, the accept thread is stopped so nothing assigns sockets anymore
+    CloseAdminSocket();
 
     // env
     {
@@ -223,6 +298,8 @@ void UMultiTcpConnection::CloseConnection()
         }
         EnvSockets.Empty();
         PartialData.Empty();
+        NumConnectedEnvs = 0;
+        JoinedEnvs.Empty();
     }
 
     UE_LOG(LogTemp, Log, TEXT("[UMultiTcpConnection] Closed sockets (admin + multi-env)."));
@@ -253,9 +330,35 @@ void UMultiTcpConnection::StartAcceptThread()
 bool UMultiTcpConnection::IsConnected() const
 {
     // We consider ourselves connected if admin is assigned and at all environments are connected.
+    // In partial mode any connected environment is enough to start stepping.
+    // the accept thread fills the admin and env slots and the counter under these locks
+    FScopeLock Lock(&SocketMutex);
+    if (bAdminOnly)
+    {
+        return AdminSocket != nullptr;
+    }
+    FScopeLock EnvLock(&EnvSocketMutex);
+    if (bAllowPartialConnections)
+    {
+        return AdminSocket && NumConnectedEnvs > 0;
+    }
     return AdminSocket && AreAllEnvsAssigned();
 }
 
+bool UMultiTcpConnection::IsEnvConnected(int32 EnvId) const
+{
+    FScopeLock Lock(&EnvSocketMutex);
+    return EnvSockets.IsValidIndex(EnvId) && EnvSockets[EnvId] != nullptr;
+}
+
+TArray<int32> UMultiTcpConnection::ConsumeJoinedEnvs()
+{
+    FScopeLock Lock(&EnvSocketMutex);
+    TArray<int32> Joined = MoveTemp(JoinedEnvs);
+    JoinedEnvs.Reset();
+    return Joined;
+}
+
 FString UMultiTcpConnection::ReadFromSocket(int32 EnvId, FSocket* EnvSocket, int32 BufSize)
 {
 
@@ -325,17 +428,42 @@ int32 UMultiTcpConnection::ExtractEnvIdFromData(const FString& Message) const
 // Helper: check if all env slots are assigned
 bool UMultiTcpConnection::AreAllEnvsAssigned() const
 {
-    // might wanna remove this later
-    // this means were looping through the entire array every single tick since
-    // probably really slows down performance (YIKES)
-    // maybe replace in future with a counter that checks how many envs are connnected
-    // or perodic heartbeats that check if envs are connected. (when recieving data)
-    for (FSocket* Sock : EnvSockets)
+    // Counter is updated on accept/release so we don't loop the socket array every tick
+    return EnvSockets.Num() > 0 && NumConnectedEnvs == EnvSockets.Num();
+}
+
+void UMultiTcpConnection::ReleaseEnvSocket(int32 EnvId)
+{
+    if (!EnvSockets.IsValidIndex(EnvId) || !EnvSockets[EnvId])
+    {
+        return;
+    }
+
+    EnvSockets[EnvId]->Close();
+    ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(EnvSockets[EnvId]);
+    EnvSockets[EnvId] = nullptr;
+    PartialData[EnvId] = TEXT("");
+    JoinedEnvs.Remove(EnvId);
+    NumConnectedEnvs--;
+
+    UE_LOG(LogTemp, Warning, TEXT("[UMultiTcpConnection] Released EnvId=%d. (%d/%d envs connected)"),
+        EnvId, NumConnectedEnvs, NumEnvironments);
+
+    // Let a worker reconnect into the vacated slot
+    RearmAcceptThread();
+}
+
+void UMultiTcpConnection::PollDisconnects()
+{
+    Super::PollDisconnects();
+
+    FScopeLock Lock(&EnvSocketMutex);
+    for (int32 i = 0; i < EnvSockets.Num(); i++)
     {
-        if (!Sock)
+        if (EnvSockets[i] && !IsSocketAlive(EnvSockets[i]))
         {
-            return false;
+            UE_LOG(LogTemp, Warning, TEXT("[UMultiTcpConnection] EnvId=%d disconnected."), i);
+            ReleaseEnvSocket(i);
         }
     }
-    return true;
 }
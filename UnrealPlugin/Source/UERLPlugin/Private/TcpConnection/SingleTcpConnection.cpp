@@ -2,6 +2,7 @@
 #include "SocketSubsystem.h"
 #include "Common/TcpSocketBuilder.h"
 #include "HAL/PlatformProcess.h"
+#include "Misc/ScopeLock.h"
 #include "TcpConnection/Threads/AcceptRunnable.h"
 
 bool USingleTcpConnection::StartListening(const FString& IPAddress, int32 Port)
@@ -15,6 +16,12 @@ bool USingleTcpConnection::StartListening(const FString& IPAddress, int32 Port)
         return false;
     }
 
+    // Port is shared with other bridges, sockets are routed to us by bridge id
+    if (UsesSharedListener())
+    {
+        return StartSharedListening(IPAddress, Port);
+    }
+
     // 2 connections: admin then single env
     ListeningSocket = FTcpSocketBuilder(TEXT("SingleEnvListener"))
         .AsReusable()
@@ -56,6 +63,7 @@ void USingleTcpConnection::StartAcceptThread()
 
 bool USingleTcpConnection::AcceptEnvConnection(FSocket* InNewSocket)
 {
+    FScopeLock Lock(&SocketMutex);
     if (EnvSocket)
     {
         UE_LOG(LogTemp, Warning, TEXT("[USingleTcpConnection] Already have env socket. Rejecting new."));
@@ -65,17 +73,21 @@ bool USingleTcpConnection::AcceptEnvConnection(FSocket* InNewSocket)
     }
 
     EnvSocket = InNewSocket;
+    PartialData.Empty();
+    bEnvJoined = true;
     UE_LOG(LogTemp, Log, TEXT("[USingleTcpConnection] Environment socket connected. Single env is ready."));
 
+    // Keep the thread alive so it can be re-armed if the env disconnects
     if (AcceptRunnableRef.IsValid())
     {
-        AcceptRunnableRef->Stop();
+        AcceptRunnableRef->Pause();
     }
     return true;
 }
 
 bool USingleTcpConnection::SendMessageEnv(const FString& Data)
 {
+    FScopeLock Lock(&SocketMutex);
     if (!EnvSocket)
     {
         UE_LOG(LogTemp, Warning, TEXT("[USingleTcpConnection] No env socket to send data."));
@@ -96,6 +108,7 @@ bool USingleTcpConnection::SendMessageEnv(const FString& Data)
     if (!bSuccess || BytesSent <= 0)
     {
         UE_LOG(LogTemp, Warning, TEXT("[USingleTcpConnection] Failed to send env data."));
+        ReleaseEnvSocket();
         return false;
     }
 
@@ -103,14 +116,43 @@ bool USingleTcpConnection::SendMessageEnv(const FString& Data)
     return true;
 }
 
+bool USingleTcpConnection::SendMessageEnvBinary(const FString& Header, TConstArrayView<uint8> Payload)
+{
+    FScopeLock Lock(&SocketMutex);
+    if (!EnvSocket)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("[USingleTcpConnection] No env socket to send data."));
+        return false;
+    }
+
+    TArray<uint8> Frame;
+    BuildBinaryFrame(Header, Payload, Frame);
+    if (!SendAllBytes(EnvSocket, Frame))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("[USingleTcpConnection] Failed to send binary env data."));
+        ReleaseEnvSocket();
+        return false;
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("[USingleTcpConnection] Sent to env => %s (%d bytes)"), *Header, Payload.Num());
+    return true;
+}
+
 FString USingleTcpConnection::ReceiveMessageEnv(int32 BufSize)
 {
+    FScopeLock Lock(&SocketMutex);
     if (!EnvSocket)
     {
         UE_LOG(LogTemp, Error, TEXT("Bridge: No connection socket available for receiving."));
         return TEXT("");
     }
 
+    // A (re)joined worker is read only after the bridge took the join and reset the env
+    if (bEnvJoined)
+    {
+        return TEXT("");
+    }
+
     // Read any new bytes into PartialData
     uint32 Pending = 0;
     if (EnvSocket->HasPendingData(Pending) && Pending > 0)
@@ -137,8 +179,30 @@ FString USingleTcpConnection::ReceiveMessageEnv(int32 BufSize)
     return TEXT("");
 }
 
+bool USingleTcpConnection::WaitForEnvData(float TimeoutSeconds)
+{
+    FSocket* Socket = nullptr;
+    {
+        FScopeLock Lock(&SocketMutex);
+        int32 NewlineIdx;
+        if (PartialData.FindChar('\n', NewlineIdx))
+        {
+            return true;
+        }
+        Socket = EnvSocket;
+    }
+    if (!Socket || TimeoutSeconds <= 0.f)
+    {
+        return false;
+    }
+
+    // Wait without the lock so the accept thread is not stalled, only the game thread frees the env socket
+    return Socket->Wait(ESocketWaitConditions::WaitForRead, FTimespan::FromSeconds(TimeoutSeconds));
+}
+
 void USingleTcpConnection::CloseConnection()
 {
+    StopSharedListening();
     bStopAcceptThreadRef = true;
 
     if (AcceptRunnableRef.IsValid())
@@ -162,21 +226,68 @@ void USingleTcpConnection::CloseConnection()
         ListeningSocket = nullptr;
     }
 
-    // admin
-    if (AdminSocket)
-    {
-        AdminSocket->Close();
-        SocketSubsystem->DestroySocket(AdminSocket);
-        AdminSocket = nullptr;
-    }
+    // admin, the accept thread is stopped so nothing assigns sockets anymore
+    CloseAdminSocket();
 
     // env
-    if (EnvSocket)
     {
-        EnvSocket->Close();
-        ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(EnvSocket);
-        EnvSocket = nullptr;
+        FScopeLock Lock(&SocketMutex);
+        if (EnvSocket)
+        {
+            EnvSocket->Close();
+            SocketSubsystem->DestroySocket(EnvSocket);
+            EnvSocket = nullptr;
+        }
+        PartialData.Empty();
     }
 
     UE_LOG(LogTemp, Log, TEXT("[USingleTcpConnection] Closed sockets (admin + env)."));
 }
+
+bool USingleTcpConnection::IsConnected() const
+{
+    FScopeLock Lock(&SocketMutex);
+    return AdminSocket != nullptr && EnvSocket != nullptr;
+}
+
+TArray<int32> USingleTcpConnection::ConsumeJoinedEnvs()
+{
+    FScopeLock Lock(&SocketMutex);
+    TArray<int32> Joined;
+    if (bEnvJoined && EnvSocket)
+    {
+        Joined.Add(0);
+    }
+    bEnvJoined = false;
+    return Joined;
+}
+
+void USingleTcpConnection::PollDisconnects()
+{
+    Super::PollDisconnects();
+
+    FScopeLock Lock(&SocketMutex);
+    if (EnvSocket && !IsSocketAlive(EnvSocket))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("[USingleTcpConnection] Env socket disconnected."));
+        ReleaseEnvSocket();
+    }
+}
+
+void USingleTcpConnection::ReleaseEnvSocket()
+{
+    FScopeLock Lock(&SocketMutex);
+    if (!EnvSocket)
+    {
+        return;
+    }
+
+    EnvSocket->Close();
+    ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(EnvSocket);
+    EnvSocket = nullptr;
+    PartialData.Empty();
+    bEnvJoined = false;
+
+    UE_LOG(LogTemp, Log, TEXT("[USingleTcpConnection] Released env socket, waiting for reconnect."));
+    RearmAcceptThread();
+}
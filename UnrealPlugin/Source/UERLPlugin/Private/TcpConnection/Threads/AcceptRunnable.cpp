@@ -8,6 +8,7 @@
 FAcceptRunnable::FAcceptRunnable(UBaseTcpConnection* InOwner)
     : Owner(InOwner)
     , bStop(false)
+    , bPaused(false)
 {
 }
 
@@ -17,11 +18,14 @@ uint32 FAcceptRunnable::Run()
 {
     while (!bStop && Owner && Owner->GetListeningSocket())
     {
-        bool bHasPending = false;
-        Owner->GetListeningSocket()->HasPendingConnection(bHasPending);
-        if (bHasPending)
+        if (!bPaused)
         {
-            Owner->AcceptConnection();
+            bool bHasPending = false;
+            Owner->GetListeningSocket()->HasPendingConnection(bHasPending);
+            if (bHasPending)
+            {
+                Owner->AcceptConnection();
+            }
         }
         FPlatformProcess::Sleep(0.1f);
     }
@@ -32,3 +36,13 @@ void FAcceptRunnable::Stop()
 {
     bStop = true;
 }
+
+void FAcceptRunnable::Pause()
+{
+    bPaused = true;
+}
+
+void FAcceptRunnable::Resume()
+{
+    bPaused = false;
+}
@@ -0,0 +1,127 @@
+#include "TcpConnection/Threads/SharedAcceptRunnable.h"
+#include "TcpConnection/BridgeConnectionSubsystem.h"
+#include "Sockets.h"
+#include "SocketSubsystem.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/Parse.h"
+
+namespace
+{
+    // A hello is short, anything longer is not one of our clients
+    constexpr int32 MaxHelloLength = 256;
+}
+
+FSharedAcceptRunnable::FSharedAcceptRunnable(UBridgeConnectionSubsystem* InOwner, FSocket* InListeningSocket, int32 InPort)
+    : Owner(InOwner)
+    , ListeningSocket(InListeningSocket)
+    , Port(InPort)
+    , bStop(false)
+{
+}
+
+FSharedAcceptRunnable::~FSharedAcceptRunnable() = default;
+
+uint32 FSharedAcceptRunnable::Run()
+{
+    ISocketSubsystem* SocketSubsystem = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM);
+
+    while (!bStop && Owner && ListeningSocket && SocketSubsystem)
+    {
+        bool bHasPending = false;
+        ListeningSocket->HasPendingConnection(bHasPending);
+        if (bHasPending)
+        {
+            TSharedRef<FInternetAddr> RemoteAddr = SocketSubsystem->CreateInternetAddr();
+            if (FSocket* NewSock = ListeningSocket->Accept(*RemoteAddr, TEXT("SharedBridgeSocket")))
+            {
+                FPendingHello& Pending = PendingHellos.AddDefaulted_GetRef();
+                Pending.Socket = NewSock;
+                Pending.AcceptTime = FPlatformTime::Seconds();
+            }
+        }
+
+        for (int32 i = PendingHellos.Num() - 1; i >= 0; i--)
+        {
+            FPendingHello& Pending = PendingHellos[i];
+            if (ReadHelloLine(Pending))
+            {
+                FString BridgeId;
+                const bool bValidHello = !Pending.bFailed
+                    && Pending.Line.StartsWith(TEXT("HELLO:"))
+                    && FParse::Value(*Pending.Line, TEXT("BRIDGE="), BridgeId);
+
+                if (!bValidHello || !Owner->RouteSocket(Port, BridgeId, Pending.Socket))
+                {
+                    UE_LOG(LogTemp, Warning, TEXT("[FSharedAcceptRunnable] Port %d: dropping connection with hello '%s'."), Port, *Pending.Line);
+                    DestroySocket(Pending.Socket);
+                }
+                PendingHellos.RemoveAtSwap(i);
+            }
+            else if (FPlatformTime::Seconds() - Pending.AcceptTime > UBridgeConnectionSubsystem::HelloTimeoutSeconds)
+            {
+                UE_LOG(LogTemp, Warning, TEXT("[FSharedAcceptRunnable] Port %d: no hello received in time, dropping connection."), Port);
+                DestroySocket(Pending.Socket);
+                PendingHellos.RemoveAtSwap(i);
+            }
+        }
+
+        // Poll faster while hellos are in flight
+        FPlatformProcess::Sleep(PendingHellos.Num() > 0 ? 0.01f : 0.1f);
+    }
+
+    for (FPendingHello& Pending : PendingHellos)
+    {
+        DestroySocket(Pending.Socket);
+    }
+    PendingHellos.Empty();
+    return 0;
+}
+
+void FSharedAcceptRunnable::Stop()
+{
+    bStop = true;
+}
+
+bool FSharedAcceptRunnable::ReadHelloLine(FPendingHello& Pending) const
+{
+    uint32 PendingSize = 0;
+    while (Pending.Socket->HasPendingData(PendingSize) && PendingSize > 0)
+    {
+        uint8 Byte = 0;
+        int32 BytesRead = 0;
+        if (!Pending.Socket->Recv(&Byte, 1, BytesRead) || BytesRead == 0)
+        {
+            Pending.bFailed = true;
+            return true;
+        }
+        if (Byte == '\n')
+        {
+            Pending.Line.TrimStartAndEndInline();
+            return true;
+        }
+        Pending.Line.AppendChar(static_cast<TCHAR>(Byte));
+        if (Pending.Line.Len() > MaxHelloLength)
+        {
+            Pending.bFailed = true;
+            return true;
+        }
+    }
+
+    // Peer hung up before finishing its hello
+    if (Pending.Socket->GetConnectionState() == SCS_ConnectionError)
+    {
+        Pending.bFailed = true;
+        return true;
+    }
+    return false;
+}
+
+void FSharedAcceptRunnable::DestroySocket(FSocket* Socket)
+{
+    if (Socket)
+    {
+        Socket->Close();
+        ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(Socket);
+    }
+}
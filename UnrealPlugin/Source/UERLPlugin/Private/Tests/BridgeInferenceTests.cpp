@@ -0,0 +1,111 @@
+#include "Tests/BridgeTestTypes.h"
+#include "Misc/AutomationTest.h"
+#include "UObject/Package.h"
+
+void UTestObservationSensor::GetObservationFields(TArray<FObservationField>& OutFields) const
+{
+    FObservationField& Field = OutFields.AddDefaulted_GetRef();
+    Field.Name = FieldName;
+    Field.Shape = { Values.Num() };
+}
+
+void UTestObservationSensor::WriteObservation(TArrayView<float> OutValues) const
+{
+    for (int32 i = 0; i < OutValues.Num(); i++)
+    {
+        OutValues[i] = Values.IsValidIndex(i) ? Values[i] : 0.f;
+    }
+}
+
+FString UTestCaptureInferenceInterface::RunInference(const TArray<float>& Observation)
+{
+    LastObservations = Observation;
+    TArray<FString> Actions;
+    Actions.Init(TEXT("0"), ActionSize);
+    return FString::Join(Actions, TEXT(","));
+}
+
+bool UTestCaptureInferenceInterface::RunInferenceBatch(TConstArrayView<int32> AgentIds, TConstArrayView<float> Observations, TArray<float>& OutActions)
+{
+    LastObservations = TArray<float>(Observations);
+    OutActions.Init(0.f, AgentIds.Num() * ActionSize);
+    return true;
+}
+
+FString UTestSingleEnvBridge::CreateStateString_Implementation()
+{
+    return TEXT("1,2");
+}
+
+FString UTestMultiEnvBridge::CreateStateStringForEnv_Implementation(int32 EnvId)
+{
+    return FString::Printf(TEXT("%d,1"), EnvId);
+}
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+    UTestObservationSensor* MakeTestSensor(TArray<float> Values)
+    {
+        UTestObservationSensor* Sensor = NewObject<UTestObservationSensor>(GetTransientPackage());
+        Sensor->Values = MoveTemp(Values);
+        return Sensor;
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSingleEnvInferenceSensorTest, "UERLPlugin.Bridges.Inference.SingleEnvSensorValues",
+    EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSingleEnvInferenceSensorTest::RunTest(const FString& Parameters)
+{
+    UTestSingleEnvBridge* Bridge = NewObject<UTestSingleEnvBridge>(GetTransientPackage());
+    UTestCaptureInferenceInterface* Interface = NewObject<UTestCaptureInferenceInterface>(GetTransientPackage());
+    Bridge->AddObservationSensor(MakeTestSensor({ 0.5f, -3.f, 7.f }), 0);
+    Bridge->SetInferenceInterface(Interface);
+    TestTrue(TEXT("Inference layout initialized"), Bridge->InitializeInference(1, 2));
+
+    Bridge->Tick(0.f);
+
+    // state values first, the sensor block after them, like the observations sent while training
+    const TArray<float> Expected = { 1.f, 2.f, 0.5f, -3.f, 7.f };
+    TestEqual(TEXT("Model input size"), Interface->LastObservations.Num(), Expected.Num());
+    for (int32 i = 0; i < FMath::Min(Expected.Num(), Interface->LastObservations.Num()); i++)
+    {
+        TestEqual(FString::Printf(TEXT("Model input %d"), i), Interface->LastObservations[i], Expected[i]);
+    }
+
+    // without a connection a training bridge stops ticking
+    Bridge->StartTraining();
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMultiEnvInferenceSensorTest, "UERLPlugin.Bridges.Inference.MultiEnvSensorValues",
+    EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FMultiEnvInferenceSensorTest::RunTest(const FString& Parameters)
+{
+    UTestMultiEnvBridge* Bridge = NewObject<UTestMultiEnvBridge>(GetTransientPackage());
+    UTestCaptureInferenceInterface* Interface = NewObject<UTestCaptureInferenceInterface>(GetTransientPackage());
+    Bridge->InitializeEnvironments(2, true);
+    Bridge->AddObservationSensor(MakeTestSensor({ 0.5f, -3.f }), 0);
+    Bridge->AddObservationSensor(MakeTestSensor({ 4.f, 8.f }), 1);
+    Bridge->SetInferenceInterface(Interface);
+    TestTrue(TEXT("Inference layout initialized"), Bridge->InitializeInference(1, 2));
+
+    Bridge->Tick(0.f);
+
+    // one batch with a row per env, each row carries its own env's sensor values
+    const TArray<float> Expected = { 0.f, 1.f, 0.5f, -3.f, 1.f, 1.f, 4.f, 8.f };
+    TestEqual(TEXT("Batch input size"), Interface->LastObservations.Num(), Expected.Num());
+    for (int32 i = 0; i < FMath::Min(Expected.Num(), Interface->LastObservations.Num()); i++)
+    {
+        TestEqual(FString::Printf(TEXT("Batch input %d"), i), Interface->LastObservations[i], Expected[i]);
+    }
+
+    // without a connection a training bridge stops ticking
+    Bridge->StartTraining();
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
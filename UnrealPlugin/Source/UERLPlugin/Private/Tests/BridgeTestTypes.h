@@ -0,0 +1,58 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Sensors/ObservationSensorComponent.h"
+#include "Inference/InferenceInterfaces/InferenceInterface.h"
+#include "TrainingBridges/SingleEnvironment/SingleEnvBridge.h"
+#include "TrainingBridges/MultiEnvironment/MultiEnvBridge.h"
+#include "BridgeTestTypes.generated.h"
+
+/** Sensor reporting fixed Values as one float field, used by the bridge automation tests. */
+UCLASS(Transient, NotBlueprintable)
+class UTestObservationSensor : public UObservationSensorComponent
+{
+    GENERATED_BODY()
+
+public:
+    TArray<float> Values;
+
+    virtual void GetObservationFields(TArray<FObservationField>& OutFields) const override;
+    virtual void WriteObservation(TArrayView<float> OutValues) const override;
+};
+
+/** Inference interface that keeps the observations it was run on and answers with zero actions. */
+UCLASS(Transient, NotBlueprintable)
+class UTestCaptureInferenceInterface : public UInferenceInterface
+{
+    GENERATED_BODY()
+
+public:
+    /** Observations of the last run, agent-major. */
+    TArray<float> LastObservations;
+
+    /** Actions per agent returned by every run. */
+    int32 ActionSize = 1;
+
+    virtual FString RunInference(const TArray<float>& Observation) override;
+    virtual bool RunInferenceBatch(TConstArrayView<int32> AgentIds, TConstArrayView<float> Observations, TArray<float>& OutActions) override;
+};
+
+/** Single env bridge whose state string is "1,2". */
+UCLASS(Transient, NotBlueprintable)
+class UTestSingleEnvBridge : public USingleEnvBridge
+{
+    GENERATED_BODY()
+
+protected:
+    virtual FString CreateStateString_Implementation() override;
+};
+
+/** Multi env bridge whose state string is "<EnvId>,1". */
+UCLASS(Transient, NotBlueprintable)
+class UTestMultiEnvBridge : public UMultiEnvBridge
+{
+    GENERATED_BODY()
+
+protected:
+    virtual FString CreateStateStringForEnv_Implementation(int32 EnvId) override;
+};
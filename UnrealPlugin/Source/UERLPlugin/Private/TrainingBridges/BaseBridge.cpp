@@ -1,11 +1,22 @@
-
+﻿
 #include "TrainingBridges/BaseBridge.h"
 #include "UERLPlugin/Helpers/BPFL_DataHelpers.h"
+#include "UERLPlugin/Helpers/BPFL_PackingHelpers.h"
+#include "Sensors/ObservationSensorComponent.h"
+#include "Misc/App.h"
+#include "Engine/Engine.h"
+#include "Engine/GameViewportClient.h"
+#include "AudioDevice.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
 
 bool UBaseBridge::Connect_Implementation(const FString& IPAddress, int32 Port, int32 InActionSpaceSize, int32 InObservationSpaceSize)
 {
-    ActionSpaceSize = InActionSpaceSize;
-    ObservationSpaceSize = InObservationSpaceSize;
+    if (!InitializeObservationLayout(InActionSpaceSize, InObservationSpaceSize))
+    {
+        return false;
+    }
 
     if (!TcpConnection)
     {
@@ -15,7 +26,21 @@ bool UBaseBridge::Connect_Implementation(const FString& IPAddress, int32 Port, i
             UE_LOG(LogTemp, Error, TEXT("[UBaseBridge] CreateTcpConnection returned null. Please override CreateTcpConnection in C++ or Blueprint."));
             return false;
         }
-        TcpConnection->SetHandshake(BuildHandshake());
+        FString Handshake = BuildHandshake();
+        if (UsesObservationSchema())
+        {
+            Handshake += ObservationSchema.ToHandshakeString();
+        }
+        if (UsesFrameStack())
+        {
+            Handshake += FString::Printf(TEXT(";FRAME_STACK=%d"), FrameStackDepth);
+        }
+        if (UsesObservationNormalization())
+        {
+            Handshake += FString::Printf(TEXT(";OBS_NORM=%g"), ObservationClip);
+        }
+        TcpConnection->SetHandshake(Handshake);
+        TcpConnection->SetSharedBridgeId(SharedBridgeId);
     }
 
     if (!TcpConnection->StartListening(IPAddress, Port))
@@ -27,8 +52,278 @@ bool UBaseBridge::Connect_Implementation(const FString& IPAddress, int32 Port, i
     return true;
 }
 
+bool UBaseBridge::InitializeInference(int32 InActionSpaceSize, int32 InObservationSpaceSize)
+{
+    if (!InitializeObservationLayout(InActionSpaceSize, InObservationSpaceSize))
+    {
+        return false;
+    }
+    StartInference();
+    return true;
+}
+
+bool UBaseBridge::InitializeObservationLayout(int32 InActionSpaceSize, int32 InObservationSpaceSize)
+{
+    ActionSpaceSize = InActionSpaceSize;
+    ObservationSpaceSize = InObservationSpaceSize;
+
+    const int32 NumSensorValues = ApplyObservationSensors();
+
+    if (!ObservationSchema.IsEmpty())
+    {
+        FString SchemaError;
+        if (SupportsObservationSchema() && !ObservationSchema.Validate(SchemaError))
+        {
+            UE_LOG(LogTemp, Error, TEXT("[UBaseBridge] Invalid observation schema: %s"), *SchemaError);
+            return false;
+        }
+
+        if (!SupportsObservationSchema())
+        {
+            UE_LOG(LogTemp, Warning, TEXT("[UBaseBridge] %s does not support observation schemas, sending plain observations."), *GetClass()->GetName());
+        }
+        else if (ObservationSchema.GetNumObservationValues() != ObservationSpaceSize)
+        {
+            // the schema is the source of truth for the packed layout
+            UE_LOG(LogTemp, Warning, TEXT("[UBaseBridge] Observation size %d does not match schema (%d values), using the schema."),
+                ObservationSpaceSize, ObservationSchema.GetNumObservationValues());
+            ObservationSpaceSize = ObservationSchema.GetNumObservationValues();
+        }
+
+        if (SupportsObservationSchema() && ObservationSchema.ActionHeads.Num() > 0 && ObservationSchema.GetNumActionValues() != ActionSpaceSize)
+        {
+            // Python sizes the action string from ACT_SCHEMA, the heads win here too
+            UE_LOG(LogTemp, Warning, TEXT("[UBaseBridge] Action size %d does not match action heads (%d values), using the heads."),
+                ActionSpaceSize, ObservationSchema.GetNumActionValues());
+            ActionSpaceSize = ObservationSchema.GetNumActionValues();
+        }
+    }
+    StateObservationSize = FMath::Max(ObservationSpaceSize - NumSensorValues, 0);
+
+    if (UsesFrameStack())
+    {
+        FrameStack.Initialize(GetNumObservationRows(), ObservationSpaceSize, FrameStackDepth);
+    }
+    else if (FrameStackDepth > 1)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("[UBaseBridge] %s does not support frame stacking, sending single frames."), *GetClass()->GetName());
+    }
+
+    if (UsesObservationNormalization())
+    {
+        ObservationNormalizer.Initialize(GetNumObservationRows(), StateObservationSize, ObservationClip, NormalizationEpsilon);
+
+        // normalized values are packed with the dtype of their field, integer fields would truncate them
+        int32 FieldOffset = 0;
+        for (int32 i = 0; UsesObservationSchema() && i < ObservationSchema.Fields.Num() && FieldOffset < StateObservationSize; i++)
+        {
+            const FObservationField& Field = ObservationSchema.Fields[i];
+            if (Field.DType != EObservationDType::Float32 && Field.DType != EObservationDType::Float16)
+            {
+                UE_LOG(LogTemp, Warning, TEXT("[UBaseBridge] Normalized field '%s' is packed as %s, use a float dtype."),
+                    *Field.Name, FObservationSchema::DTypeToString(Field.DType));
+            }
+            FieldOffset += Field.GetNumElements();
+        }
+    }
+    else if (bNormalizeObservations)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("[UBaseBridge] %s does not support observation normalization, sending raw observations."), *GetClass()->GetName());
+    }
+    return true;
+}
+
+bool UBaseBridge::SendPackedObservation(const FString& Header, TConstArrayView<TConstArrayView<float>> Observations)
+{
+    if (!TcpConnection || !TcpConnection->IsConnected())
+    {
+        UE_LOG(LogTemp, Error, TEXT("[UBaseBridge] SendPackedObservation: No valid TCP connection."));
+        return false;
+    }
+
+    PackedObservationBuffer.Reset();
+    const int32 FrameSize = FMath::Max(ObservationSpaceSize, 1);
+    for (TConstArrayView<float> Observation : Observations)
+    {
+        // stacked observations hold several frames, each is packed on its own
+        for (int32 Offset = 0; Offset < Observation.Num(); Offset += FrameSize)
+        {
+            UBPFL_PackingHelpers::PackObservationAppend(ObservationSchema, Observation.Slice(Offset, FMath::Min(FrameSize, Observation.Num() - Offset)), PackedObservationBuffer);
+        }
+    }
+    return TcpConnection->SendMessageEnvBinary(Header, PackedObservationBuffer);
+}
+
+void UBaseBridge::AddObservationSensor(UObservationSensorComponent* Sensor, int32 EnvId)
+{
+    if (!Sensor)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("[UBaseBridge] AddObservationSensor: Sensor is null."));
+        return;
+    }
+    if (TcpConnection)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("[UBaseBridge] AddObservationSensor: %s added after Connect(), it is ignored until reconnect."), *Sensor->GetName());
+    }
+
+    ObservationSensors.Add(Sensor);
+    ObservationSensorEnvIds.Add(EnvId);
+    ObservationSensorSizes.Add(0);
+    ObservationSensorFieldCounts.Add(0);
+}
+
+int32 UBaseBridge::ApplyObservationSensors()
+{
+    // drop the sensor fields appended by an earlier Connect()
+    if (NumConfiguredSchemaFields != INDEX_NONE)
+    {
+        ObservationSchema.Fields.SetNum(NumConfiguredSchemaFields);
+        NumConfiguredSchemaFields = INDEX_NONE;
+    }
+    NumSensorSchemaFields = 0;
+    if (!HasObservationSensors())
+    {
+        return 0;
+    }
+
+    // the first registered env defines the layout, sizes are cached so writes don't query fields
+    const int32 LayoutEnvId = ObservationSensorEnvIds[0];
+    TArray<FObservationField> SensorFields;
+    TArray<FObservationField> OwnFields;
+    for (int32 i = 0; i < ObservationSensors.Num(); i++)
+    {
+        OwnFields.Reset();
+        if (ObservationSensors[i])
+        {
+            ObservationSensors[i]->GetObservationFields(OwnFields);
+        }
+        ObservationSensorSizes[i] = 0;
+        for (const FObservationField& Field : OwnFields)
+        {
+            ObservationSensorSizes[i] += Field.GetNumElements();
+        }
+        ObservationSensorFieldCounts[i] = OwnFields.Num();
+        if (ObservationSensorEnvIds[i] == LayoutEnvId)
+        {
+            SensorFields.Append(OwnFields);
+        }
+    }
+
+    int32 NumSensorValues = 0;
+    for (const FObservationField& Field : SensorFields)
+    {
+        NumSensorValues += Field.GetNumElements();
+    }
+
+    if (!SupportsObservationSchema())
+    {
+        ObservationSpaceSize += NumSensorValues;
+        return NumSensorValues;
+    }
+
+    NumConfiguredSchemaFields = ObservationSchema.Fields.Num();
+    if (ObservationSchema.IsEmpty())
+    {
+        // state string values become a float field ahead of the sensor fields
+        if (ObservationSpaceSize > 0)
+        {
+            FObservationField& StateField = ObservationSchema.Fields.AddDefaulted_GetRef();
+            StateField.Name = TEXT("state");
+            StateField.Shape = { ObservationSpaceSize };
+        }
+    }
+    else
+    {
+        ObservationSpaceSize = ObservationSchema.GetNumObservationValues();
+    }
+    ObservationSchema.Fields.Append(SensorFields);
+    NumSensorSchemaFields = SensorFields.Num();
+    ObservationSpaceSize += NumSensorValues;
+    return NumSensorValues;
+}
+
+bool UBaseBridge::SendPackedSensorObservation(int32 EnvId, const FString& Header, TConstArrayView<float> StateObservation)
+{
+    if (!TcpConnection || !TcpConnection->IsConnected())
+    {
+        UE_LOG(LogTemp, Error, TEXT("[UBaseBridge] SendPackedSensorObservation: No valid TCP connection."));
+        return false;
+    }
+
+    const TConstArrayView<FObservationField> Fields(ObservationSchema.Fields);
+    const int32 NumStateFields = Fields.Num() - NumSensorSchemaFields;
+
+    PackedObservationBuffer.Reset();
+    PackedObservationBuffer.AddUninitialized(ObservationSchema.GetPackedObservationBytes());
+    uint8* Dest = PackedObservationBuffer.GetData();
+
+    auto PackedSize = [](TConstArrayView<FObservationField> InFields)
+    {
+        int32 NumBytes = 0;
+        for (const FObservationField& Field : InFields)
+        {
+            NumBytes += Field.GetNumElements() * Field.GetElementSize();
+        }
+        return NumBytes;
+    };
+
+    const TConstArrayView<FObservationField> StateFields = Fields.Slice(0, NumStateFields);
+    const int32 NumStateBytes = PackedSize(StateFields);
+    UBPFL_PackingHelpers::PackFieldsInto(StateFields, StateObservation, TArrayView<uint8>(Dest, NumStateBytes));
+    Dest += NumStateBytes;
+
+    // sensors of every env mirror the layout env, so they take the sensor fields in registration order
+    int32 FieldIdx = NumStateFields;
+    for (int32 i = 0; i < ObservationSensors.Num() && FieldIdx < Fields.Num(); i++)
+    {
+        if (ObservationSensorEnvIds[i] != EnvId || !ObservationSensors[i])
+        {
+            continue;
+        }
+
+        const TConstArrayView<FObservationField> SensorFields = Fields.Slice(FieldIdx, FMath::Min(ObservationSensorFieldCounts[i], Fields.Num() - FieldIdx));
+        const TArrayView<uint8> SensorBytes(Dest, PackedSize(SensorFields));
+        if (!ObservationSensors[i]->WritePackedObservation(SensorBytes))
+        {
+            SensorObservationScratch.SetNumUninitialized(ObservationSensorSizes[i]);
+            ObservationSensors[i]->WriteObservation(SensorObservationScratch);
+            UBPFL_PackingHelpers::PackFieldsInto(SensorFields, SensorObservationScratch, SensorBytes);
+        }
+        FieldIdx += SensorFields.Num();
+        Dest += SensorBytes.Num();
+    }
+
+    // fields without a sensor in this env are sent as zeros
+    FMemory::Memzero(Dest, PackedObservationBuffer.GetData() + PackedObservationBuffer.Num() - Dest);
+    return TcpConnection->SendMessageEnvBinary(Header, PackedObservationBuffer);
+}
+
+void UBaseBridge::WriteSensorObservations(int32 EnvId, TArrayView<float> OutObservation) const
+{
+    int32 Offset = StateObservationSize;
+    for (int32 i = 0; i < ObservationSensors.Num(); i++)
+    {
+        if (ObservationSensorEnvIds[i] != EnvId || !ObservationSensors[i])
+        {
+            continue;
+        }
+
+        const int32 NumValues = ObservationSensorSizes[i];
+        if (Offset + NumValues > OutObservation.Num())
+        {
+            UE_LOG(LogTemp, Verbose, TEXT("[UBaseBridge] EnvId=%d sensors exceed the observation size %d."), EnvId, OutObservation.Num());
+            return;
+        }
+        ObservationSensors[i]->WriteObservation(OutObservation.Slice(Offset, NumValues));
+        Offset += NumValues;
+    }
+}
+
 void UBaseBridge::Disconnect()
 {
+    DisableTrainingTurbo();
+    DisableFixedTimestep();
+
     if (TcpConnection)
     {
         TcpConnection->CloseConnection();
@@ -71,8 +366,239 @@ FString UBaseBridge::RunLocalModelInference(const FString& Observation)
         UE_LOG(LogTemp, Warning, TEXT("[UBaseBridge] No InferenceInterface set."));
         return TEXT("");
     }
-    TArray<float> Parsed = UBPFL_DataHelpers::ParseStateString(Observation);
-    return InferenceInterface->RunInference(Parsed);
+    TArray<float> Parsed;
+    if (HasObservationSensors() && ObservationSpaceSize > StateObservationSize)
+    {
+        // the layout training sends: state values, then the sensor blocks of env 0
+        Parsed.SetNumZeroed(ObservationSpaceSize);
+        UBPFL_DataHelpers::ParseStateStringInto(Observation, TArrayView<float>(Parsed).Left(StateObservationSize));
+        WriteSensorObservations(0, Parsed);
+    }
+    else
+    {
+        Parsed = UBPFL_DataHelpers::ParseStateString(Observation);
+    }
+    if (UsesObservationNormalization() && ObservationNormalizer.IsInitialized())
+    {
+        // the statistics the policy was trained with, inference never updates them
+        ObservationNormalizer.NormalizeReadOnly(Parsed);
+    }
+    if (!UsesFrameStack())
+    {
+        return InferenceInterface->RunInference(Parsed);
+    }
+
+    // the model sees the same stacked layout as Python did during training
+    if (InferenceFrameStack.GetFrameSize() != Parsed.Num() || InferenceFrameStack.GetDepth() != FrameStackDepth)
+    {
+        InferenceFrameStack.Initialize(1, Parsed.Num(), FrameStackDepth);
+    }
+    const int32 AgentIds[] = { 0 };
+    if (!InferenceInterface->RunInferenceBatch(AgentIds, InferenceFrameStack.Push(0, Parsed), InferenceActionScratch))
+    {
+        return TEXT("");
+    }
+    return UBPFL_DataHelpers::ArrayToStateString(InferenceActionScratch, 2);
+}
+
+bool UBaseBridge::ExportNormalizationStats(const FString& FilePath) const
+{
+    if (!ObservationNormalizer.IsInitialized())
+    {
+        UE_LOG(LogTemp, Warning, TEXT("[UBaseBridge] ExportNormalizationStats: No statistics yet, connect with bNormalizeObservations first."));
+        return false;
+    }
+    if (!FFileHelper::SaveStringToFile(ObservationNormalizer.ToString(), *FilePath))
+    {
+        UE_LOG(LogTemp, Error, TEXT("[UBaseBridge] ExportNormalizationStats: Failed to write %s"), *FilePath);
+        return false;
+    }
+    return true;
+}
+
+bool UBaseBridge::ImportNormalizationStats(const FString& FilePath)
+{
+    FString Text;
+    if (!FFileHelper::LoadFileToString(Text, *FilePath))
+    {
+        UE_LOG(LogTemp, Error, TEXT("[UBaseBridge] ImportNormalizationStats: Failed to read %s"), *FilePath);
+        return false;
+    }
+    if (!ObservationNormalizer.FromString(Text))
+    {
+        return false;
+    }
+
+    // keep the properties in sync so a later Connect() does not override the imported settings
+    ObservationClip = ObservationNormalizer.GetClip() < TNumericLimits<float>::Max() ? ObservationNormalizer.GetClip() : 0.f;
+    NormalizationEpsilon = ObservationNormalizer.GetEpsilon();
+    UE_LOG(LogTemp, Log, TEXT("[UBaseBridge] Imported normalization statistics of %d values (count %.0f)."),
+        ObservationNormalizer.GetSize(), ObservationNormalizer.GetCount());
+    return true;
+}
+
+void UBaseBridge::ResetNormalizationStats()
+{
+    ObservationNormalizer.ResetStatistics();
+}
+
+void UBaseBridge::ResetInferenceState(int32 AgentId)
+{
+    if (InferenceInterface)
+    {
+        InferenceInterface->ResetState(AgentId);
+    }
+    if (AgentId < 0)
+    {
+        InferenceFrameStack.ResetAll();
+    }
+    else
+    {
+        InferenceFrameStack.ResetRow(AgentId);
+    }
+}
+
+void UBaseBridge::EnableFixedTimestep(float InFixedDeltaTime, int32 InSubStepsPerAction, bool bInDisableRendering)
+{
+    if (InFixedDeltaTime <= 0.f)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("[UBaseBridge] EnableFixedTimestep: delta must be positive, got %f."), InFixedDeltaTime);
+        return;
+    }
+
+    if (!bUseFixedTimestep)
+    {
+        bPrevUseFixedTimeStep = FApp::UseFixedTimeStep();
+        PrevFixedDeltaTime = FApp::GetFixedDeltaTime();
+    }
+
+    bUseFixedTimestep = true;
+    FixedDeltaTime = InFixedDeltaTime;
+    SubStepsPerAction = FMath::Max(InSubStepsPerAction, 0);
+
+    // Every engine frame now simulates exactly FixedDeltaTime, independent of wall clock
+    FApp::SetUseFixedTimeStep(true);
+    FApp::SetFixedDeltaTime(FixedDeltaTime);
+
+    // Sub-steps are never looked at, skip drawing the world (viewport may not exist on a headless server)
+    if (bInDisableRendering && GEngine && GEngine->GameViewport)
+    {
+        GEngine->GameViewport->bDisableWorldRendering = true;
+        bDisabledRendering = true;
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("[UBaseBridge] Fixed timestep enabled: dt=%f, %d sub-step(s) per action."), FixedDeltaTime, SubStepsPerAction);
+}
+
+void UBaseBridge::DisableFixedTimestep()
+{
+    if (!bUseFixedTimestep)
+    {
+        return;
+    }
+
+    FApp::SetUseFixedTimeStep(bPrevUseFixedTimeStep);
+    FApp::SetFixedDeltaTime(PrevFixedDeltaTime);
+
+    if (bDisabledRendering && GEngine && GEngine->GameViewport)
+    {
+        GEngine->GameViewport->bDisableWorldRendering = false;
+    }
+
+    bDisabledRendering = false;
+    bUseFixedTimestep = false;
+    SubStepsPerAction = 0;
+}
+
+void UBaseBridge::EnableTrainingTurbo(float InFixedDeltaTime, int32 InSubStepsPerAction, int32 InMaxStepsPerFrame)
+{
+    EnableFixedTimestep(InFixedDeltaTime, InSubStepsPerAction, true);
+    if (!bUseFixedTimestep)
+    {
+        return;
+    }
+
+    IConsoleVariable* MaxFPSVar = IConsoleManager::Get().FindConsoleVariable(TEXT("t.MaxFPS"));
+    IConsoleVariable* VSyncVar = IConsoleManager::Get().FindConsoleVariable(TEXT("r.VSync"));
+
+    if (!bTrainingTurbo)
+    {
+        PrevMaxFPS = MaxFPSVar ? MaxFPSVar->GetFloat() : 0.f;
+        PrevVSync = VSyncVar ? VSyncVar->GetInt() : 0;
+        bPrevSmoothFrameRate = GEngine ? GEngine->bSmoothFrameRate : false;
+        bPrevBenchmarking = FApp::IsBenchmarking();
+        FAudioDeviceHandle AudioDevice = GEngine ? GEngine->GetMainAudioDevice() : FAudioDeviceHandle();
+        bPrevAudioMuted = AudioDevice ? AudioDevice->IsAudioDeviceMuted() : false;
+    }
+
+    bTrainingTurbo = true;
+    MaxStepsPerFrame = FMath::Max(InMaxStepsPerFrame, 1);
+
+    // Benchmarking + fixed timestep makes the engine advance time by the fixed delta without waiting on the wall clock
+    FApp::SetBenchmarking(true);
+    if (MaxFPSVar)
+    {
+        MaxFPSVar->Set(0.f, ECVF_SetByCode);
+    }
+    if (VSyncVar)
+    {
+        VSyncVar->Set(0, ECVF_SetByCode);
+    }
+    if (GEngine)
+    {
+        GEngine->bSmoothFrameRate = false;
+
+        FAudioDeviceHandle AudioDevice = GEngine->GetMainAudioDevice();
+        if (AudioDevice)
+        {
+            AudioDevice->SetDeviceMuted(true);
+        }
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("[UBaseBridge] Training turbo enabled: up to %d step(s) per frame."), MaxStepsPerFrame);
+}
+
+void UBaseBridge::DisableTrainingTurbo()
+{
+    if (!bTrainingTurbo)
+    {
+        return;
+    }
+
+    FApp::SetBenchmarking(bPrevBenchmarking);
+    if (IConsoleVariable* MaxFPSVar = IConsoleManager::Get().FindConsoleVariable(TEXT("t.MaxFPS")))
+    {
+        MaxFPSVar->Set(PrevMaxFPS, ECVF_SetByCode);
+    }
+    if (IConsoleVariable* VSyncVar = IConsoleManager::Get().FindConsoleVariable(TEXT("r.VSync")))
+    {
+        VSyncVar->Set(PrevVSync, ECVF_SetByCode);
+    }
+    if (GEngine)
+    {
+        GEngine->bSmoothFrameRate = bPrevSmoothFrameRate;
+
+        FAudioDeviceHandle AudioDevice = GEngine->GetMainAudioDevice();
+        if (AudioDevice)
+        {
+            AudioDevice->SetDeviceMuted(bPrevAudioMuted);
+        }
+    }
+
+    bTrainingTurbo = false;
+    MaxStepsPerFrame = 1;
+    DisableFixedTimestep();
+}
+
+uint64 UBaseBridge::GetActionReadyFrame() const
+{
+    // Actions are applied after the world ticked this frame, so N sub-steps end N frames from now
+    return GFrameCounter + (bUseFixedTimestep ? SubStepsPerAction : 0);
+}
+
+bool UBaseBridge::IsHoldingAction(uint64 ActionReadyFrame) const
+{
+    return GFrameCounter < ActionReadyFrame;
 }
 
 void UBaseBridge::UpdateRL_Implementation(float)
@@ -108,7 +634,148 @@ UBaseTcpConnection* UBaseBridge::CreateTcpConnection_Implementation()
 
 void UBaseBridge::Tick(float DeltaTime)
 {
-    UpdateRL(DeltaTime);
+    // Detect dropped workers before stepping so dead sockets are never read from.
+    // Reconnected workers are picked up by the bridge through ConsumeJoinedEnvs().
+    if (bIsTraining && TcpConnection)
+    {
+        TcpConnection->PollDisconnects();
+        if (!TcpConnection->IsConnected())
+        {
+            return;
+        }
+    }
+
+    PollAdminMessages();
+
+    // Outside turbo this runs exactly once. In turbo keep stepping within the frame
+    // as long as each update answered a request (actions completed instantly).
+    const int32 MaxCycles = (bTrainingTurbo && bIsTraining) ? MaxStepsPerFrame : 1;
+    for (int32 Cycle = 0; Cycle < MaxCycles; ++Cycle)
+    {
+        bStepCompletedThisUpdate = false;
+        UpdateRL(Cycle == 0 ? DeltaTime : 0.f);
+
+        // the next cycle can only step once Python answered the observations just sent, wait for them briefly
+        if (!bStepCompletedThisUpdate || Cycle + 1 >= MaxCycles || !TcpConnection
+            || !TcpConnection->WaitForEnvData(TurboActionWaitSeconds))
+        {
+            break;
+        }
+    }
+}
+
+void UBaseBridge::PollAdminMessages()
+{
+    if (TcpConnection)
+    {
+        FAdminFrame Frame;
+        while (TcpConnection->ReceiveAdminFrame(Frame))
+        {
+            HandleAdminFrame(Frame);
+        }
+    }
+
+    int32 Version = INDEX_NONE;
+    const EPendingModelResult Result = InferenceInterface ? InferenceInterface->ApplyPendingModel(Version) : EPendingModelResult::None;
+    if (Result == EPendingModelResult::Loaded)
+    {
+        PolicyVersion = Version;
+        UE_LOG(LogTemp, Log, TEXT("[UBaseBridge] Acting with streamed policy version %d"), PolicyVersion);
+        if (TcpConnection)
+        {
+            TcpConnection->SendMessageAdmin(FString::Printf(TEXT("MODEL_LOADED:VERSION=%d"), PolicyVersion));
+        }
+    }
+    else if (Result == EPendingModelResult::Failed)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("[UBaseBridge] Streamed policy version %d failed to build, still acting with version %d"), Version, PolicyVersion);
+        SendModelFailed(Version);
+    }
+}
+
+void UBaseBridge::SendModelFailed(int32 Version)
+{
+    if (TcpConnection)
+    {
+        TcpConnection->SendMessageAdmin(FString::Printf(TEXT("MODEL_FAILED:VERSION=%d"), Version));
+    }
+}
+
+void UBaseBridge::HandleAdminFrame(const FAdminFrame& Frame)
+{
+    if (Frame.Header.StartsWith(TEXT("MODEL_CHUNK:")))
+    {
+        ReceiveModelChunk(Frame);
+        return;
+    }
+    UE_LOG(LogTemp, Warning, TEXT("[UBaseBridge] Ignoring admin message => %s"), *Frame.Header);
+}
+
+void UBaseBridge::ReceiveModelChunk(const FAdminFrame& Frame)
+{
+    int32 Version = 0;
+    int32 Offset = 0;
+    int32 TotalSize = 0;
+    if (!FParse::Value(*Frame.Header, TEXT("VERSION="), Version) || !FParse::Value(*Frame.Header, TEXT("OFFSET="), Offset)
+        || !FParse::Value(*Frame.Header, TEXT("TOTAL="), TotalSize) || TotalSize <= 0)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("[UBaseBridge] Malformed model chunk => %s"), *Frame.Header);
+        return;
+    }
+
+    // TOTAL comes from the wire, refuse it before reserving anything for it
+    const int64 MaxSize = FMath::Clamp<int64>(MaxStreamedModelSizeMB, 1, 2047) * 1024 * 1024;
+    if (TotalSize > MaxSize)
+    {
+        if (Offset == 0 || Version == StreamedModelVersion)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("[UBaseBridge] Streamed model %d holds %d bytes, more than MaxStreamedModelSizeMB (%d)."),
+                Version, TotalSize, MaxStreamedModelSizeMB);
+            StreamedModelBytes.Empty();
+            StreamedModelVersion = INDEX_NONE;
+            SendModelFailed(Version);
+        }
+        return;
+    }
+
+    // the first chunk starts a model, a chunk that doesn't continue it drops the partial model
+    if (Offset == 0)
+    {
+        StreamedModelBytes.Reset(TotalSize);
+        StreamedModelVersion = Version;
+    }
+    else if (Version != StreamedModelVersion || Offset != StreamedModelBytes.Num())
+    {
+        UE_LOG(LogTemp, Warning, TEXT("[UBaseBridge] Model chunk of version %d at offset %d does not continue version %d at %d, dropping it."),
+            Version, Offset, StreamedModelVersion, StreamedModelBytes.Num());
+        StreamedModelBytes.Reset();
+        StreamedModelVersion = INDEX_NONE;
+        return;
+    }
+
+    StreamedModelBytes.Append(Frame.Payload);
+    if (StreamedModelBytes.Num() < TotalSize)
+    {
+        return;
+    }
+
+    const bool bComplete = StreamedModelBytes.Num() == TotalSize;
+    if (!bComplete)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("[UBaseBridge] Streamed model %d holds %d bytes, expected %d."), Version, StreamedModelBytes.Num(), TotalSize);
+        SendModelFailed(Version);
+    }
+    else if (!InferenceInterface)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("[UBaseBridge] No InferenceInterface to load streamed model %d into, call SetInferenceInterface()."), Version);
+        SendModelFailed(Version);
+    }
+    else if (!InferenceInterface->LoadModelFromMemoryAsync(MoveTemp(StreamedModelBytes), Version))
+    {
+        SendModelFailed(Version);
+    }
+    StreamedModelBytes.Reset();
+    StreamedModelVersion = INDEX_NONE;
 }
 
 bool UBaseBridge::IsTickable() const
@@ -0,0 +1,296 @@
+#include "TrainingBridges/MultiAgent/MultiAgentBridge.h"
+#include "TcpConnection/SingleTcpConnection.h"
+#include "Inference/InferenceInterfaces/InferenceInterface.h"
+#include "UERLPlugin/Helpers/PythonMsgParsingHelpers.h"
+#include "UERLPlugin/Helpers/BPFL_DataHelpers.h"
+
+// -------------------------------------------------------------------------
+// Agent Setup
+// -------------------------------------------------------------------------
+int32 UMultiAgentBridge::RegisterAgent(const FString& Name, int32 ObservationSize, int32 ActionSize)
+{
+    if (TcpConnection)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("[UMultiAgentBridge] RegisterAgent(%s) called after Connect(), agent layout is fixed."), *Name);
+        return INDEX_NONE;
+    }
+    if (Name.IsEmpty() || Name.Contains(TEXT(":")) || Name.Contains(TEXT(",")) || Name.Contains(TEXT(";")))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("[UMultiAgentBridge] Agent name '%s' must be non-empty and free of ':' ',' ';'."), *Name);
+        return INDEX_NONE;
+    }
+
+    FAgentSpec& Spec = Agents.AddDefaulted_GetRef();
+    Spec.Name = Name;
+    Spec.ObservationSize = FMath::Max(ObservationSize, 0);
+    Spec.ActionSize = FMath::Max(ActionSize, 0);
+    AgentInferenceInterfaces.SetNum(Agents.Num());
+    return Agents.Num() - 1;
+}
+
+void UMultiAgentBridge::ClearAgents()
+{
+    if (TcpConnection)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("[UMultiAgentBridge] ClearAgents() called while connected, ignoring."));
+        return;
+    }
+    Agents.Empty();
+    AgentInferenceInterfaces.Empty();
+}
+
+FAgentSpec UMultiAgentBridge::GetAgentSpec(int32 AgentId) const
+{
+    return Agents.IsValidIndex(AgentId) ? Agents[AgentId] : FAgentSpec();
+}
+
+bool UMultiAgentBridge::SetAgentInferenceInterface(int32 AgentId, UInferenceInterface* Interface)
+{
+    if (!AgentInferenceInterfaces.IsValidIndex(AgentId) || !Interface)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("[UMultiAgentBridge] Invalid agent %d or empty InferenceInterface ptr."), AgentId);
+        return false;
+    }
+    AgentInferenceInterfaces[AgentId] = Interface;
+    return true;
+}
+
+bool UMultiAgentBridge::Connect_Implementation(const FString& IPAddress, int32 Port, int32 InActionSpaceSize, int32 InObservationSpaceSize)
+{
+    if (Agents.Num() == 0)
+    {
+        UE_LOG(LogTemp, Error, TEXT("[UMultiAgentBridge] No agents registered, call RegisterAgent() before Connect()."));
+        return false;
+    }
+
+    // Lay agents out back to back, totals replace the sizes passed in
+    ObservationOffsets.SetNum(Agents.Num());
+    ActionOffsets.SetNum(Agents.Num());
+    int32 TotalObs = 0;
+    int32 TotalAct = 0;
+    for (int32 i = 0; i < Agents.Num(); i++)
+    {
+        ObservationOffsets[i] = TotalObs;
+        ActionOffsets[i] = TotalAct;
+        TotalObs += Agents[i].ObservationSize;
+        TotalAct += Agents[i].ActionSize;
+    }
+    Observations.Init(0.f, TotalObs);
+    Actions.Init(0.f, TotalAct);
+
+    if (InObservationSpaceSize != TotalObs || InActionSpaceSize != TotalAct)
+    {
+        UE_LOG(LogTemp, Log, TEXT("[UMultiAgentBridge] Using agent totals OBS=%d ACT=%d instead of OBS=%d ACT=%d."),
+            TotalObs, TotalAct, InObservationSpaceSize, InActionSpaceSize);
+    }
+    return Super::Connect_Implementation(IPAddress, Port, TotalAct, TotalObs);
+}
+
+FString UMultiAgentBridge::BuildHandshake_Implementation()
+{
+    TArray<FString> AgentEntries;
+    for (const FAgentSpec& Spec : Agents)
+    {
+        AgentEntries.Add(FString::Printf(TEXT("%s:%d:%d"), *Spec.Name, Spec.ObservationSize, Spec.ActionSize));
+    }
+    return FString::Printf(TEXT("CONFIG:OBS=%d;ACT=%d;ENV_TYPE=MULTIAGENT;AGENT_COUNT=%d;AGENTS=%s"),
+        ObservationSpaceSize, ActionSpaceSize, Agents.Num(), *FString::Join(AgentEntries, TEXT(",")));
+}
+
+UBaseTcpConnection* UMultiAgentBridge::CreateTcpConnection_Implementation()
+{
+    return NewObject<USingleTcpConnection>(this, USingleTcpConnection::StaticClass());
+}
+
+TArrayView<float> UMultiAgentBridge::GetAgentObservation(int32 AgentId)
+{
+    return TArrayView<float>(Observations.GetData() + ObservationOffsets[AgentId], Agents[AgentId].ObservationSize);
+}
+
+TArrayView<float> UMultiAgentBridge::GetAgentActions(int32 AgentId)
+{
+    return TArrayView<float>(Actions.GetData() + ActionOffsets[AgentId], Agents[AgentId].ActionSize);
+}
+
+// -------------------------------------------------------------------------
+// RL Loop: UpdateRL Implementation
+// -------------------------------------------------------------------------
+void UMultiAgentBridge::UpdateRL_Implementation(float DeltaTime)
+{
+    if (bIsTraining) {
+        // worker (re)connected, start it from a fresh episode
+        if (TcpConnection->ConsumeJoinedEnvs().Num() > 0)
+        {
+            UE_LOG(LogTemp, Log, TEXT("[UMultiAgentBridge] Env worker connected, resetting environment."));
+            StartEpisode();
+        }
+
+        FString PythonMessage = ReceiveData();
+        if (!PythonMessage.IsEmpty())
+        {
+            if (UPythonMsgParsingHelpers::ParseActionString(PythonMessage).Contains("RESET"))
+            {
+                ResetAndSendObservations();
+                return;
+            }
+
+            // one joint action for all agents
+            ScatterActions(PythonMessage);
+            bIsActionRunning = true;
+            ActionReadyFrame = GetActionReadyFrame();
+        }
+
+        if (bIsActionRunning) {
+            // hold the action for its fixed sub-steps before asking the world
+            bIsActionRunning = IsHoldingAction(ActionReadyFrame) || IsActionRunning();
+            if (!bIsActionRunning) {
+                EpisodeSteps++;
+                GatherAndSendObservations();
+            }
+        }
+    }
+    else if (bIsInference) {
+        // every agent runs its own model on its own observation slot
+        if (bIsActionRunning) {
+            bIsActionRunning = IsHoldingAction(ActionReadyFrame) || IsActionRunning();
+            if (!bIsActionRunning) {
+                EpisodeSteps++;
+                // nobody sends RESET here, the world starts over once every agent is done or the time limit is hit
+                bool bAllDone = true;
+                for (int32 i = 0; i < Agents.Num(); i++)
+                {
+                    bool bDone = false;
+                    CalculateRewardForAgent(i, bDone);
+                    bAllDone &= bDone;
+                }
+                if (bAllDone || (MaxEpisodeSteps > 0 && EpisodeSteps >= MaxEpisodeSteps)) {
+                    StartEpisode();
+                }
+            }
+        }
+        else {
+            bool bAnyAction = false;
+            for (int32 i = 0; i < Agents.Num(); i++)
+            {
+                UInferenceInterface* Interface = AgentInferenceInterfaces.IsValidIndex(i) && AgentInferenceInterfaces[i]
+                    ? AgentInferenceInterfaces[i] : InferenceInterface;
+                if (!Interface)
+                {
+                    continue;
+                }
+                // agent id selects the hidden state row when agents share a recurrent model
+                const FString ActionResponse = Interface->RunInferenceForAgent(i, UBPFL_DataHelpers::ParseStateString(CreateStateStringForAgent(i)));
+                if (!ActionResponse.IsEmpty())
+                {
+                    HandleResponseActionsForAgent(i, ActionResponse);
+                    bAnyAction = true;
+                }
+            }
+            if (bAnyAction) {
+                bIsActionRunning = true;
+                ActionReadyFrame = GetActionReadyFrame();
+            }
+        }
+    }
+}
+
+void UMultiAgentBridge::StartEpisode()
+{
+    HandleReset();
+
+    // the world resets as a whole, every agent's model starts from scratch whatever HandleReset does
+    ResetInferenceState();
+    for (int32 i = 0; i < AgentInferenceInterfaces.Num(); i++)
+    {
+        if (AgentInferenceInterfaces[i])
+        {
+            AgentInferenceInterfaces[i]->ResetState(i);
+        }
+    }
+    bIsActionRunning = false;
+    ActionReadyFrame = 0;
+    EpisodeSteps = 0;
+}
+
+void UMultiAgentBridge::ResetAndSendObservations()
+{
+    StartEpisode();
+    GatherAndSendObservations();
+}
+
+void UMultiAgentBridge::GatherAndSendObservations()
+{
+    TArray<FString> AgentMessages;
+    AgentMessages.Reserve(Agents.Num());
+    const bool bTimeLimitReached = MaxEpisodeSteps > 0 && EpisodeSteps >= MaxEpisodeSteps;
+
+    for (int32 i = 0; i < Agents.Num(); i++)
+    {
+        bool bDone = false;
+        const float Reward = CalculateRewardForAgent(i, bDone);
+        TArrayView<float> Slot = GetAgentObservation(i);
+        WriteObservationForAgent(i, Slot);
+
+        AgentMessages.Add(FString::Printf(TEXT("AGENT=%d;OBS=%s;REW=%.2f;DONE=%d;TRUNC=%d"),
+            i, *UBPFL_DataHelpers::ArrayViewToStateString(Slot, ObservationPrecision), Reward, bDone ? 1 : 0, !bDone && bTimeLimitReached ? 1 : 0));
+    }
+
+    SendData(FString::Join(AgentMessages, TEXT("||")));
+    bStepCompletedThisUpdate = true;
+}
+
+void UMultiAgentBridge::ScatterActions(const FString& PythonMessage)
+{
+    TArray<FString> AgentMessages;
+    PythonMessage.ParseIntoArray(AgentMessages, TEXT("||"), true);
+
+    for (const FString& AgentMessage : AgentMessages)
+    {
+        const int32 AgentId = UPythonMsgParsingHelpers::ParseAgentId(AgentMessage);
+        if (!Agents.IsValidIndex(AgentId))
+        {
+            UE_LOG(LogTemp, Warning, TEXT("[UMultiAgentBridge] Dropping message with invalid agent id => %s"), *AgentMessage);
+            continue;
+        }
+
+        // keep the parsed actions in the agent slot, then apply them
+        const FString ActionString = UPythonMsgParsingHelpers::ParseActionString(AgentMessage);
+        UBPFL_DataHelpers::ParseStateStringInto(ActionString, GetAgentActions(AgentId));
+        HandleResponseActionsForAgent(AgentId, ActionString);
+    }
+}
+
+void UMultiAgentBridge::WriteObservationForAgent(int32 AgentId, TArrayView<float> OutObservation)
+{
+    const int32 NumValues = UBPFL_DataHelpers::ParseStateStringInto(CreateStateStringForAgent(AgentId), OutObservation);
+    if (NumValues != OutObservation.Num()) {
+        UE_LOG(LogTemp, Verbose, TEXT("[UMultiAgentBridge] Agent %d state has %d values, expected %d."), AgentId, NumValues, OutObservation.Num());
+    }
+}
+
+// -------------------------------------------------------------------------
+// Environment Callbacks
+// -------------------------------------------------------------------------
+FString UMultiAgentBridge::CreateStateStringForAgent_Implementation(int32 AgentId)
+{
+    return FString();
+}
+
+float UMultiAgentBridge::CalculateRewardForAgent_Implementation(int32 AgentId, bool& bDone)
+{
+    bDone = false;
+    return 0.0f;
+}
+
+void UMultiAgentBridge::HandleResponseActionsForAgent_Implementation(int32 AgentId, const FString& Actions)
+{
+}
+
+void UMultiAgentBridge::HandleReset_Implementation()
+{
+}
+
+bool UMultiAgentBridge::IsActionRunning_Implementation()
+{
+    return false;
+}
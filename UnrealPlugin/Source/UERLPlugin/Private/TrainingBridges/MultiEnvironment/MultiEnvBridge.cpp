@@ -2,42 +2,115 @@
 #include "Misc/Parse.h"
 #include "TcpConnection/MultiTcpConnection.h"    
 #include "UERLPlugin/Helpers/PythonMsgParsingHelpers.h"
+#include "UERLPlugin/Helpers/BPFL_DataHelpers.h"
 #include "HAL/PlatformProcess.h"
+#include "Async/ParallelFor.h"
 
 UBaseTcpConnection* UMultiEnvBridge::CreateTcpConnection_Implementation()
 {
     // set num of environments after creation
     UMultiTcpConnection* newBridge = NewObject<UMultiTcpConnection>(this, UMultiTcpConnection::StaticClass());
     newBridge->NumEnvironments = NumEnvironments;
+    newBridge->bAllowPartialConnections = bStepPartialFleet;
+    newBridge->bAdminOnly = bActorMode;
     return newBridge;
 }
 
 void UMultiEnvBridge::InitializeEnvironments(int32 InNumEnvironments, bool bInInferenceMode)
 {
 
-    // If we're in inference mode, force only one environment.
+    // inference steps every env too, their observations go through the local model in one batch
+    NumEnvironments = FMath::Max(InNumEnvironments, 1);
     if (bInInferenceMode) {
-        NumEnvironments = 1;
-    }
-    else {
-        NumEnvironments = FMath::Max(InNumEnvironments, 1);
+        StartInference();
     }
 
     // Resize the arrays to match the number of environments.
-    bIsActionRunning.SetNum(NumEnvironments);
+    bIsEnvActive.SetNum(NumEnvironments);
+    ActionReadyFrame.SetNum(NumEnvironments);
+    bWarnedObservationSize.Init(false, NumEnvironments);
+
+    // Per-env state, preallocated so parallel callbacks only write into their own slot
+    EnvState.Initialize(NumEnvironments, ObservationSpaceSize, ActionSpaceSize);
+
+    // Parallel callbacks bypass Blueprint events, only allow them when the callbacks are C++ overrides
+    bHasBlueprintEnvCallbacks = HasBlueprintEnvCallbacks();
+    if (bParallelEnvCallbacks && bHasBlueprintEnvCallbacks) {
+        UE_LOG(LogTemp, Warning, TEXT("[UMultiEnvBridge] bParallelEnvCallbacks requires C++ env callbacks, Blueprint overrides found. Falling back to sequential callbacks."));
+    }
 
     // Initialize each environment's state.
     for (int32 i = 0; i < NumEnvironments; i++)
     {
+        bIsEnvActive[i] = false;
+        ActionReadyFrame[i] = 0;
+    }
+}
+
+bool UMultiEnvBridge::Connect_Implementation(const FString& IPAddress, int32 Port, int32 InActionSpaceSize, int32 InObservationSpaceSize)
+{
+    // actor rollouts need the behaviour log probabilities of the policy heads, without them every LogProb would be 0
+    if (bActorMode && (!InferenceInterface || InferenceInterface->PolicyHeads.Num() == 0)) {
+        UE_LOG(LogTemp, Error, TEXT("[UMultiEnvBridge] bActorMode needs an InferenceInterface with PolicyHeads, call SetInferenceInterface() before Connect()."));
+        return false;
+    }
+
+    const bool bConnected = Super::Connect_Implementation(IPAddress, Port, InActionSpaceSize, InObservationSpaceSize);
 
-        bIsActionRunning[i] = false;
+    if (bActorMode && RolloutLength <= 0) {
+        UE_LOG(LogTemp, Warning, TEXT("[UMultiEnvBridge] bActorMode needs RolloutLength > 0, no trajectories will be shipped."));
     }
+    return bConnected;
+}
+
+bool UMultiEnvBridge::InitializeObservationLayout(int32 InActionSpaceSize, int32 InObservationSpaceSize)
+{
+    const bool bValid = Super::InitializeObservationLayout(InActionSpaceSize, InObservationSpaceSize);
+
+    // space sizes are only known now (possibly taken from the schema), reallocate the observation and action blocks
+    EnvState.Initialize(NumEnvironments, ObservationSpaceSize, ActionSpaceSize);
+
+    // rollouts store the observations as sent, with all stacked frames
+    // actor rollouts keep the terminal observations of truncated steps, the learner values them itself
+    Rollout.Initialize(RolloutLength, NumEnvironments, ObservationSpaceSize * (UsesFrameStack() ? FrameStackDepth : 1), ActionSpaceSize, bActorMode);
+    return bValid;
+}
+
+int32 UMultiEnvBridge::GetEpisodeLength(int32 EnvId) const
+{
+    return EnvState.EpisodeLengths.IsValidIndex(EnvId) ? EnvState.EpisodeLengths[EnvId] : 0;
+}
+
+float UMultiEnvBridge::GetEpisodeReturn(int32 EnvId) const
+{
+    return EnvState.EpisodeReturns.IsValidIndex(EnvId) ? EnvState.EpisodeReturns[EnvId] : 0.f;
+}
+
+TArray<float> UMultiEnvBridge::GetLastActions(int32 EnvId) const
+{
+    if (EnvId < 0 || EnvId >= EnvState.GetNumEnvs()) {
+        return TArray<float>();
+    }
+    return TArray<float>(EnvState.GetAction(EnvId));
 }
 
 FString UMultiEnvBridge::BuildHandshake_Implementation()
 {
-    return FString::Printf(TEXT("CONFIG:OBS=%d;ACT=%d;ENV_TYPE=MULTI;ENV_COUNT=%d"),
+    FString Handshake = FString::Printf(TEXT("CONFIG:OBS=%d;ACT=%d;ENV_TYPE=MULTI;ENV_COUNT=%d"),
         ObservationSpaceSize, ActionSpaceSize, NumEnvironments);
+    if (bAutoReset) {
+        Handshake += TEXT(";AUTO_RESET=1");
+    }
+    if (AsyncBatchSize > 0) {
+        Handshake += FString::Printf(TEXT(";ASYNC_BATCH=%d"), AsyncBatchSize);
+    }
+    if (RolloutLength > 0) {
+        Handshake += FString::Printf(TEXT(";ROLLOUT=%d"), RolloutLength);
+    }
+    if (bActorMode) {
+        Handshake += TEXT(";ACTOR=1");
+    }
+    return Handshake;
 }
 
 // -------------------------------------------------------------------------
@@ -46,7 +119,12 @@ FString UMultiEnvBridge::BuildHandshake_Implementation()
 void UMultiEnvBridge::UpdateRL_Implementation(float DeltaTime)
 {
 
-    if (bIsTraining) {
+    if (bIsTraining && bActorMode) {
+        UpdateActor();
+    }
+    else if (bIsTraining) {
+        RefreshEnvConnections();
+
         // receive response
         FString PythonMessage = ReceiveData();
 
@@ -60,72 +138,494 @@ void UMultiEnvBridge::UpdateRL_Implementation(float DeltaTime)
         
                 FString ActionString = UPythonMsgParsingHelpers::ParseActionString(actionMsgArray[i]);
                 int32 EnvId = UPythonMsgParsingHelpers::ParseEnvId(actionMsgArray[i]);
-                if (EnvId == -1) {
-                    SendData("PROBLEM IS HERE" + actionMsgArray[i]);
+                if (!bIsEnvActive.IsValidIndex(EnvId)) {
+                    UE_LOG(LogTemp, Warning, TEXT("[UMultiEnvBridge] Dropping message with invalid env id => %s"), *actionMsgArray[i]);
+                    continue;
                 }
                 if (ActionString.Contains("RESET"))
                 {
                     // reset if simulation is done
-                    HandleResetForEnv(EnvId);
-                    bIsActionRunning[EnvId] = false;
+                    // also completes the reset handshake for environments that just joined
+                    StartEnvEpisode(EnvId);
+                    bIsEnvActive[EnvId] = true;
 
+                    // initial observation of the new episode, reward and done are not accumulated
                     bool bDone = false;
-                    float Reward = CalculateRewardForEnv(EnvId, bDone);
-                    int32 DoneInt = bDone ? 1 : 0;            
-                    FString Response = FString::Printf(TEXT("OBS=%sREW=%.2f;DONE=%d;ENV=%d"),
-                        *CreateStateStringForEnv(EnvId), Reward, DoneInt, EnvId);
-                    SendData(Response);
+                    EnvState.Rewards[EnvId] = CalculateRewardForEnv(EnvId, bDone);
+                    EnvState.Dones[EnvId] = bDone ? 1 : 0;
+                    UpdateEnvObservation(EnvId);
+                    if (UsesObservationSchema()) {
+                        SendPackedStep(EnvId, false);
+                    }
+                    else {
+                        DispatchStepMessage(EnvId, BuildStepMessage(EnvId));
+                    }
+                    bStepCompletedThisUpdate = true;
 
                 }
+                else if (!bIsEnvActive[EnvId]) {
+                    // env has not completed its reset handshake, don't step it
+                    UE_LOG(LogTemp, Warning, TEXT("[UMultiEnvBridge] EnvId=%d sent actions before RESET, ignoring."), EnvId);
+                }
                 else {
-                    // interpret response and apply given actions
+                    // keep the parsed actions in the env slot, then interpret response and apply given actions
+                    UBPFL_DataHelpers::ParseStateStringInto(ActionString, EnvState.GetAction(EnvId));
+                    if (Rollout.IsEnabled()) {
+                        // the action was chosen from the observation last sent for this env,
+                        // TVAL is the value of the terminal observation if the previous step was truncated
+                        float Value = 0.f;
+                        float LogProb = 0.f;
+                        float TerminalValue = 0.f;
+                        UPythonMsgParsingHelpers::ParseFloatValue(actionMsgArray[i], TEXT("VAL"), Value);
+                        UPythonMsgParsingHelpers::ParseFloatValue(actionMsgArray[i], TEXT("LOGP"), LogProb);
+                        UPythonMsgParsingHelpers::ParseFloatValue(actionMsgArray[i], TEXT("TVAL"), TerminalValue);
+                        Rollout.RecordAction(EnvId, GetSentObservation(EnvId), EnvState.GetAction(EnvId), Value, LogProb, TerminalValue);
+                    }
                     HandleResponseActionsForEnv(EnvId, ActionString);
-                    bIsActionRunning[EnvId] = true;
+                    EnvState.ActionRunning[EnvId] = 1;
+                    ActionReadyFrame[EnvId] = GetActionReadyFrame();
                 }
             }
 
         }
-        for (int i = 0; i < bIsActionRunning.Num(); i++) {
-            if (bIsActionRunning[i] == true) {
-                bIsActionRunning[i] = IsActionRunningForEnv(i);
+        // evaluate completion, reward and observation for every env into EnvState
+        EvaluateAllEnvSteps();
 
-                if (bIsActionRunning[i] == false) {
-                    // if isActionRunning returns false, action has completed send new obs state
-                    // ---------------------- MAKE STATE STRING ---------------------------------
-                    bool bDone = false;
-                    float Reward = CalculateRewardForEnv(i, bDone);
-                    int32 DoneInt = bDone ? 1 : 0;
-
-                    FString Response = FString::Printf(TEXT("OBS=%sREW=%.2f;DONE=%d;ENV=%d"),
-                        *CreateStateStringForEnv(i), Reward, DoneInt, i);
-                    SendData(Response);
-                    // ---------------------- MAKE STATE STRING ---------------------------------
+        // network and resets stay on the game thread, send every completed env in one pass
+        for (int i = 0; i < NumEnvironments; i++) {
+            if (EnvState.StepCompleted[i]) {
+                const bool bEpisodeEnded = EnvState.Dones[i] || EnvState.Truncations[i];
+                // before an auto-reset clears the env slot
+                Rollout.RecordOutcome(i, EnvState.Rewards[i], EnvState.Dones[i] != 0, EnvState.Truncations[i] != 0);
+                if (UsesObservationSchema()) {
+                    SendPackedStep(i, bAutoReset && bEpisodeEnded);
                 }
-
+                else if (bAutoReset && bEpisodeEnded) {
+                    // terminal observation, reward and flags have to be read before the reset clears the env slot
+                    const FString TerminalFields = BuildStepFields(i);
+                    AutoResetEnv(i);
+                    DispatchStepMessage(i, BuildAutoResetMessage(i, TerminalFields));
+                }
+                else {
+                    DispatchStepMessage(i, BuildStepMessage(i));
+                }
+                bStepCompletedThisUpdate = true;
             }
         }
+        FlushReadyBatches();
+        ShipRolloutIfReady();
     }
     else if (bIsInference) {
         // if inference mode, run inference through loaded model instead
         // inference is tick driven rather then on demand
+        UpdateInference();
+    }
+
+}
+
+void UMultiEnvBridge::EvaluateAllEnvSteps()
+{
+    if (bParallelEnvCallbacks && !bHasBlueprintEnvCallbacks) {
+        // callbacks are flagged thread safe, envs are independent so spread them over the task graph
+        // every chunk calls the C++ callbacks, including the ones ParallelFor runs on the game thread
+        ParallelFor(NumEnvironments, [this](int32 EnvId)
+        {
+            EvaluateEnvStep(EnvId, true);
+        }, EParallelForFlags::Unbalanced);
+    }
+    else {
+        for (int i = 0; i < NumEnvironments; i++) {
+            EvaluateEnvStep(i, false);
+        }
+    }
+
+    // fold this step's raw observations of all envs into the normalization statistics in one batch
+    if (UsesObservationNormalization()) {
+        ObservationNormalizer.Commit();
+    }
+}
+
+// -------------------------------------------------------------------------
+// Inference
+// -------------------------------------------------------------------------
+void UMultiEnvBridge::UpdateInference()
+{
+    if (!InferenceInterface) {
+        UE_LOG(LogTemp, Warning, TEXT("[UMultiEnvBridge] Inference needs an InferenceInterface, call SetInferenceInterface()."));
+        return;
+    }
+    if (EnvState.GetNumEnvs() != NumEnvironments || ObservationSpaceSize <= 0) {
+        UE_LOG(LogTemp, Warning, TEXT("[UMultiEnvBridge] Observation layout not set, call InitializeInference() or Connect() first."));
+        return;
+    }
+
+    // there is no worker to send RESET, every env starts its first episode right away
+    for (int32 i = 0; i < NumEnvironments; i++) {
+        if (!bIsEnvActive[i]) {
+            AutoResetEnv(i);
+            bIsEnvActive[i] = true;
+        }
+    }
+
+    // same observation path as training: state values, sensors, normalization, frame stack
+    EvaluateAllEnvSteps();
+
+    for (int32 i = 0; i < NumEnvironments; i++) {
+        if (EnvState.StepCompleted[i] && (EnvState.Dones[i] || EnvState.Truncations[i])) {
+            AutoResetEnv(i);
+        }
+    }
 
-        if (bIsActionRunning[0] == true) {
-            bIsActionRunning[0] = IsActionRunningForEnv(0);
+    ActWithLocalPolicy();
+}
+
+// -------------------------------------------------------------------------
+// Actor Mode
+// -------------------------------------------------------------------------
+void UMultiEnvBridge::UpdateActor()
+{
+    if (!InferenceInterface) {
+        UE_LOG(LogTemp, Warning, TEXT("[UMultiEnvBridge] bActorMode needs an InferenceInterface, call SetInferenceInterface()."));
+        return;
+    }
 
+    // no worker sends RESET in actor mode, every env starts its first episode right away
+    for (int32 i = 0; i < NumEnvironments; i++) {
+        if (!bIsEnvActive[i]) {
+            AutoResetEnv(i);
+            bIsEnvActive[i] = true;
         }
-        else {
-            FString ActionResponse = RunLocalModelInference(CreateStateStringForEnv(0));
-            if (!ActionResponse.IsEmpty()) {
-                HandleResponseActionsForEnv(0, ActionResponse);
-                bIsActionRunning[0] = true;
+    }
+
+    EvaluateAllEnvSteps();
+
+    // outcomes of finished actions, ended episodes start over before the next action is chosen
+    for (int32 i = 0; i < NumEnvironments; i++) {
+        if (EnvState.StepCompleted[i]) {
+            const bool bEpisodeEnded = EnvState.Dones[i] || EnvState.Truncations[i];
+            Rollout.RecordOutcome(i, EnvState.Rewards[i], EnvState.Dones[i] != 0, EnvState.Truncations[i] != 0);
+            if (bEpisodeEnded) {
+                // the observation the episode was cut at, before the reset overwrites it
+                Rollout.RecordTerminalObservation(i, GetSentObservation(i));
+                AutoResetEnv(i);
             }
         }
+    }
+
+    ActWithLocalPolicy();
+    ShipRolloutIfReady();
+}
+
+void UMultiEnvBridge::ActWithLocalPolicy()
+{
+    ActorEnvIds.Reset();
+    ActorObservations.Reset();
+    // inference acts the same way, it just records no rollout
+    const bool bRecordRollout = bIsTraining && Rollout.IsEnabled();
+    for (int32 i = 0; i < NumEnvironments; i++) {
+        // envs that finished their part of the rollout wait for it to ship, their steps would not be recorded
+        if (bIsEnvActive[i] && !EnvState.ActionRunning[i] && !(bRecordRollout && Rollout.IsWaitingForNextRollout(i))) {
+            const TConstArrayView<float> Observation = GetSentObservation(i);
+            ActorEnvIds.Add(i);
+            ActorObservations.Append(Observation.GetData(), Observation.Num());
+        }
+    }
+    if (ActorEnvIds.Num() == 0) {
+        return;
+    }
 
+    if (!InferenceInterface->RunInferenceBatch(ActorEnvIds, ActorObservations, ActorActions)
+        || ActorActions.Num() != ActorEnvIds.Num() * ActionSpaceSize) {
+        UE_LOG(LogTemp, Error, TEXT("[UMultiEnvBridge] Local policy returned %d action values for %d envs of %d actions."),
+            ActorActions.Num(), ActorEnvIds.Num(), ActionSpaceSize);
+        return;
+    }
 
+    // behaviour log probabilities come from the policy heads, a step without one would corrupt the importance weights
+    const TArray<float> LogProbs = InferenceInterface->GetLastLogProbs();
+    if (bRecordRollout && LogProbs.Num() != ActorEnvIds.Num()) {
+        UE_LOG(LogTemp, Error, TEXT("[UMultiEnvBridge] Local policy returned %d log probabilities for %d envs, check its PolicyHeads."),
+            LogProbs.Num(), ActorEnvIds.Num());
+        return;
     }
+    const int32 ObsSize = ActorObservations.Num() / ActorEnvIds.Num();
+    for (int32 Row = 0; Row < ActorEnvIds.Num(); Row++) {
+        const int32 EnvId = ActorEnvIds[Row];
+        const TConstArrayView<float> Action(ActorActions.GetData() + Row * ActionSpaceSize, ActionSpaceSize);
+        FMemory::Memcpy(EnvState.GetAction(EnvId).GetData(), Action.GetData(), ActionSpaceSize * sizeof(float));
 
+        if (bRecordRollout) {
+            Rollout.RecordAction(EnvId, TConstArrayView<float>(ActorObservations.GetData() + Row * ObsSize, ObsSize), Action,
+                0.f, LogProbs[Row]);
+        }
+
+        HandleResponseActionsForEnv(EnvId, UBPFL_DataHelpers::ArrayViewToStateString(Action, 6));
+        EnvState.ActionRunning[EnvId] = 1;
+        ActionReadyFrame[EnvId] = GetActionReadyFrame();
+    }
+    bStepCompletedThisUpdate = true;
+}
+
+void UMultiEnvBridge::HandleAdminFrame(const FAdminFrame& Frame)
+{
+    if (!Frame.Header.StartsWith(TEXT("POLICY:"))) {
+        Super::HandleAdminFrame(Frame);
+        return;
+    }
+
+    // "POLICY:PATH=<path>;VERSION=<v>", the path runs to the next ';' and may contain spaces
+    const FString Fields = Frame.Header.Mid(FCString::Strlen(TEXT("POLICY:")));
+    FString Path;
+    FString VersionString;
+    if (!InferenceInterface
+        || !UPythonMsgParsingHelpers::ParseStringValue(Fields, TEXT("PATH"), Path) || Path.IsEmpty()
+        || !UPythonMsgParsingHelpers::ParseStringValue(Fields, TEXT("VERSION"), VersionString)) {
+        UE_LOG(LogTemp, Warning, TEXT("[UMultiEnvBridge] Ignoring policy message => %s"), *Frame.Header);
+        return;
+    }
+    const int32 Version = FCString::Atoi(*VersionString);
+
+    if (InferenceInterface->LoadModel(Path)) {
+        PolicyVersion = Version;
+        UE_LOG(LogTemp, Log, TEXT("[UMultiEnvBridge] Acting with policy version %d from %s"), Version, *Path);
+    }
 }
 
+void UMultiEnvBridge::EvaluateEnvStep(int32 EnvId, bool bCallNative)
+{
+    EnvState.StepCompleted[EnvId] = 0;
+    if (!EnvState.ActionRunning[EnvId] || !bIsEnvActive[EnvId]) {
+        return;
+    }
+
+    // hold the action for its fixed sub-steps before asking the environment
+    // bCallNative skips the Blueprint event thunk (game thread only) and calls the C++ override directly
+    const bool bStillRunning = IsHoldingAction(ActionReadyFrame[EnvId])
+        || (bCallNative ? IsActionRunningForEnv_Implementation(EnvId) : IsActionRunningForEnv(EnvId));
+    EnvState.ActionRunning[EnvId] = bStillRunning ? 1 : 0;
+
+    if (!bStillRunning) {
+        // if isActionRunning returns false, action has completed, gather new obs state
+        CompleteEnvStep(EnvId, bCallNative);
+    }
+}
+
+void UMultiEnvBridge::CompleteEnvStep(int32 EnvId, bool bCallNative)
+{
+    bool bDone = false;
+    const float Reward = bCallNative ? CalculateRewardForEnv_Implementation(EnvId, bDone) : CalculateRewardForEnv(EnvId, bDone);
+
+    // episodes that hit the time limit without terminating are reported as truncated
+    const bool bTruncated = !bDone && MaxEpisodeSteps > 0 && EnvState.EpisodeLengths[EnvId] + 1 >= MaxEpisodeSteps;
+    EnvState.RecordStep(EnvId, Reward, bDone, bTruncated);
+
+    UpdateEnvObservation(EnvId, bCallNative);
+    EnvState.StepCompleted[EnvId] = 1;
+}
+
+void UMultiEnvBridge::UpdateEnvObservation(int32 EnvId, bool bCallNative)
+{
+    WriteObservationForEnv(EnvId, EnvState.GetObservation(EnvId), bCallNative);
+    if (UsesObservationNormalization()) {
+        // statistics only change in Commit() on the game thread, rows are independent
+        ObservationNormalizer.Normalize(EnvId, EnvState.GetObservation(EnvId), ShouldUpdateNormalizationStats());
+    }
+    if (UsesFrameStack()) {
+        FrameStack.Push(EnvId, EnvState.GetObservation(EnvId));
+    }
+}
+
+TConstArrayView<float> UMultiEnvBridge::GetSentObservation(int32 EnvId) const
+{
+    return UsesFrameStack() ? FrameStack.GetStacked(EnvId) : EnvState.GetObservation(EnvId);
+}
+
+void UMultiEnvBridge::WriteObservationForEnv(int32 EnvId, TArrayView<float> OutObservation, bool bCallNative)
+{
+    const FString StateString = bCallNative ? CreateStateStringForEnv_Implementation(EnvId) : CreateStateStringForEnv(EnvId);
+    const int32 NumValues = UBPFL_DataHelpers::ParseStateStringInto(StateString, OutObservation.Left(StateObservationSize));
+
+    // extra values are dropped and missing ones zero filled, report it once per env (each env only touches its own flag)
+    if (NumValues != StateObservationSize && !bWarnedObservationSize[EnvId]) {
+        bWarnedObservationSize[EnvId] = true;
+        UE_LOG(LogTemp, Warning, TEXT("[UMultiEnvBridge] EnvId=%d state has %d values, expected %d. Extra values are dropped, missing ones are 0."),
+            EnvId, NumValues, StateObservationSize);
+    }
+    WriteSensorObservations(EnvId, OutObservation);
+}
+
+FString UMultiEnvBridge::BuildStepFields(int32 EnvId) const
+{
+    return FString::Printf(TEXT("OBS=%s;REW=%.2f;DONE=%d;TRUNC=%d"),
+        *UBPFL_DataHelpers::ArrayViewToStateString(GetSentObservation(EnvId), ObservationPrecision),
+        EnvState.Rewards[EnvId], EnvState.Dones[EnvId], EnvState.Truncations[EnvId]);
+}
+
+FString UMultiEnvBridge::BuildStepMessage(int32 EnvId) const
+{
+    return FString::Printf(TEXT("%s;ENV=%d"), *BuildStepFields(EnvId), EnvId);
+}
+
+FString UMultiEnvBridge::BuildAutoResetMessage(int32 EnvId, const FString& TerminalFields) const
+{
+    // the env slot already holds the first observation of the next episode
+    return FString::Printf(TEXT("%s;RESET_OBS=%s;ENV=%d"), *TerminalFields,
+        *UBPFL_DataHelpers::ArrayViewToStateString(GetSentObservation(EnvId), ObservationPrecision), EnvId);
+}
+
+void UMultiEnvBridge::StartEnvEpisode(int32 EnvId)
+{
+    HandleResetForEnv(EnvId);
+
+    // recurrent models and stacked frames start every episode from scratch, whatever HandleResetForEnv does
+    ResetInferenceState(EnvId);
+    EnvState.ResetEnv(EnvId);
+    FrameStack.ResetRow(EnvId);
+    ActionReadyFrame[EnvId] = 0;
+}
+
+void UMultiEnvBridge::AutoResetEnv(int32 EnvId)
+{
+    StartEnvEpisode(EnvId);
+    UpdateEnvObservation(EnvId);
+}
+
+void UMultiEnvBridge::SendPackedStep(int32 EnvId, bool bWithAutoReset)
+{
+    FString Header = FString::Printf(TEXT("REW=%.2f;DONE=%d;TRUNC=%d"),
+        EnvState.Rewards[EnvId], EnvState.Dones[EnvId], EnvState.Truncations[EnvId]);
+
+    if (!bWithAutoReset) {
+        const TConstArrayView<float> Observations[] = { GetSentObservation(EnvId) };
+        SendPackedObservation(Header + FString::Printf(TEXT(";ENV=%d"), EnvId), Observations);
+        return;
+    }
+
+    // terminal observation has to be kept before the reset overwrites the env slot
+    const TConstArrayView<float> TerminalObservation = GetSentObservation(EnvId);
+    TerminalObservationScratch.Reset(TerminalObservation.Num());
+    TerminalObservationScratch.Append(TerminalObservation.GetData(), TerminalObservation.Num());
+    AutoResetEnv(EnvId);
+
+    const TConstArrayView<float> Observations[] = { TerminalObservationScratch, GetSentObservation(EnvId) };
+    SendPackedObservation(Header + FString::Printf(TEXT(";RESET_OBS=1;ENV=%d"), EnvId), Observations);
+}
+
+void UMultiEnvBridge::DispatchStepMessage(int32 EnvId, const FString& Message)
+{
+    if (AsyncBatchSize <= 0) {
+        SendData(Message);
+        return;
+    }
+    ReadyEnvIds.Add(EnvId);
+    ReadyMessages.Add(Message);
+}
+
+void UMultiEnvBridge::FlushReadyBatches()
+{
+    if (AsyncBatchSize <= 0 || ReadyMessages.Num() == 0) {
+        return;
+    }
+
+    // never wait for more envs than can become ready
+    int32 NumActive = 0;
+    for (bool bActive : bIsEnvActive) {
+        NumActive += bActive ? 1 : 0;
+    }
+    const int32 BatchSize = FMath::Clamp(NumActive, 1, AsyncBatchSize);
+
+    int32 NumShipped = 0;
+    while (ReadyMessages.Num() - NumShipped >= BatchSize) {
+        const TArrayView<FString> Batch(ReadyMessages.GetData() + NumShipped, BatchSize);
+        TcpConnection->SendMessageAdmin(TEXT("BATCH:") + FString::Join(Batch, TEXT("||")));
+        NumShipped += BatchSize;
+    }
+    if (NumShipped > 0) {
+        ReadyEnvIds.RemoveAt(0, NumShipped);
+        ReadyMessages.RemoveAt(0, NumShipped);
+    }
+}
+
+void UMultiEnvBridge::ShipRolloutIfReady()
+{
+    if (!Rollout.IsReady(bIsEnvActive)) {
+        return;
+    }
+
+    FString Header = FString::Printf(TEXT("ROLLOUT:T=%d;N=%d;OBS=%d;ACT=%d"),
+        Rollout.GetHorizon(), Rollout.GetNumEnvs(), Rollout.GetObsSize(), Rollout.GetActSize());
+    if (bActorMode) {
+        // no value estimates on the actor, the learner values the last and the terminal observations itself
+        Header += FString::Printf(TEXT(";ACTOR=1;VERSION=%d;BOOTSTRAP_OBS=1;TERMINAL_OBS=1"), PolicyVersion);
+        Rollout.Serialize(bIsEnvActive, RolloutBytes, true);
+    }
+    else {
+        Rollout.ComputeAdvantages(RolloutGamma, RolloutGaeLambda);
+        Rollout.Serialize(bIsEnvActive, RolloutBytes);
+    }
+    TcpConnection->SendMessageAdminBinary(Header, RolloutBytes);
+    Rollout.StartNextRollout();
+
+    if (bActorMode && ++RolloutsSincePolicySync >= PolicySyncInterval) {
+        TcpConnection->SendMessageAdmin(FString::Printf(TEXT("POLICY_REQUEST:VERSION=%d"), PolicyVersion));
+        RolloutsSincePolicySync = 0;
+    }
+}
+
+bool UMultiEnvBridge::HasBlueprintEnvCallbacks() const
+{
+    // Blueprint overrides of a BlueprintNativeEvent live on a non-native generated class
+    static const FName CallbackNames[] = {
+        GET_FUNCTION_NAME_CHECKED(UMultiEnvBridge, IsActionRunningForEnv),
+        GET_FUNCTION_NAME_CHECKED(UMultiEnvBridge, CalculateRewardForEnv),
+        GET_FUNCTION_NAME_CHECKED(UMultiEnvBridge, CreateStateStringForEnv),
+    };
+    for (const FName& Name : CallbackNames)
+    {
+        const UFunction* Func = GetClass()->FindFunctionByName(Name);
+        if (Func && !Func->GetOwnerClass()->HasAnyClassFlags(CLASS_Native))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void UMultiEnvBridge::RefreshEnvConnections()
+{
+    // Late joiners: put the env in a clean state and wait for its RESET before stepping it
+    for (int32 EnvId : TcpConnection->ConsumeJoinedEnvs())
+    {
+        if (!bIsEnvActive.IsValidIndex(EnvId))
+        {
+            continue;
+        }
+        UE_LOG(LogTemp, Log, TEXT("[UMultiEnvBridge] EnvId=%d joined, resetting environment."), EnvId);
+        StartEnvEpisode(EnvId);
+        Rollout.DropEnv(EnvId);
+        bIsEnvActive[EnvId] = false;
+    }
+
+    // Dropped workers: fence the env off until a worker reconnects to its slot
+    for (int32 i = 0; i < bIsEnvActive.Num(); i++)
+    {
+        if (bIsEnvActive[i] && !TcpConnection->IsEnvConnected(i))
+        {
+            UE_LOG(LogTemp, Warning, TEXT("[UMultiEnvBridge] EnvId=%d disconnected, fencing off environment."), i);
+            bIsEnvActive[i] = false;
+            EnvState.ActionRunning[i] = 0;
+            Rollout.DropEnv(i);
+
+            // nobody is waiting for this env's queued observations anymore
+            for (int32 q = ReadyEnvIds.Num() - 1; q >= 0; q--) {
+                if (ReadyEnvIds[q] == i) {
+                    ReadyEnvIds.RemoveAt(q);
+                    ReadyMessages.RemoveAt(q);
+                }
+            }
+        }
+    }
+}
 
 // -------------------------------------------------------------------------
 // Environment Callbacks
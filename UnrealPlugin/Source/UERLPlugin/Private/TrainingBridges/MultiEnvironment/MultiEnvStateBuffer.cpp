@@ -0,0 +1,38 @@
+#include "TrainingBridges/MultiEnvironment/MultiEnvStateBuffer.h"
+
+void FMultiEnvStateBuffer::Initialize(int32 InNumEnvs, int32 InObsSize, int32 InActSize)
+{
+    NumEnvs = FMath::Max(InNumEnvs, 0);
+    ObsSize = FMath::Max(InObsSize, 0);
+    ActSize = FMath::Max(InActSize, 0);
+
+    Observations.Init(0.f, NumEnvs * ObsSize);
+    Actions.Init(0.f, NumEnvs * ActSize);
+    Rewards.Init(0.f, NumEnvs);
+    Dones.Init(0, NumEnvs);
+    Truncations.Init(0, NumEnvs);
+    EpisodeLengths.Init(0, NumEnvs);
+    EpisodeReturns.Init(0.f, NumEnvs);
+    ActionRunning.Init(0, NumEnvs);
+    StepCompleted.Init(0, NumEnvs);
+}
+
+void FMultiEnvStateBuffer::ResetEnv(int32 EnvId)
+{
+    Rewards[EnvId] = 0.f;
+    Dones[EnvId] = 0;
+    Truncations[EnvId] = 0;
+    EpisodeLengths[EnvId] = 0;
+    EpisodeReturns[EnvId] = 0.f;
+    ActionRunning[EnvId] = 0;
+    StepCompleted[EnvId] = 0;
+}
+
+void FMultiEnvStateBuffer::RecordStep(int32 EnvId, float Reward, bool bDone, bool bTruncated)
+{
+    Rewards[EnvId] = Reward;
+    Dones[EnvId] = bDone ? 1 : 0;
+    Truncations[EnvId] = bTruncated ? 1 : 0;
+    EpisodeLengths[EnvId]++;
+    EpisodeReturns[EnvId] += Reward;
+}
@@ -0,0 +1,285 @@
+#include "TrainingBridges/MultiEnvironment/RolloutBuffer.h"
+#include "Math/VectorRegister.h"
+
+void FRolloutBuffer::Initialize(int32 InHorizon, int32 InNumEnvs, int32 InObsSize, int32 InActSize, bool bInTerminalObservations)
+{
+    Horizon = FMath::Max(InHorizon, 0);
+    NumEnvs = FMath::Max(InNumEnvs, 0);
+    ObsSize = FMath::Max(InObsSize, 0);
+    ActSize = FMath::Max(InActSize, 0);
+    EnvStride = Align(NumEnvs, 4);
+    bTerminalObservations = bInTerminalObservations;
+
+    const int32 NumRows = Horizon > 0 ? Horizon + 1 : 0;
+    Observations.Init(0.f, NumRows * NumEnvs * ObsSize);
+    Actions.Init(0.f, NumRows * NumEnvs * ActSize);
+    TerminalObservations.Init(0.f, bTerminalObservations ? NumRows * NumEnvs * ObsSize : 0);
+    Rewards.Init(0.f, NumRows * EnvStride);
+    Dones.Init(0.f, NumRows * EnvStride);
+    Truncations.Init(0.f, NumRows * EnvStride);
+    TerminalValues.Init(0.f, NumRows * EnvStride);
+    Values.Init(0.f, NumRows * EnvStride);
+    LogProbs.Init(0.f, NumRows * EnvStride);
+    Advantages.Init(0.f, Horizon * EnvStride);
+    Returns.Init(0.f, Horizon * EnvStride);
+    LastValues.Init(0.f, EnvStride);
+    Cursors.Init(0, NumEnvs);
+    PendingOutcome.Init(0, NumEnvs);
+    Bootstrapped.Init(0, NumEnvs);
+    StagedOutcome.Init(0, NumEnvs);
+    StagedClosed.Init(0, NumEnvs);
+    LastOutcomeSteps.Init(INDEX_NONE, NumEnvs);
+}
+
+void FRolloutBuffer::RecordAction(int32 EnvId, TConstArrayView<float> Observation, TConstArrayView<float> Action, float Value, float LogProb, float TerminalValue)
+{
+    if (!IsEnabled() || !Cursors.IsValidIndex(EnvId))
+    {
+        return;
+    }
+
+    // past the horizon the first action bootstraps the rollout, anything after it waits for the next rollout
+    if (Cursors[EnvId] == Horizon && !Bootstrapped[EnvId])
+    {
+        ApplyTerminalValue(EnvId, TerminalValue);
+        LastValues[EnvId] = Value;
+        Bootstrapped[EnvId] = 1;
+    }
+    else if (StagedOutcome[EnvId])
+    {
+        // staged step already completed, the env ran ahead of the rollout and its next steps are dropped;
+        // end the trajectory at the staged step, bootstrapped from the observation this action was chosen from
+        if (!StagedClosed[EnvId])
+        {
+            ApplyTerminalValue(EnvId, TerminalValue);
+            const int32 Index = ScalarIndex(Horizon, EnvId);
+            if (Dones[Index] == 0.f && Truncations[Index] == 0.f)
+            {
+                Truncations[Index] = 1.f;
+                TerminalValues[Index] = Value;
+                WriteTerminalObservation(Horizon, EnvId, Observation);
+            }
+            StagedClosed[EnvId] = 1;
+        }
+        return;
+    }
+    else
+    {
+        ApplyTerminalValue(EnvId, TerminalValue);
+    }
+
+    const int32 Step = GetWriteStep(EnvId);
+    const int32 Row = Step * NumEnvs + EnvId;
+    FMemory::Memcpy(Observations.GetData() + Row * ObsSize, Observation.GetData(), FMath::Min(Observation.Num(), ObsSize) * sizeof(float));
+    FMemory::Memcpy(Actions.GetData() + Row * ActSize, Action.GetData(), FMath::Min(Action.Num(), ActSize) * sizeof(float));
+    Values[ScalarIndex(Step, EnvId)] = Value;
+    LogProbs[ScalarIndex(Step, EnvId)] = LogProb;
+    PendingOutcome[EnvId] = 1;
+}
+
+void FRolloutBuffer::RecordOutcome(int32 EnvId, float Reward, bool bTerminated, bool bTruncated)
+{
+    if (!IsEnabled() || !PendingOutcome.IsValidIndex(EnvId) || !PendingOutcome[EnvId])
+    {
+        return;
+    }
+
+    // a step that terminated and was truncated at once has no future to bootstrap from
+    const int32 Step = GetWriteStep(EnvId);
+    const int32 Index = ScalarIndex(Step, EnvId);
+    Rewards[Index] = Reward;
+    if (bTerminalObservations)
+    {
+        // only truncated steps get one, see RecordTerminalObservation()
+        FMemory::Memzero(TerminalObservations.GetData() + (Step * NumEnvs + EnvId) * ObsSize, ObsSize * sizeof(float));
+    }
+    Dones[Index] = bTerminated ? 1.f : 0.f;
+    Truncations[Index] = bTruncated && !bTerminated ? 1.f : 0.f;
+    TerminalValues[Index] = 0.f;
+    LastOutcomeSteps[EnvId] = bTruncated && !bTerminated ? Step : INDEX_NONE;
+    PendingOutcome[EnvId] = 0;
+    if (Bootstrapped[EnvId])
+    {
+        StagedOutcome[EnvId] = 1;
+    }
+    else
+    {
+        Cursors[EnvId]++;
+    }
+}
+
+void FRolloutBuffer::RecordTerminalObservation(int32 EnvId, TConstArrayView<float> Observation)
+{
+    if (bTerminalObservations && LastOutcomeSteps.IsValidIndex(EnvId) && LastOutcomeSteps[EnvId] != INDEX_NONE)
+    {
+        WriteTerminalObservation(LastOutcomeSteps[EnvId], EnvId, Observation);
+    }
+}
+
+void FRolloutBuffer::WriteTerminalObservation(int32 Step, int32 EnvId, TConstArrayView<float> Observation)
+{
+    if (bTerminalObservations)
+    {
+        FMemory::Memcpy(TerminalObservations.GetData() + (Step * NumEnvs + EnvId) * ObsSize, Observation.GetData(),
+            FMath::Min(Observation.Num(), ObsSize) * sizeof(float));
+    }
+}
+
+void FRolloutBuffer::DropEnv(int32 EnvId)
+{
+    if (!Cursors.IsValidIndex(EnvId))
+    {
+        return;
+    }
+    Cursors[EnvId] = 0;
+    PendingOutcome[EnvId] = 0;
+    Bootstrapped[EnvId] = 0;
+    StagedOutcome[EnvId] = 0;
+    StagedClosed[EnvId] = 0;
+    LastOutcomeSteps[EnvId] = INDEX_NONE;
+}
+
+void FRolloutBuffer::ApplyTerminalValue(int32 EnvId, float TerminalValue)
+{
+    if (LastOutcomeSteps[EnvId] != INDEX_NONE)
+    {
+        TerminalValues[ScalarIndex(LastOutcomeSteps[EnvId], EnvId)] = TerminalValue;
+        LastOutcomeSteps[EnvId] = INDEX_NONE;
+    }
+}
+
+bool FRolloutBuffer::IsReady(TConstArrayView<bool> ActiveEnvs) const
+{
+    if (!IsEnabled())
+    {
+        return false;
+    }
+
+    bool bAnyActive = false;
+    for (int32 EnvId = 0; EnvId < FMath::Min(NumEnvs, ActiveEnvs.Num()); EnvId++)
+    {
+        if (ActiveEnvs[EnvId])
+        {
+            if (!Bootstrapped[EnvId])
+            {
+                return false;
+            }
+            bAnyActive = true;
+        }
+    }
+    return bAnyActive;
+}
+
+void FRolloutBuffer::ComputeAdvantages(float Gamma, float GaeLambda)
+{
+    // A_t = delta_t + gamma * lambda * (1 - end_t) * A_t+1, delta_t = r_t + gamma * ((1 - end_t) * V_t+1 + Vterm_t) - V_t
+    // end_t = done_t + trunc_t (never both), Vterm_t is the terminal observation's value of a truncated step, else 0
+    const VectorRegister4Float VecGamma = VectorSetFloat1(Gamma);
+    const VectorRegister4Float VecGammaLambda = VectorSetFloat1(Gamma * GaeLambda);
+    const VectorRegister4Float VecOne = VectorOne();
+
+    for (int32 EnvId = 0; EnvId < EnvStride; EnvId += 4)
+    {
+        VectorRegister4Float NextValue = VectorLoadAligned(LastValues.GetData() + EnvId);
+        VectorRegister4Float NextAdvantage = VectorZeroFloat();
+
+        for (int32 Step = Horizon - 1; Step >= 0; Step--)
+        {
+            const int32 Index = ScalarIndex(Step, EnvId);
+            const VectorRegister4Float Ended = VectorAdd(VectorLoadAligned(Dones.GetData() + Index), VectorLoadAligned(Truncations.GetData() + Index));
+            const VectorRegister4Float NotEnded = VectorSubtract(VecOne, Ended);
+            const VectorRegister4Float Value = VectorLoadAligned(Values.GetData() + Index);
+            const VectorRegister4Float Reward = VectorLoadAligned(Rewards.GetData() + Index);
+
+            const VectorRegister4Float Bootstrap = VectorMultiplyAdd(NotEnded, NextValue, VectorLoadAligned(TerminalValues.GetData() + Index));
+            const VectorRegister4Float Delta = VectorSubtract(VectorMultiplyAdd(VecGamma, Bootstrap, Reward), Value);
+            NextAdvantage = VectorMultiplyAdd(VectorMultiply(VecGammaLambda, NotEnded), NextAdvantage, Delta);
+
+            VectorStoreAligned(NextAdvantage, Advantages.GetData() + Index);
+            VectorStoreAligned(VectorAdd(NextAdvantage, Value), Returns.GetData() + Index);
+            NextValue = Value;
+        }
+    }
+}
+
+void FRolloutBuffer::Serialize(TConstArrayView<bool> ActiveEnvs, TArray<uint8>& OutBytes, bool bWithBootstrapObservations) const
+{
+    const int32 NumScalars = Horizon * NumEnvs;
+    const int32 NumBootstrap = bWithBootstrapObservations ? NumEnvs * ObsSize : 0;
+    const int32 NumTerminal = bTerminalObservations ? NumScalars * ObsSize : 0;
+    const int32 NumFloats = NumScalars * (ObsSize + ActSize) + 8 * NumScalars + NumEnvs + NumBootstrap + NumTerminal;
+    OutBytes.SetNumUninitialized(NumFloats * sizeof(float));
+    float* Out = reinterpret_cast<float*>(OutBytes.GetData());
+
+    // per env blocks are already contiguous and time-major, the staging row is left out
+    FMemory::Memcpy(Out, Observations.GetData(), NumScalars * ObsSize * sizeof(float));
+    Out += NumScalars * ObsSize;
+    FMemory::Memcpy(Out, Actions.GetData(), NumScalars * ActSize * sizeof(float));
+    Out += NumScalars * ActSize;
+
+    // scalar fields drop their env padding
+    const float* ScalarFields[] = { Rewards.GetData(), Dones.GetData(), Truncations.GetData(), TerminalValues.GetData(),
+        Values.GetData(), LogProbs.GetData(), Advantages.GetData(), Returns.GetData() };
+    for (const float* Field : ScalarFields)
+    {
+        for (int32 Step = 0; Step < Horizon; Step++)
+        {
+            FMemory::Memcpy(Out, Field + ScalarIndex(Step, 0), NumEnvs * sizeof(float));
+            Out += NumEnvs;
+        }
+    }
+
+    for (int32 EnvId = 0; EnvId < NumEnvs; EnvId++)
+    {
+        *Out++ = ActiveEnvs.IsValidIndex(EnvId) && ActiveEnvs[EnvId] && Bootstrapped[EnvId] ? 1.f : 0.f;
+    }
+
+    // the staging row holds the observation each env's bootstrap action was chosen from
+    if (NumBootstrap > 0)
+    {
+        FMemory::Memcpy(Out, Observations.GetData() + NumScalars * ObsSize, NumBootstrap * sizeof(float));
+        Out += NumBootstrap;
+    }
+
+    if (NumTerminal > 0)
+    {
+        FMemory::Memcpy(Out, TerminalObservations.GetData(), NumTerminal * sizeof(float));
+    }
+}
+
+void FRolloutBuffer::StartNextRollout()
+{
+    for (int32 EnvId = 0; EnvId < NumEnvs; EnvId++)
+    {
+        if (!Bootstrapped[EnvId])
+        {
+            // inactive or lagging envs start over with the new rollout
+            Cursors[EnvId] = 0;
+            PendingOutcome[EnvId] = 0;
+            LastOutcomeSteps[EnvId] = INDEX_NONE;
+            continue;
+        }
+
+        // the staged step becomes step 0, complete unless its outcome is still pending
+        const int32 StagedRow = Horizon * NumEnvs + EnvId;
+        FMemory::Memcpy(Observations.GetData() + EnvId * ObsSize, Observations.GetData() + StagedRow * ObsSize, ObsSize * sizeof(float));
+        FMemory::Memcpy(Actions.GetData() + EnvId * ActSize, Actions.GetData() + StagedRow * ActSize, ActSize * sizeof(float));
+        if (bTerminalObservations)
+        {
+            FMemory::Memcpy(TerminalObservations.GetData() + EnvId * ObsSize, TerminalObservations.GetData() + StagedRow * ObsSize, ObsSize * sizeof(float));
+        }
+        Rewards[EnvId] = Rewards[ScalarIndex(Horizon, EnvId)];
+        Dones[EnvId] = Dones[ScalarIndex(Horizon, EnvId)];
+        Truncations[EnvId] = Truncations[ScalarIndex(Horizon, EnvId)];
+        TerminalValues[EnvId] = TerminalValues[ScalarIndex(Horizon, EnvId)];
+        Values[EnvId] = Values[ScalarIndex(Horizon, EnvId)];
+        LogProbs[EnvId] = LogProbs[ScalarIndex(Horizon, EnvId)];
+
+        // a pending outcome now lands in step 0
+        Cursors[EnvId] = StagedOutcome[EnvId] ? 1 : 0;
+        LastOutcomeSteps[EnvId] = LastOutcomeSteps[EnvId] == Horizon ? 0 : INDEX_NONE;
+        Bootstrapped[EnvId] = 0;
+        StagedOutcome[EnvId] = 0;
+        StagedClosed[EnvId] = 0;
+    }
+}
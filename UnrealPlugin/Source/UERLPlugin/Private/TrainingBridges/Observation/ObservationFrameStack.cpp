@@ -0,0 +1,72 @@
+#include "TrainingBridges/Observation/ObservationFrameStack.h"
+
+void FObservationFrameStack::Initialize(int32 InNumRows, int32 InFrameSize, int32 InDepth)
+{
+    NumRows = FMath::Max(InNumRows, 0);
+    FrameSize = FMath::Max(InFrameSize, 0);
+    Depth = FMath::Max(InDepth, 1);
+
+    Storage.Init(0.f, NumRows * 2 * Depth * FrameSize);
+    Heads.Init(0, NumRows);
+    Primed.Init(0, NumRows);
+}
+
+void FObservationFrameStack::ResetRow(int32 Row)
+{
+    if (Primed.IsValidIndex(Row))
+    {
+        Primed[Row] = 0;
+    }
+}
+
+void FObservationFrameStack::ResetAll()
+{
+    for (uint8& bPrimed : Primed)
+    {
+        bPrimed = 0;
+    }
+}
+
+TConstArrayView<float> FObservationFrameStack::Push(int32 Row, TConstArrayView<float> Frame)
+{
+    check(Row >= 0 && Row < NumRows);
+    float* RowData = Storage.GetData() + Row * 2 * Depth * FrameSize;
+    const int32 NumToCopy = FMath::Min(Frame.Num(), FrameSize);
+    const SIZE_T FrameBytes = FrameSize * sizeof(float);
+
+    if (!Primed[Row])
+    {
+        // pad the history with the first frame of the episode
+        FMemory::Memzero(RowData, FrameBytes);
+        FMemory::Memcpy(RowData, Frame.GetData(), NumToCopy * sizeof(float));
+        for (int32 Slot = 1; Slot < 2 * Depth; Slot++)
+        {
+            FMemory::Memcpy(RowData + Slot * FrameSize, RowData, FrameBytes);
+        }
+        Heads[Row] = 0;
+        Primed[Row] = 1;
+        return GetStacked(Row);
+    }
+
+    // overwrite the oldest frame in both copies of the ring
+    const int32 Slot = Heads[Row];
+    float* First = RowData + Slot * FrameSize;
+    float* Second = RowData + (Slot + Depth) * FrameSize;
+    FMemory::Memcpy(First, Frame.GetData(), NumToCopy * sizeof(float));
+    if (NumToCopy < FrameSize)
+    {
+        FMemory::Memzero(First + NumToCopy, (FrameSize - NumToCopy) * sizeof(float));
+    }
+    FMemory::Memcpy(Second, First, FrameBytes);
+
+    Heads[Row] = (Slot + 1) % Depth;
+    return GetStacked(Row);
+}
+
+TConstArrayView<float> FObservationFrameStack::GetStacked(int32 Row) const
+{
+    check(Row >= 0 && Row < NumRows);
+    // the window starting at the oldest slot ends with the newest frame in the second copy
+    const float* RowData = Storage.GetData() + Row * 2 * Depth * FrameSize;
+    return TConstArrayView<float>(RowData + Heads[Row] * FrameSize, Depth * FrameSize);
+}
@@ -0,0 +1,275 @@
+#include "TrainingBridges/Observation/ObservationNormalizer.h"
+
+void FObservationNormalizer::Initialize(int32 InNumRows, int32 InSize, float InClip, float InEpsilon)
+{
+    const bool bSizeChanged = FMath::Max(InSize, 0) != Size || Mean.Num() != Size;
+    NumRows = FMath::Max(InNumRows, 0);
+    Size = FMath::Max(InSize, 0);
+    Clip = InClip > 0.f ? InClip : TNumericLimits<float>::Max();
+    Epsilon = FMath::Max(InEpsilon, 0.f);
+
+    PendingRows.Init(0.f, NumRows * Size);
+    PendingMask.Init(0, NumRows);
+    BatchMean.Init(0.f, Size);
+    BatchM2.Init(0.f, Size);
+    if (bSizeChanged)
+    {
+        ResetStatistics();
+    }
+    else
+    {
+        UpdateScale();
+    }
+}
+
+void FObservationNormalizer::ResetStatistics()
+{
+    Mean.Init(0.f, Size);
+    Variance.Init(1.f, Size);
+    PendingMask.Init(0, NumRows);
+    Count = 1e-4;
+    UpdateScale();
+}
+
+void FObservationNormalizer::Normalize(int32 Row, TArrayView<float> Observation, bool bRecord)
+{
+    check(Row >= 0 && Row < NumRows);
+    const int32 NumValues = FMath::Min(Observation.Num(), Size);
+    if (bRecord)
+    {
+        FMemory::Memcpy(PendingRows.GetData() + Row * Size, Observation.GetData(), NumValues * sizeof(float));
+        PendingMask[Row] = 1;
+    }
+    NormalizeReadOnly(Observation);
+}
+
+void FObservationNormalizer::NormalizeReadOnly(TArrayView<float> Observation) const
+{
+    const int32 NumValues = FMath::Min(Observation.Num(), Size);
+    float* Values = Observation.GetData();
+    const float* MeanData = Mean.GetData();
+    const float* InvStdData = InvStd.GetData();
+
+    const VectorRegister4Float Upper = VectorSetFloat1(Clip);
+    const VectorRegister4Float Lower = VectorSetFloat1(-Clip);
+    int32 i = 0;
+    for (; i + 4 <= NumValues; i += 4)
+    {
+        const VectorRegister4Float Centered = VectorSubtract(VectorLoad(Values + i), VectorLoad(MeanData + i));
+        const VectorRegister4Float Scaled = VectorMultiply(Centered, VectorLoad(InvStdData + i));
+        VectorStore(VectorMin(VectorMax(Scaled, Lower), Upper), Values + i);
+    }
+    for (; i < NumValues; i++)
+    {
+        Values[i] = FMath::Clamp((Values[i] - MeanData[i]) * InvStdData[i], -Clip, Clip);
+    }
+}
+
+void FObservationNormalizer::Commit()
+{
+    int32 BatchCount = 0;
+    for (const uint8 bPending : PendingMask)
+    {
+        BatchCount += bPending;
+    }
+    if (BatchCount == 0 || Size == 0)
+    {
+        return;
+    }
+
+    float* BatchMeanData = BatchMean.GetData();
+    float* BatchM2Data = BatchM2.GetData();
+    FMemory::Memzero(BatchMeanData, Size * sizeof(float));
+    FMemory::Memzero(BatchM2Data, Size * sizeof(float));
+
+    // two passes over the batch: mean, then sum of squared deviations from it
+    for (int32 Row = 0; Row < NumRows; Row++)
+    {
+        if (!PendingMask[Row])
+        {
+            continue;
+        }
+        const float* RowData = PendingRows.GetData() + Row * Size;
+        int32 i = 0;
+        for (; i + 4 <= Size; i += 4)
+        {
+            VectorStore(VectorAdd(VectorLoad(BatchMeanData + i), VectorLoad(RowData + i)), BatchMeanData + i);
+        }
+        for (; i < Size; i++)
+        {
+            BatchMeanData[i] += RowData[i];
+        }
+    }
+
+    const float InvBatchCount = 1.f / BatchCount;
+    const VectorRegister4Float InvBatchCountVec = VectorSetFloat1(InvBatchCount);
+    int32 i = 0;
+    for (; i + 4 <= Size; i += 4)
+    {
+        VectorStore(VectorMultiply(VectorLoad(BatchMeanData + i), InvBatchCountVec), BatchMeanData + i);
+    }
+    for (; i < Size; i++)
+    {
+        BatchMeanData[i] *= InvBatchCount;
+    }
+
+    for (int32 Row = 0; Row < NumRows; Row++)
+    {
+        if (!PendingMask[Row])
+        {
+            continue;
+        }
+        const float* RowData = PendingRows.GetData() + Row * Size;
+        int32 j = 0;
+        for (; j + 4 <= Size; j += 4)
+        {
+            const VectorRegister4Float Delta = VectorSubtract(VectorLoad(RowData + j), VectorLoad(BatchMeanData + j));
+            VectorStore(VectorMultiplyAdd(Delta, Delta, VectorLoad(BatchM2Data + j)), BatchM2Data + j);
+        }
+        for (; j < Size; j++)
+        {
+            const float Delta = RowData[j] - BatchMeanData[j];
+            BatchM2Data[j] += Delta * Delta;
+        }
+        PendingMask[Row] = 0;
+    }
+
+    // merge: M2 = M2_a + M2_b + delta^2 * n_a * n_b / n, written as variances scaled by 1 / n
+    const double Total = Count + BatchCount;
+    const float MeanWeight = static_cast<float>(BatchCount / Total);
+    const float OldWeight = static_cast<float>(Count / Total);
+    const float BatchWeight = static_cast<float>(1.0 / Total);
+    const float DeltaWeight = static_cast<float>(Count * BatchCount / (Total * Total));
+
+    float* MeanData = Mean.GetData();
+    float* VarianceData = Variance.GetData();
+    const VectorRegister4Float MeanWeightVec = VectorSetFloat1(MeanWeight);
+    const VectorRegister4Float OldWeightVec = VectorSetFloat1(OldWeight);
+    const VectorRegister4Float BatchWeightVec = VectorSetFloat1(BatchWeight);
+    const VectorRegister4Float DeltaWeightVec = VectorSetFloat1(DeltaWeight);
+    i = 0;
+    for (; i + 4 <= Size; i += 4)
+    {
+        const VectorRegister4Float OldMean = VectorLoad(MeanData + i);
+        const VectorRegister4Float Delta = VectorSubtract(VectorLoad(BatchMeanData + i), OldMean);
+        VectorStore(VectorMultiplyAdd(Delta, MeanWeightVec, OldMean), MeanData + i);
+
+        VectorRegister4Float NewVariance = VectorMultiply(VectorLoad(VarianceData + i), OldWeightVec);
+        NewVariance = VectorMultiplyAdd(VectorLoad(BatchM2Data + i), BatchWeightVec, NewVariance);
+        NewVariance = VectorMultiplyAdd(VectorMultiply(Delta, Delta), DeltaWeightVec, NewVariance);
+        VectorStore(NewVariance, VarianceData + i);
+    }
+    for (; i < Size; i++)
+    {
+        const float Delta = BatchMeanData[i] - MeanData[i];
+        MeanData[i] += Delta * MeanWeight;
+        VarianceData[i] = VarianceData[i] * OldWeight + BatchM2Data[i] * BatchWeight + Delta * Delta * DeltaWeight;
+    }
+
+    Count = Total;
+    UpdateScale();
+}
+
+void FObservationNormalizer::UpdateScale()
+{
+    InvStd.SetNumUninitialized(Size);
+    for (int32 i = 0; i < Size; i++)
+    {
+        InvStd[i] = 1.f / FMath::Sqrt(FMath::Max(Variance[i], 0.f) + Epsilon);
+    }
+}
+
+FString FObservationNormalizer::ToString() const
+{
+    auto JoinValues = [](TConstArrayView<float> Values)
+    {
+        FString Joined;
+        for (int32 i = 0; i < Values.Num(); i++)
+        {
+            Joined += FString::Printf(i == 0 ? TEXT("%.9g") : TEXT(",%.9g"), Values[i]);
+        }
+        return Joined;
+    };
+
+    return FString::Printf(TEXT("COUNT=%.17g\nCLIP=%.9g\nEPSILON=%.9g\nMEAN=%s\nVAR=%s\n"),
+        Count, Clip, Epsilon, *JoinValues(Mean), *JoinValues(Variance));
+}
+
+bool FObservationNormalizer::FromString(const FString& Text)
+{
+    double ParsedCount = -1.0;
+    float ParsedClip = Clip;
+    float ParsedEpsilon = Epsilon;
+    TArray<float> ParsedMean;
+    TArray<float> ParsedVariance;
+
+    auto ParseValues = [](const FString& Values, TArray<float>& Out)
+    {
+        TArray<FString> Parts;
+        Values.ParseIntoArray(Parts, TEXT(","), true);
+        for (const FString& Part : Parts)
+        {
+            Out.Add(FCString::Atof(*Part.TrimStartAndEnd()));
+        }
+    };
+
+    TArray<FString> Lines;
+    Text.ParseIntoArrayLines(Lines);
+    for (const FString& Line : Lines)
+    {
+        FString Key, Value;
+        if (!Line.Split(TEXT("="), &Key, &Value))
+        {
+            continue;
+        }
+        Key.TrimStartAndEndInline();
+        if (Key == TEXT("COUNT"))
+        {
+            ParsedCount = FCString::Atod(*Value);
+        }
+        else if (Key == TEXT("CLIP"))
+        {
+            ParsedClip = FCString::Atof(*Value);
+        }
+        else if (Key == TEXT("EPSILON"))
+        {
+            ParsedEpsilon = FCString::Atof(*Value);
+        }
+        else if (Key == TEXT("MEAN"))
+        {
+            ParseValues(Value, ParsedMean);
+        }
+        else if (Key == TEXT("VAR"))
+        {
+            ParseValues(Value, ParsedVariance);
+        }
+    }
+
+    if (ParsedCount <= 0.0 || ParsedMean.Num() == 0 || ParsedMean.Num() != ParsedVariance.Num())
+    {
+        UE_LOG(LogTemp, Warning, TEXT("[FObservationNormalizer] Invalid statistics (COUNT=%g, %d mean, %d var values)."),
+            ParsedCount, ParsedMean.Num(), ParsedVariance.Num());
+        return false;
+    }
+    if (!IsInitialized())
+    {
+        Initialize(1, ParsedMean.Num(), ParsedClip, ParsedEpsilon);
+    }
+    else if (ParsedMean.Num() != Size)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("[FObservationNormalizer] Statistics have %d values, expected %d."), ParsedMean.Num(), Size);
+        return false;
+    }
+
+    Mean = MoveTemp(ParsedMean);
+    Variance = MoveTemp(ParsedVariance);
+    Count = ParsedCount;
+    Clip = ParsedClip > 0.f ? ParsedClip : TNumericLimits<float>::Max();
+    Epsilon = FMath::Max(ParsedEpsilon, 0.f);
+    for (uint8& bPending : PendingMask)
+    {
+        bPending = 0;
+    }
+    UpdateScale();
+    return true;
+}
@@ -0,0 +1,149 @@
+#include "TrainingBridges/Schema/ObservationSchema.h"
+
+namespace
+{
+    /** Names are written into the handshake, where ':' splits the parts of an entry, ',' the entries and ';' the keys. */
+    bool IsValidSchemaName(const FString& Name)
+    {
+        int32 Index = INDEX_NONE;
+        return !Name.FindChar(TEXT(':'), Index) && !Name.FindChar(TEXT(','), Index) && !Name.FindChar(TEXT(';'), Index);
+    }
+}
+
+int32 FObservationField::GetNumElements() const
+{
+    int32 NumElements = 1;
+    for (int32 Dim : Shape)
+    {
+        NumElements *= FMath::Max(Dim, 0);
+    }
+    return NumElements;
+}
+
+int32 FObservationField::GetElementSize() const
+{
+    switch (DType)
+    {
+    case EObservationDType::Float16: return 2;
+    case EObservationDType::UInt8:   return 1;
+    case EObservationDType::Int32:   return 4;
+    case EObservationDType::QInt8:   return 1;
+    case EObservationDType::QUInt16: return 2;
+    default:                         return 4;
+    }
+}
+
+int32 FObservationSchema::GetNumObservationValues() const
+{
+    int32 NumValues = 0;
+    for (const FObservationField& Field : Fields)
+    {
+        NumValues += Field.GetNumElements();
+    }
+    return NumValues;
+}
+
+int32 FObservationSchema::GetPackedObservationBytes() const
+{
+    int32 NumBytes = 0;
+    for (const FObservationField& Field : Fields)
+    {
+        NumBytes += Field.GetNumElements() * Field.GetElementSize();
+    }
+    return NumBytes;
+}
+
+int32 FObservationSchema::GetNumActionValues() const
+{
+    int32 NumValues = 0;
+    for (const FActionHead& Head : ActionHeads)
+    {
+        NumValues += Head.GetNumValues();
+    }
+    return NumValues;
+}
+
+bool FObservationSchema::Validate(FString& OutError) const
+{
+    for (const FObservationField& Field : Fields)
+    {
+        if (!IsValidSchemaName(Field.Name))
+        {
+            OutError = FString::Printf(TEXT("Field name '%s' must not contain ':', ',' or ';'."), *Field.Name);
+            return false;
+        }
+
+        // Python dequantizes with the Scale sent in the handshake, zero would wipe the field
+        if (Field.IsQuantized() && (Field.Scale == 0.f || !FMath::IsFinite(Field.Scale) || !FMath::IsFinite(Field.Offset)))
+        {
+            OutError = FString::Printf(TEXT("Quantized field '%s' needs a finite non zero Scale (got %g)."), *Field.Name, Field.Scale);
+            return false;
+        }
+    }
+    for (const FActionHead& Head : ActionHeads)
+    {
+        if (!IsValidSchemaName(Head.Name))
+        {
+            OutError = FString::Printf(TEXT("Action head name '%s' must not contain ':', ',' or ';'."), *Head.Name);
+            return false;
+        }
+        if (Head.Size < 1)
+        {
+            OutError = FString::Printf(TEXT("Action head '%s' needs a Size of at least 1 (got %d)."), *Head.Name, Head.Size);
+            return false;
+        }
+    }
+    return true;
+}
+
+FString FObservationSchema::ToHandshakeString() const
+{
+    if (IsEmpty())
+    {
+        return FString();
+    }
+
+    TArray<FString> FieldEntries;
+    for (const FObservationField& Field : Fields)
+    {
+        TArray<FString> Dims;
+        for (int32 Dim : Field.Shape)
+        {
+            Dims.Add(FString::FromInt(Dim));
+        }
+        FString Entry = FString::Printf(TEXT("%s:%s:%s"), *Field.Name, DTypeToString(Field.DType),
+            Dims.Num() > 0 ? *FString::Join(Dims, TEXT("x")) : TEXT("1"));
+        if (Field.IsQuantized())
+        {
+            // full float precision so Python dequantizes exactly like we quantize
+            Entry += FString::Printf(TEXT(":%.9g:%.9g"), Field.Scale, Field.Offset);
+        }
+        FieldEntries.Add(Entry);
+    }
+    FString Result = TEXT(";OBS_SCHEMA=") + FString::Join(FieldEntries, TEXT(","));
+
+    if (ActionHeads.Num() > 0)
+    {
+        TArray<FString> HeadEntries;
+        for (const FActionHead& Head : ActionHeads)
+        {
+            HeadEntries.Add(FString::Printf(TEXT("%s:%s:%d"), *Head.Name,
+                Head.Type == EActionHeadType::Discrete ? TEXT("disc") : TEXT("cont"), Head.Size));
+        }
+        Result += TEXT(";ACT_SCHEMA=") + FString::Join(HeadEntries, TEXT(","));
+    }
+    return Result;
+}
+
+const TCHAR* FObservationSchema::DTypeToString(EObservationDType DType)
+{
+    switch (DType)
+    {
+    case EObservationDType::Float16: return TEXT("float16");
+    case EObservationDType::UInt8:   return TEXT("uint8");
+    case EObservationDType::Int32:   return TEXT("int32");
+    case EObservationDType::QInt8:   return TEXT("qint8");
+    case EObservationDType::QUInt16: return TEXT("quint16");
+    default:                         return TEXT("float32");
+    }
+}
@@ -22,66 +22,48 @@ void USingleEnvBridge::UpdateRL_Implementation(float DeltaTime)
 {
 
     if (bIsTraining) {
-        // receive response
-        FString PythonMessage = ReceiveData();
-
-        // if command recieved
-        if (!PythonMessage.IsEmpty())
+        // worker (re)connected, start it from a fresh episode
+        if (TcpConnection->ConsumeJoinedEnvs().Num() > 0)
         {
-            FString ActionString = UPythonMsgParsingHelpers::ParseActionString(PythonMessage);
-            if (ActionString.Contains("RESET"))
-            {
-                // reset if simulation is done
-                HandleReset();
-                bIsActionRunning = false;
-                bool bDone = false;
-                float Reward = CalculateReward(bDone);
-                int32 DoneInt = bDone ? 1 : 0;
-                FString ObsStr = CreateStateString();
-                FString DataToSend = FString::Printf(TEXT("OBS=%sREW=%.2f;DONE=%d"),*ObsStr, Reward, DoneInt);
-                SendData(DataToSend);
-                return;
-            }
-            else {
-                // interpret response and apply given actions
-                HandleResponseActions(ActionString);
-
-                // Set action running to true
-                bIsActionRunning = true;
-            }
+            UE_LOG(LogTemp, Log, TEXT("[USingleEnvBridge] Env worker connected, resetting environment."));
+            StartEpisode();
         }
 
-        // check if an action is running
-        if (bIsActionRunning == true) {
-            bIsActionRunning = IsActionRunning();
-            // if action has concluded send state data as a result of the action
-            if (bIsActionRunning == false) {
-                bool bDone = false;
-                float Reward = CalculateReward(bDone);
-                int32 DoneInt = bDone ? 1 : 0;
-
-                FString ObsStr = CreateStateString();
-                FString DataToSend = FString::Printf(TEXT("OBS=%sREW=%.2f;DONE=%d"), *ObsStr, Reward, DoneInt);
-
-                // Send environment observation, reward, done to Python
-                SendData(DataToSend);
+        bool bSentObservation = StepTraining();
+
+        // same tick response: instead of picking the next action up on a later tick,
+        // briefly wait for Python's reply and apply it right away
+        for (int32 Waited = 0; bSameTickResponse && bSentObservation && Waited < MaxSameTickActions; Waited++)
+        {
+            if (!TcpConnection->WaitForEnvData(SameTickWaitSeconds))
+            {
+                break;
             }
+            bSentObservation = StepTraining();
         }
-
     }
     else if (bIsInference) {
         // if inference mode, run inference through loaded model instead
         // inference is tick driven rather then on demand
 
         if (bIsActionRunning == true) {
-            bIsActionRunning = IsActionRunning();
+            bIsActionRunning = IsHoldingAction(ActionReadyFrame) || IsActionRunning();
 
+            // nobody sends RESET here, an episode that ended starts over before the next action
+            bool bDone = false;
+            if (!bIsActionRunning) {
+                CalculateReward(bDone);
+            }
+            if (bDone) {
+                StartEpisode();
+            }
         }
         else {
             FString ActionResponse = RunLocalModelInference(CreateStateString());
             if (!ActionResponse.IsEmpty()) {
                 HandleResponseActions(ActionResponse);
                 bIsActionRunning = true;
+                ActionReadyFrame = GetActionReadyFrame();
             }
         }
 
@@ -90,6 +72,111 @@ void USingleEnvBridge::UpdateRL_Implementation(float DeltaTime)
 
 }
 
+bool USingleEnvBridge::StepTraining()
+{
+    // receive response
+    FString PythonMessage = ReceiveData();
+
+    // if command recieved
+    if (!PythonMessage.IsEmpty())
+    {
+        FString ActionString = UPythonMsgParsingHelpers::ParseActionString(PythonMessage);
+        if (ActionString.Contains("RESET"))
+        {
+            // reset if simulation is done
+            StartEpisode();
+            bool bDone = false;
+            float Reward = CalculateReward(bDone);
+            SendObservation(Reward, bDone);
+            bStepCompletedThisUpdate = true;
+            return true;
+        }
+        else {
+            // interpret response and apply given actions
+            HandleResponseActions(ActionString);
+
+            // Set action running to true
+            bIsActionRunning = true;
+            ActionReadyFrame = GetActionReadyFrame();
+        }
+    }
+
+    // check if an action is running
+    // checked right after applying, so instant actions are answered in the same tick
+    if (bIsActionRunning == true) {
+        // hold the action for its fixed sub-steps before asking the environment
+        bIsActionRunning = IsHoldingAction(ActionReadyFrame) || IsActionRunning();
+        // if action has concluded send state data as a result of the action
+        if (bIsActionRunning == false) {
+            bool bDone = false;
+            float Reward = CalculateReward(bDone);
+
+            // Send environment observation, reward, done to Python
+            SendObservation(Reward, bDone);
+            bStepCompletedThisUpdate = true;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void USingleEnvBridge::StartEpisode()
+{
+    HandleReset();
+
+    // recurrent models and stacked frames start every episode from scratch, whatever HandleReset does
+    ResetInferenceState(0);
+    FrameStack.ResetRow(0);
+    bIsActionRunning = false;
+    ActionReadyFrame = 0;
+}
+
+void USingleEnvBridge::SendObservation(float Reward, bool bDone)
+{
+    int32 DoneInt = bDone ? 1 : 0;
+    FString ObsStr = CreateStateString();
+
+    if (UsesObservationSchema() || UsesFrameStack() || UsesObservationNormalization()) {
+        // state string values first, sensors write their values after them
+        ObservationScratch.SetNumUninitialized(ObservationSpaceSize);
+        TArrayView<float> Observation(ObservationScratch);
+        UBPFL_DataHelpers::ParseStateStringInto(ObsStr, Observation.Left(StateObservationSize));
+
+        // unstacked sensor observations are packed straight from the sensors, pixels never become floats
+        const bool bPackSensors = UsesObservationSchema() && HasObservationSensors() && !UsesFrameStack();
+        if (!bPackSensors) {
+            WriteSensorObservations(0, Observation);
+        }
+
+        if (UsesObservationNormalization()) {
+            // normalized with the statistics so far, then folded into them
+            ObservationNormalizer.Normalize(0, Observation, ShouldUpdateNormalizationStats());
+            ObservationNormalizer.Commit();
+        }
+
+        // with stacking the last FrameStackDepth frames go out back to back
+        const TConstArrayView<float> Sent = UsesFrameStack() ? FrameStack.Push(0, ObservationScratch) : TConstArrayView<float>(ObservationScratch);
+
+        if (UsesObservationSchema()) {
+            // packed binary observation, reward and done stay in the text header
+            const FString Header = FString::Printf(TEXT("REW=%.2f;DONE=%d"), Reward, DoneInt);
+            if (bPackSensors) {
+                SendPackedSensorObservation(0, Header, Observation.Left(StateObservationSize));
+                return;
+            }
+            const TConstArrayView<float> Observations[] = { Sent };
+            SendPackedObservation(Header, Observations);
+            return;
+        }
+        // schema-less frame stacking or normalization, sensors always come with a schema
+        ObsStr = UBPFL_DataHelpers::ArrayViewToStateString(Sent, 2) + TEXT(";");
+    }
+
+    FString DataToSend = FString::Printf(TEXT("OBS=%sREW=%.2f;DONE=%d"), *ObsStr, Reward, DoneInt);
+    SendData(DataToSend);
+}
+
 // -------------------------------------------------------------------------
 // Environment Callbacks 
 // -------------------------------------------------------------------------
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Math/RandomStream.h"
+#include "PolicyActionSampler.generated.h"
+
+/** How a policy head turns its slice of the model output into actions. */
+UENUM(BlueprintType)
+enum class EPolicyHeadType : uint8
+{
+	/** Size values passed through unchanged. */
+	Deterministic,
+	/** Size logits, one choice index. Several categorical heads form a multi-discrete action. */
+	Categorical,
+	/** Size means followed by Size log stds (unless LogStd is set), Size values. */
+	Gaussian,
+	/** Gaussian followed by tanh, rescaled to [ActionLow, ActionHigh] (SAC style), Size values. */
+	SquashedGaussian
+};
+
+/**
+ * One action head of a policy output. Heads read consecutive slices of the model output per agent
+ * and write consecutive action values, in declaration order.
+ */
+USTRUCT(BlueprintType)
+struct UERLPLUGIN_API FPolicyHead
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Inference")
+	FString Name;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Inference")
+	EPolicyHeadType Type = EPolicyHeadType::Deterministic;
+
+	/** Categorical: number of choices. Otherwise: number of action values. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Inference", meta = (ClampMin = "1"))
+	int32 Size = 1;
+
+	/**
+	 * Gaussian heads: state independent log stds (one per value, or a single one for all), e.g. the log_std
+	 * parameter of a stable-baselines3 PPO policy. Empty if the model outputs them after the means.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Inference")
+	TArray<float> LogStd;
+
+	/** Gaussian heads: log stds are clamped to this range before use. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Inference")
+	float LogStdMin = -20.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Inference")
+	float LogStdMax = 2.f;
+
+	/** Squashed Gaussian heads: action bounds the tanh output is rescaled to. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Inference", meta = (EditCondition = "Type == EPolicyHeadType::SquashedGaussian"))
+	float ActionLow = -1.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Inference", meta = (EditCondition = "Type == EPolicyHeadType::SquashedGaussian"))
+	float ActionHigh = 1.f;
+
+	/** Model output values this head reads per agent. */
+	int32 GetNumInputs() const;
+
+	/** Action values this head writes per agent. */
+	int32 GetNumActions() const { return Type == EPolicyHeadType::Categorical ? 1 : Size; }
+};
+
+/**
+ * Turns raw policy outputs into actions: argmax or sampled categorical choices, Gaussian and squashed Gaussian
+ * samples, together with their log probability.
+ *
+ * Every agent owns a random stream seeded from (Seed, AgentId), so an agent's actions only depend on its own
+ * observations and call count, not on which other agents share the batch. Deterministic mode takes the mode of
+ * every distribution (argmax / mean) and never touches the streams.
+ */
+struct UERLPLUGIN_API FPolicyActionSampler
+{
+public:
+	/**
+	 * Sets the heads and reseeds every agent stream.
+	 * Returns false and leaves the sampler unconfigured if a Gaussian head has a LogStd count other than 0, 1 or Size.
+	 */
+	bool Configure(const TArray<FPolicyHead>& InHeads, int32 InSeed);
+
+	/** Restarts the stream of AgentId, or of every agent if negative, from its seed. */
+	void ResetStreams(int32 AgentId = -1);
+
+	/**
+	 * Converts [AgentIds.Num() x GetNumInputs()] model outputs into [AgentIds.Num() x GetNumActions()] actions.
+	 * OutLogProbs, if given, receives one joint log probability per agent.
+	 */
+	bool Sample(TConstArrayView<int32> AgentIds, TConstArrayView<float> ModelOutputs, bool bDeterministic,
+		TArray<float>& OutActions, TArray<float>* OutLogProbs = nullptr);
+
+	/** Action string of one agent, categorical choices as integers and other values with two decimals. */
+	FString ToActionString(TConstArrayView<float> Actions) const;
+
+	bool IsConfigured() const { return Heads.Num() > 0; }
+	int32 GetNumInputs() const { return NumInputs; }
+	int32 GetNumActions() const { return NumActions; }
+
+private:
+	/** Grows the stream array to cover AgentId. */
+	FRandomStream& GetStream(int32 AgentId);
+
+	/** Standard normal sample, Box-Muller on two uniforms. */
+	static float SampleNormal(FRandomStream& Stream);
+
+	TArray<FPolicyHead> Heads;
+	TArray<FRandomStream> Streams;
+	int32 Seed = 0;
+	int32 NumInputs = 0;
+	int32 NumActions = 0;
+
+	/** Softmax probabilities of a categorical head, reused. */
+	TArray<float> ProbabilityScratch;
+};
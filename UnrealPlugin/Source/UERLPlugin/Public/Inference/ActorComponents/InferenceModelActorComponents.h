@@ -3,6 +3,7 @@
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
 #include "Inference/InferenceInterfaces/InferenceInterface.h"
+#include "TrainingBridges/Observation/ObservationFrameStack.h"
 #include "InferenceModelActorComponents.generated.h"
 
 /**
@@ -29,6 +30,12 @@ protected:
     // Flag to determine if we are waiting for the current action to finish.
     bool bIsWaitingForAction = false;
 
+    // Last FrameStackDepth observations fed to the model
+    FObservationFrameStack FrameStack;
+
+    // Actions of a stacked inference run, reused
+    TArray<float> ActionScratch;
+
     // Run inference using loaded model
     FString RunLocalModelInference(const FString& Observation);
 
@@ -44,6 +51,15 @@ public:
     UFUNCTION(BlueprintCallable, Category = "RLBridge")
     virtual void StopInference();
 
+    // Number of most recent observations fed to the model, oldest first.
+    // Must match the FrameStackDepth of the bridge the model was trained with.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "RLBridge", meta = (ClampMin = "1"))
+    int32 FrameStackDepth = 1;
+
+    // Clears the observation history and the model's recurrent state, call it when the episode restarts.
+    UFUNCTION(BlueprintCallable, Category = "RLBridge")
+    void ResetObservationHistory();
+
     // Called before or during inference mode: load your model inference interface. 
     // Returns true if loaded succesfully
     UFUNCTION(BlueprintCallable, Category = "RLBridge")
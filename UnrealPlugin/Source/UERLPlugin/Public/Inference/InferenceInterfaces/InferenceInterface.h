@@ -2,12 +2,27 @@
 
 #include "CoreMinimal.h"
 #include "UObject/Object.h"
+#include "Inference/ActionSampling/PolicyActionSampler.h"
 #include "InferenceInterface.generated.h"
 
+/** Outcome of UInferenceInterface::ApplyPendingModel(). */
+enum class EPendingModelResult : uint8
+{
+	/** No model finished since the last call. */
+	None,
+	/** The model is active now. */
+	Loaded,
+	/** The model could not be built, the previous one keeps running. */
+	Failed
+};
+
 /**
  * Base class for inference models.
  * Provides Blueprint-callable functions to load a model and run inference.
  * This base implementation does nothing and should be overridden.
+ *
+ * With PolicyHeads set, the raw model output is treated as distribution parameters (logits, means, log stds)
+ * and converted to actions by the shared action sampler after every run.
  */
 UCLASS(Blueprintable)
 class UERLPLUGIN_API UInferenceInterface : public UObject
@@ -22,10 +37,94 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Inference")
 	virtual bool LoadModel(const FString& ModelPath);
 
+	/** Loads the model from memory, same format as the model file, e.g. weights streamed over the admin socket.
+	 *  @return True if the model loads successfully. Base implementation does not support in-memory models.
+	 */
+	virtual bool LoadModelFromMemory(TConstArrayView<uint8> ModelBytes);
+
+	/** Prepares a model from memory without stalling the caller. The current model keeps running until
+	 *  ApplyPendingModel() swaps the new one in. Base implementation loads synchronously.
+	 *  @param Version Tag of the model, reported back by ApplyPendingModel().
+	 *  @return False if the model is rejected right away, otherwise ApplyPendingModel() reports the outcome.
+	 */
+	virtual bool LoadModelFromMemoryAsync(TArray<uint8>&& ModelBytes, int32 Version = 0);
+
+	/** Swaps in the model prepared by LoadModelFromMemoryAsync(), if it is ready. Call between runs.
+	 *  @param OutVersion Receives the version of the finished model, unless the result is None.
+	 *  @return Loaded if the model is active now, Failed if it could not be built.
+	 */
+	virtual EPendingModelResult ApplyPendingModel(int32& OutVersion);
+
 	/** Runs inference given an array of float observations.
 	 *  @param Observation An array of floats representing the input.
 	 *  @return A comma-separated string representing the output actions.
 	 */
 	UFUNCTION(BlueprintCallable, Category = "Inference")
 	virtual FString RunInference(const TArray<float>& Observation);
+
+	/** Runs inference for one agent. Recurrent models read and update the hidden state of AgentId,
+	 *  stateless models ignore it.
+	 *  @return A comma-separated string representing the output actions.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Inference")
+	virtual FString RunInferenceForAgent(int32 AgentId, const TArray<float>& Observation);
+
+	/** Runs inference for several agents at once.
+	 *  @param AgentIds Agents of the batch, selects their hidden states for recurrent models.
+	 *  @param Observations [AgentIds.Num() x ObsSize] observations, agent-major.
+	 *  @param OutActions Receives [AgentIds.Num() x ActSize] actions.
+	 *  @return True on success. Default implementation runs RunInferenceForAgent per agent.
+	 */
+	virtual bool RunInferenceBatch(TConstArrayView<int32> AgentIds, TConstArrayView<float> Observations, TArray<float>& OutActions);
+
+	/** Clears the recurrent state of AgentId, or of every agent if AgentId is negative. */
+	UFUNCTION(BlueprintCallable, Category = "Inference")
+	virtual void ResetState(int32 AgentId = -1);
+
+	/** True if the model carries hidden state between calls, which the bridges' reset callbacks clear. */
+	UFUNCTION(BlueprintCallable, Category = "Inference")
+	virtual bool IsRecurrent() const;
+
+	/** Replaces PolicyHeads and SamplingSeed and restarts every agent's random stream. */
+	UFUNCTION(BlueprintCallable, Category = "Inference|Sampling")
+	void SetPolicyHeads(const TArray<FPolicyHead>& Heads, int32 Seed = 0);
+
+	/** Joint log probability of the actions of each agent of the last run, empty without PolicyHeads. */
+	UFUNCTION(BlueprintCallable, Category = "Inference|Sampling")
+	TArray<float> GetLastLogProbs() const { return LastLogProbs; }
+
+	/** Restarts the random stream of AgentId, or of every agent if negative, for reproducible rollouts. */
+	UFUNCTION(BlueprintCallable, Category = "Inference|Sampling")
+	void ResetSampling(int32 AgentId = -1);
+
+	/** Distribution heads of the model output, in output order. Empty passes the output through as actions. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Inference|Sampling")
+	TArray<FPolicyHead> PolicyHeads;
+
+	/** Seed of the per agent random streams. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Inference|Sampling")
+	int32 SamplingSeed = 0;
+
+	/** Take the most likely action (argmax / mean) instead of sampling. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Inference|Sampling")
+	bool bDeterministicActions = false;
+
+protected:
+	/** Configures the sampler from PolicyHeads and SamplingSeed, subclasses call this after loading a model. */
+	void ConfigurePolicyHeads();
+
+	/** Fills OutActions with the actions for ModelOutputs of AgentIds, sampled if PolicyHeads are configured. */
+	bool ApplyPolicyHeads(TConstArrayView<int32> AgentIds, TConstArrayView<float> ModelOutputs, TArray<float>& OutActions);
+
+	/** Action string of one agent, discrete choices without decimals. */
+	FString FormatActions(TConstArrayView<float> Actions) const;
+
+	FPolicyActionSampler ActionSampler;
+
+	/** Per agent log probabilities of the last ApplyPolicyHeads(). */
+	TArray<float> LastLogProbs;
+
+	/** Outcome of the synchronous LoadModelFromMemoryAsync() that ApplyPendingModel() has not reported yet. */
+	EPendingModelResult LoadedModelResult = EPendingModelResult::None;
+	int32 LoadedModelVersion = 0;
 };
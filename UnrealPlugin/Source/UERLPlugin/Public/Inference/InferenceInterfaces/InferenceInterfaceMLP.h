@@ -0,0 +1,123 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "InferenceInterface.h"
+#include "Math/Float16.h"
+#include "InferenceInterfaceMLP.generated.h"
+
+/** Activation applied after a dense layer. Values match the weight file. */
+UENUM(BlueprintType)
+enum class EMLPActivation : uint8
+{
+	None = 0,
+	ReLU = 1,
+	Tanh = 2,
+	Sigmoid = 3
+};
+
+/** Storage of a layer's weights. Values match the weight file. */
+UENUM(BlueprintType)
+enum class EMLPWeightType : uint8
+{
+	Float32 = 0,
+	/** Half precision weights, half the memory traffic. */
+	Float16 = 1,
+	/** Symmetric int8 with one float scale per output row, a quarter of the memory traffic. */
+	Int8 = 2
+};
+
+/**
+ * Dependency free inference for plain MLP policies (a stack of dense layers), evaluated with SIMD kernels.
+ * For small policies (e.g. 2x64) this skips the fixed per-run cost of ONNX Runtime and works on every platform.
+ *
+ * Models are loaded from the weight file written by PythonEnv/export_mlp.py (from a stable-baselines3 zip or an
+ * ONNX graph made of Gemm/MatMul+Add and activation nodes):
+ *   "UEMLP1\0\0", uint32 NumLayers, then per layer uint32 InSize, uint32 OutSize, uint32 Activation,
+ *   float32 Weights[OutSize x InSize] (row-major), float32 Bias[OutSize]. All little endian.
+ * "UEMLP2\0\0" files add uint32 WeightType after Activation; Float16 layers store uint16 weights,
+ * Int8 layers store float32 Scales[OutSize] followed by int8 weights. Bias stays float32.
+ *
+ * Weight rows are padded to a multiple of 4 floats and 16 byte aligned. A batch is evaluated tile by tile:
+ * four weight rows stay in L1 while every observation of the batch is multiplied against them.
+ * Float16 and Int8 tiles are expanded to float once per tile, so their cost is amortized over the batch
+ * while the weights take half or a quarter of the memory (weight-only quantization, activations stay float).
+ */
+UCLASS(Blueprintable)
+class UERLPLUGIN_API UInferenceInterfaceMLP : public UInferenceInterface
+{
+	GENERATED_BODY()
+
+public:
+	// Overrides from UInferenceInterface
+	virtual bool LoadModel(const FString& ModelPath) override;
+	virtual bool LoadModelFromMemory(TConstArrayView<uint8> ModelBytes) override { return LoadFromMemory(ModelBytes); }
+	virtual FString RunInference(const TArray<float>& Observation) override;
+	virtual bool RunInferenceBatch(TConstArrayView<int32> AgentIds, TConstArrayView<float> Observations, TArray<float>& OutActions) override;
+
+	/** Returns true if the model is loaded successfully. */
+	UFUNCTION(BlueprintCallable, Category = "Inference")
+	bool IsModelLoaded() const { return Layers.Num() > 0; }
+
+	/** Observation values the first layer expects, 0 before loading. */
+	UFUNCTION(BlueprintCallable, Category = "Inference")
+	int32 GetInputSize() const;
+
+	/** Values of the last layer per observation, 0 before loading. */
+	UFUNCTION(BlueprintCallable, Category = "Inference")
+	int32 GetOutputSize() const;
+
+	/**
+	 * Loads a model from memory, same layout as the weight file. Used by LoadModel() and for weights that
+	 * don't come from disk.
+	 */
+	bool LoadFromMemory(TConstArrayView<uint8> Data);
+
+protected:
+	/** One dense layer, y = Activation(W x + b). */
+	struct FDenseLayer
+	{
+		int32 InSize = 0;
+		int32 OutSize = 0;
+
+		/** InSize rounded up to a multiple of 4, the row stride of Weights and of the layer input. */
+		int32 InStride = 0;
+
+		EMLPActivation Activation = EMLPActivation::None;
+		EMLPWeightType WeightType = EMLPWeightType::Float32;
+
+		/** [OutSize rounded up to 4 x InStride], padding is zero. Only the array of WeightType is filled. */
+		TArray<float, TAlignedHeapAllocator<16>> Weights;
+		TArray<FFloat16> HalfWeights;
+		TArray<int8> Int8Weights;
+
+		/** Int8: [OutSize rounded up to 4] dequantization scale per row. */
+		TArray<float> RowScales;
+
+		/** [OutSize rounded up to 4], padding is zero. */
+		TArray<float, TAlignedHeapAllocator<16>> Bias;
+	};
+
+	/**
+	 * Evaluates Layer for BatchSize rows of Input (stride InStride) into Output (stride OutStride).
+	 * TileScratch holds 4 x InStride floats for quantized weight tiles.
+	 */
+	static void EvaluateLayer(const FDenseLayer& Layer, const float* Input, int32 BatchSize, float* Output, int32 OutStride, float* TileScratch);
+
+	TArray<FDenseLayer> Layers;
+
+	/** Ping-pong activations, [Batch x widest layer stride], reused. */
+	TArray<float, TAlignedHeapAllocator<16>> ActivationsA;
+	TArray<float, TAlignedHeapAllocator<16>> ActivationsB;
+
+	/** Float copy of one quantized weight tile, [4 x MaxStride]. */
+	TArray<float, TAlignedHeapAllocator<16>> TileScratch;
+
+	/** Widest input or output stride of any layer. */
+	int32 MaxStride = 0;
+
+	/** Unpadded outputs of the last batch, handed to the policy heads. */
+	TArray<float> OutputScratch;
+
+	/** Actions of a single agent run, reused. */
+	TArray<float> ActionScratch;
+};
@@ -2,18 +2,54 @@
 
 #include "CoreMinimal.h"
 #include "InferenceInterface.h"
-#include <onnxruntime_cxx_api.h>
+#include "Async/Future.h"
+#include "HAL/CriticalSection.h"
+// The training header includes onnxruntime_cxx_api.h after declaring what UOnnxPolicyTrainer needs from it,
+// so both can share a translation unit in any include order
+#include <onnxruntime_training_cxx_api.h>
 #include <memory>
+#include <string>
+#include <vector>
 #include "InferenceInterfaceOnnx.generated.h"
 
 struct Ort::Session;
 struct Ort::Env;
 struct Ort::SessionOptions;
 
+/** Pairs a recurrent state input of the graph with the output that carries its next value. */
+USTRUCT(BlueprintType)
+struct UERLPLUGIN_API FRecurrentStateSpec
+{
+	GENERATED_BODY()
+
+	/** Graph input fed with the previous state, e.g. "h_in". */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Inference")
+	FString InputName;
+
+	/** Graph output holding the next state, e.g. "h_out". */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Inference")
+	FString OutputName;
+};
+
 /**
  * ONNX-based implementation of the inference interface.
  * Implements model loading and inference using ONNX Runtime.
- * When converting to Onnx, make sure input_names=["obs"] and output_names=["actions"].
+ * When converting to Onnx, make sure input_names=["obs"] and output_names=["actions"],
+ * or set ObservationInputName/ActionOutputName before LoadModel().
+ *
+ * Recurrent models (LSTM/GRU) export their state as extra inputs and outputs, e.g.
+ * input_names=["obs", "h_in", "c_in"], output_names=["actions", "h_out", "c_out"].
+ * Each state tensor keeps one row per agent in a contiguous [Agents x StateSize] buffer; a batch gathers
+ * the rows of its agents into the input tensor and scatters the outputs back after the run.
+ * Batches of consecutive agents on a batch-major state are fed straight from the buffer without a gather.
+ *
+ * Quantized models load like any other: INT8 graphs from onnxruntime.quantization (quantize_dynamic or static QDQ)
+ * keep float observations and actions, FP16 graphs may also take and return float16, which is converted here.
+ * Compare a quantized model against its original with UBPFL_InferenceHelpers::CompareOnRecordedObservations().
+ *
+ * LoadModelFromMemoryAsync() builds the session from streamed bytes on a thread pool worker while the current
+ * session keeps running; ApplyPendingModel() swaps it in between runs. Models arriving during a build wait for it,
+ * only the newest of them is built next.
  */
 UCLASS(Blueprintable)
 class UERLPLUGIN_API UInferenceInterfaceOnnx : public UInferenceInterface
@@ -26,13 +62,89 @@ public:
 
 	// Overrides from UInferenceInterface
 	virtual bool LoadModel(const FString& ModelPath) override;
+	virtual bool LoadModelFromMemory(TConstArrayView<uint8> ModelBytes) override;
+	virtual bool LoadModelFromMemoryAsync(TArray<uint8>&& ModelBytes, int32 Version = 0) override;
+	virtual EPendingModelResult ApplyPendingModel(int32& OutVersion) override;
 	virtual FString RunInference(const TArray<float>& Observation) override;
+	virtual FString RunInferenceForAgent(int32 AgentId, const TArray<float>& Observation) override;
+	virtual bool RunInferenceBatch(TConstArrayView<int32> AgentIds, TConstArrayView<float> Observations, TArray<float>& OutActions) override;
+	virtual void ResetState(int32 AgentId = -1) override;
+	virtual bool IsRecurrent() const override;
 
 	/** Returns true if the model is loaded successfully. */
 	UFUNCTION(BlueprintCallable, Category = "Inference")
 	bool IsModelLoaded() const;
 
+	/** Graph input that receives the observation batch. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Inference")
+	FString ObservationInputName = TEXT("obs");
+
+	/** Graph output that holds the action batch. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Inference")
+	FString ActionOutputName = TEXT("actions");
+
+	/**
+	 * Recurrent state inputs and their outputs. If empty, LoadModel() pairs every other input
+	 * named "<x>_in" with an output named "<x>_out".
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Inference")
+	TArray<FRecurrentStateSpec> RecurrentStates;
+
+	/** Agents whose hidden state is allocated on load. Higher agent ids grow the buffers on first use. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Inference", meta = (ClampMin = "1"))
+	int32 MaxAgents = 1;
+
 private:
+	/** One recurrent state tensor and its per-agent storage. */
+	struct FStateTensor
+	{
+		std::string InputName;
+		std::string OutputName;
+
+		/** Model shape, the batch dimension is replaced per run. */
+		std::vector<int64_t> Shape;
+		int32 BatchAxis = 0;
+
+		/** Product of the dims before / after the batch axis, a row holds Outer x Inner values. */
+		int64 OuterSize = 1;
+		int64 InnerSize = 1;
+		int64 RowSize() const { return OuterSize * InnerSize; }
+
+		/** [Agents x RowSize] hidden state, agent-major. */
+		TArray<float> Buffer;
+
+		/** Batch layout input/output, reused across runs. */
+		TArray<float> InputScratch;
+		TArray<float> OutputScratch;
+	};
+
+	/** Creates the shared environment and session options on first use. */
+	static void EnsureEnvironment();
+
+	/** Reads the input/output names of the session and sets up the recurrent state tensors. Catches Ort errors. */
+	bool BindModelIO();
+
+	/** BindModelIO() without the try/catch, Ort type info queries throw Ort::Exception. */
+	bool BindModelIOUnguarded();
+
+	/**
+	 * Makes NewSession the active session. If its inputs and outputs don't bind, the previous session stays.
+	 * Hidden states restart, sampling streams keep running.
+	 */
+	bool InstallSession(std::unique_ptr<Ort::Session> NewSession);
+
+	/** Builds a session from ModelBytes on the thread pool into PendingSession. */
+	void StartPendingBuild(TArray<uint8>&& ModelBytes, int32 Version);
+
+	/** Grows every state buffer to hold NumAgents rows, new rows start zeroed. */
+	void EnsureAgentCapacity(int32 NumAgents);
+
+	/** Returns a batch layout view of the states of AgentIds, pointing into Buffer when no gather is needed. */
+	float* GatherState(FStateTensor& State, TConstArrayView<int32> AgentIds);
+
+	/** Writes the batch layout OutputScratch back into the rows of AgentIds. */
+	void ScatterState(FStateTensor& State, TConstArrayView<int32> AgentIds);
+
 	// Global ONNX environment and session options shared by all instances.
 	static std::unique_ptr<Ort::Env> GEnv;
 	static std::unique_ptr<Ort::SessionOptions> GSessionOptions;
@@ -40,4 +152,38 @@ private:
 	// The ONNX Runtime session for this model.
 	// TODO: NOT THREAD SAFE FIX LATER
 	std::unique_ptr<Ort::Session> SessionPtr;
+
+	// Session built by StartPendingBuild(), guarded by PendingSessionLock, null if the build failed
+	std::unique_ptr<Ort::Session> PendingSession;
+	FCriticalSection PendingSessionLock;
+	TFuture<void> PendingBuild;
+	int32 PendingBuildVersion = 0;
+
+	// Newest model bytes that arrived while a build was running, built once the running build is installed
+	TArray<uint8> QueuedModelBytes;
+	int32 QueuedModelVersion = 0;
+	bool bHasQueuedModel = false;
+
+	// Recurrent state tensors, fixed after BindModelIO()
+	std::vector<FStateTensor> StateTensors;
+
+	// Rows allocated per state buffer
+	int32 NumAgentRows = 0;
+
+	// Run names: observation/actions first, then the state tensors in order
+	std::string ObservationName;
+	std::string ActionName;
+	std::vector<const char*> InputNames;
+	std::vector<const char*> OutputNames;
+
+	// Actions of a single agent run, reused
+	TArray<float> ActionScratch;
+
+	// Element types of the observation input and action output, float or float16
+	ONNXTensorElementDataType ObservationElementType = ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT;
+	ONNXTensorElementDataType ActionElementType = ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT;
+
+	// Conversion buffers for float16 graphs, reused
+	TArray<Ort::Float16_t> ObservationHalfScratch;
+	TArray<float> ActionFloatScratch;
 };
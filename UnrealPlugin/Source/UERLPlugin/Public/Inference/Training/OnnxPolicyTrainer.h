@@ -0,0 +1,144 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Object.h"
+#include <onnxruntime_training_cxx_api.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include "OnnxPolicyTrainer.generated.h"
+
+class UInferenceInterfaceOnnx;
+
+/**
+ * In-engine policy training with the ONNX Runtime training API.
+ * Loads the artifacts written by PythonEnv/export_training_artifacts.py (or onnxruntime.training.artifacts.generate_artifacts):
+ *   training_model.onnx, eval_model.onnx, optimizer_model.onnx and checkpoint,
+ * and runs gradient steps on experience collected in-process, so small on-policy tasks and in-game fine-tuning
+ * need no Python round trip.
+ *
+ * The training graph computes the loss itself (its first output) from named float inputs, e.g. the PPO graph takes
+ * "obs", "taken_actions", "old_log_probs", "advantages" and "returns". Experience is a set of columns, one per graph input,
+ * each holding NumSamples rows of a fixed width. Train() shuffles the samples and runs NumEpochs passes of
+ * mini-batches: TrainStep, OptimizerStep, LazyResetGrad.
+ *
+ * Requires an ONNX Runtime build with training support (onnxruntime-training). With the plain inference build
+ * LoadArtifacts() fails with a log message and the trainer stays unusable.
+ * Training runs synchronously on the calling thread.
+ */
+UCLASS(Blueprintable)
+class UERLPLUGIN_API UOnnxPolicyTrainer : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	UOnnxPolicyTrainer();
+	virtual ~UOnnxPolicyTrainer();
+
+	/** True if the linked ONNX Runtime exposes the training API. */
+	UFUNCTION(BlueprintCallable, Category = "Training")
+	static bool IsTrainingSupported();
+
+	/**
+	 * Loads training, eval and optimizer graphs and the checkpoint from ArtifactsDirectory.
+	 * @return True if the training session was created.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Training")
+	bool LoadArtifacts(const FString& ArtifactsDirectory);
+
+	/** Returns true once LoadArtifacts() succeeded. */
+	UFUNCTION(BlueprintCallable, Category = "Training")
+	bool IsLoaded() const { return SessionPtr != nullptr; }
+
+	/** User inputs of the training graph, the columns Train() expects. */
+	UFUNCTION(BlueprintCallable, Category = "Training")
+	TArray<FString> GetTrainingInputNames() const;
+
+	/**
+	 * Appends one sample row to the column InputName. The first row of a column fixes its width.
+	 * Call it once per input and step, e.g. for "obs", "taken_actions" and "advantages".
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Training")
+	bool AddSample(const FString& InputName, const TArray<float>& Values);
+
+	/** Drops every collected sample. */
+	UFUNCTION(BlueprintCallable, Category = "Training")
+	void ClearSamples();
+
+	/** Samples collected in the column InputName. */
+	UFUNCTION(BlueprintCallable, Category = "Training")
+	int32 GetNumSamples(const FString& InputName) const;
+
+	/**
+	 * Trains on the samples collected with AddSample() and clears them.
+	 * @return Mean loss over all mini-batches, negative on failure.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Training")
+	float TrainOnSamples();
+
+	/**
+	 * Trains on NumSamples rows per column. Every training graph input needs a column of NumSamples x width values.
+	 * @return Mean loss over all mini-batches, negative on failure.
+	 */
+	float Train(const TMap<FString, TArray<float>>& Columns, int32 NumSamples);
+
+	/** Saves parameters and optimizer state to resume training later. */
+	UFUNCTION(BlueprintCallable, Category = "Training")
+	bool SaveCheckpoint(const FString& CheckpointPath, bool bIncludeOptimizerState = true);
+
+	/** Writes an inference graph with the outputs PolicyOutputNames, loadable by UInferenceInterfaceOnnx. */
+	UFUNCTION(BlueprintCallable, Category = "Training")
+	bool ExportPolicy(const FString& ModelPath);
+
+	/** Exports the current policy to ModelPath and reloads Interface from it, so agents act with the new weights. */
+	UFUNCTION(BlueprintCallable, Category = "Training")
+	bool UpdateInferenceInterface(UInferenceInterfaceOnnx* Interface, const FString& ModelPath);
+
+	/** Gradient steps taken since loading. */
+	UFUNCTION(BlueprintCallable, Category = "Training")
+	int32 GetNumUpdates() const { return NumUpdates; }
+
+	/** Optimizer learning rate, applied before every Train(). */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Training", meta = (ClampMin = "0"))
+	float LearningRate = 3e-4f;
+
+	/** Passes over the samples per Train(). */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Training", meta = (ClampMin = "1"))
+	int32 NumEpochs = 4;
+
+	/** Samples per gradient step, the last mini-batch of an epoch may be smaller but never holds a single sample. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Training", meta = (ClampMin = "1"))
+	int32 MiniBatchSize = 64;
+
+	/** Seed of the mini-batch shuffle. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Training")
+	int32 ShuffleSeed = 0;
+
+	/** Eval graph outputs kept by ExportPolicy(). Must not name a training input. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Training")
+	TArray<FString> PolicyOutputNames = { TEXT("actions") };
+
+private:
+	// Shared with every trainer, ONNX Runtime keeps one environment per process
+	static std::unique_ptr<Ort::Env> GEnv;
+
+	// The checkpoint must outlive the session that trains on it
+	std::unique_ptr<Ort::CheckpointState> CheckpointPtr;
+	std::unique_ptr<Ort::TrainingSession> SessionPtr;
+
+	// Training graph user inputs, in graph order
+	std::vector<std::string> InputNames;
+
+	// Declared shape of each input, -1 for dynamic dims; the first dim is the batch
+	std::vector<std::vector<int64_t>> InputShapes;
+
+	// Samples collected with AddSample(), and the row width of each column
+	TMap<FString, TArray<float>> SampleColumns;
+	TMap<FString, int32> SampleWidths;
+
+	// Mini-batch gather buffers, one per input, reused
+	std::vector<std::vector<float>> BatchScratch;
+
+	int32 NumUpdates = 0;
+	int32 NumTrainCalls = 0;
+};
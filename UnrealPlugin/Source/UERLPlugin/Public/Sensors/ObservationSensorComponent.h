@@ -0,0 +1,44 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "TrainingBridges/Schema/ObservationSchema.h"
+#include "ObservationSensorComponent.generated.h"
+
+/**
+ * Base class for native observation sources (pixels, rays, ...).
+ *
+ * A sensor is registered on a bridge with UBaseBridge::AddObservationSensor(). Its values are written
+ * straight into the bridge's observation buffer after the values parsed from the state string,
+ * and its fields are appended to the observation schema, so no string formatting is involved.
+ */
+UCLASS(Abstract, ClassGroup = (Custom))
+class UERLPLUGIN_API UObservationSensorComponent : public UActorComponent
+{
+    GENERATED_BODY()
+
+public:
+    /** Base name of the schema field(s) this sensor adds. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Sensor")
+    FString FieldName = TEXT("sensor");
+
+    /** Schema fields of this sensor in write order. Must not change after the bridge connected. */
+    virtual void GetObservationFields(TArray<FObservationField>& OutFields) const PURE_VIRTUAL(UObservationSensorComponent::GetObservationFields, );
+
+    /** Number of floats WriteObservation() writes. */
+    UFUNCTION(BlueprintCallable, Category = "Sensor")
+    int32 GetNumObservationValues() const;
+
+    /**
+     * Writes the latest sensor reading into OutValues (GetNumObservationValues() floats).
+     * Must be thread safe, bridges may call it from worker threads when evaluating envs in parallel.
+     */
+    virtual void WriteObservation(TArrayView<float> OutValues) const PURE_VIRTUAL(UObservationSensorComponent::WriteObservation, );
+
+    /**
+     * Writes the latest reading already packed in the dtypes of its fields, OutBytes holds their packed size.
+     * Sensors that keep their data in the wire format override this so packing skips the float round trip.
+     * Returns false if the sensor only produces floats, WriteObservation() is packed instead.
+     */
+    virtual bool WritePackedObservation(TArrayView<uint8> OutBytes) const { return false; }
+};
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Sensors/ObservationSensorComponent.h"
+#include "PixelObservationComponent.generated.h"
+
+class USceneCaptureComponent2D;
+struct FPixelReadbackState;
+
+/**
+ * Pixel observations from a USceneCaptureComponent2D render target.
+ *
+ * Every tick a GPU copy of the render target is queued into a ring of PipelineDepth readback buffers,
+ * and the oldest one is only mapped once the GPU reports it done, so the game and render threads never
+ * wait on the GPU. The frame is box-downsampled to OutputWidth x OutputHeight and stored as uint8 CHW,
+ * which makes the observation PipelineDepth frames old.
+ *
+ * Without a GPU (Null RHI, -nullrhi, headless Linux) or with bForceSoftwareFallback the component produces
+ * a moving test pattern of the same shape instead, so the whole pipeline can be exercised on a server.
+ * Pattern: value(c, y, x) = (x + y + 85 * c + FrameNumber) % 256.
+ */
+UCLASS(ClassGroup = (Custom), meta = (BlueprintSpawnableComponent))
+class UERLPLUGIN_API UPixelObservationComponent : public UObservationSensorComponent
+{
+    GENERATED_BODY()
+
+public:
+    UPixelObservationComponent();
+
+    /** Capture to read. If not set, the first USceneCaptureComponent2D of the owner is used. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Sensor|Pixels")
+    USceneCaptureComponent2D* SceneCapture = nullptr;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Sensor|Pixels", meta = (ClampMin = "1"))
+    int32 OutputWidth = 64;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Sensor|Pixels", meta = (ClampMin = "1"))
+    int32 OutputHeight = 64;
+
+    /** One luminance channel instead of RGB. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Sensor|Pixels")
+    bool bGrayscale = false;
+
+    /** Number of readbacks in flight. The observation lags this many frames behind the capture. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Sensor|Pixels", meta = (ClampMin = "1", ClampMax = "8"))
+    int32 PipelineDepth = 2;
+
+    /** Use the test pattern even when a GPU is available. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Sensor|Pixels")
+    bool bForceSoftwareFallback = false;
+
+    /** Number of channels in the output, 1 or 3. */
+    int32 GetNumChannels() const { return bGrayscale ? 1 : 3; }
+
+    /** Copies the latest uint8 CHW frame. Returns false if no frame has arrived yet. */
+    UFUNCTION(BlueprintCallable, Category = "Sensor|Pixels")
+    bool CopyLatestFrame(TArray<uint8>& OutPixels) const;
+
+    /** Number of frames resolved so far, increases by one per completed readback. */
+    UFUNCTION(BlueprintCallable, Category = "Sensor|Pixels")
+    int64 GetFrameNumber() const;
+
+    /** True if frames come from the test pattern instead of the GPU. */
+    UFUNCTION(BlueprintCallable, Category = "Sensor|Pixels")
+    bool IsUsingSoftwareFallback() const { return bUseSoftwareFallback; }
+
+    // One uint8 field of shape [C, OutputHeight, OutputWidth]
+    virtual void GetObservationFields(TArray<FObservationField>& OutFields) const override;
+
+    // Latest frame as floats in 0..255, zeros before the first frame
+    virtual void WriteObservation(TArrayView<float> OutValues) const override;
+
+    // Latest frame copied as is, it already is the packed uint8 field
+    virtual bool WritePackedObservation(TArrayView<uint8> OutBytes) const override;
+
+    virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+protected:
+    virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+    /** Queues the render command that resolves finished readbacks and copies the current render target. */
+    void EnqueueReadback();
+
+    /** Writes the next test pattern frame. */
+    void WriteSoftwareFrame();
+
+private:
+    /** Readback ring and latest frame, shared with the render thread so commands in flight outlive the component. */
+    TSharedPtr<FPixelReadbackState, ESPMode::ThreadSafe> ReadbackState;
+
+    /** True if frames come from WriteSoftwareFrame(). */
+    bool bUseSoftwareFallback = false;
+};
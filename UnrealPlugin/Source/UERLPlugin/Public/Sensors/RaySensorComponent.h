@@ -0,0 +1,110 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Sensors/ObservationSensorComponent.h"
+#include "WorldCollision.h"
+#include "RaySensorComponent.generated.h"
+
+/**
+ * Ray-cast observations from a fan of NumRays line traces around the owner.
+ *
+ * All rays are issued as one batch of AsyncLineTraceByChannel calls per tick; the physics scene runs them
+ * in parallel with the rest of the frame and results arrive through a delegate the next frame. A new batch
+ * is only issued once the previous one completed, so readings are one to two frames old. A batch that has
+ * not completed after BatchTimeoutFrames is abandoned and reissued, late results of it are ignored.
+ *
+ * Per ray the observation holds [normalized hit distance, one flag per DetectableTags entry],
+ * laid out as a [NumRays, 1 + DetectableTags.Num()] field. Distance is 1 when nothing was hit.
+ * Buffers and trace parameters are allocated in BeginPlay, ticks only reuse them.
+ */
+UCLASS(ClassGroup = (Custom), meta = (BlueprintSpawnableComponent))
+class UERLPLUGIN_API URaySensorComponent : public UObservationSensorComponent
+{
+    GENERATED_BODY()
+
+public:
+    URaySensorComponent();
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Sensor|Rays", meta = (ClampMin = "1", ClampMax = "65535"))
+    int32 NumRays = 16;
+
+    /** Horizontal spread of the rays around the owner's forward vector. 360 gives a full circle. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Sensor|Rays", meta = (ClampMin = "0", ClampMax = "360"))
+    float HorizontalFOVDegrees = 120.f;
+
+    /** Pitch of every ray, positive looks up. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Sensor|Rays")
+    float PitchDegrees = 0.f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Sensor|Rays", meta = (ClampMin = "1"))
+    float RayLength = 2000.f;
+
+    /** Ray origin relative to the owner, in the owner's local space. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Sensor|Rays")
+    FVector StartOffset = FVector::ZeroVector;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Sensor|Rays")
+    TEnumAsByte<ECollisionChannel> TraceChannel = ECC_Visibility;
+
+    /** Each tag adds a flag per ray that is 1 if the hit actor or component has it. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Sensor|Rays")
+    TArray<FName> DetectableTags;
+
+    /** Wire type of the field. QInt8/QUInt16 are quantized over 0..1, UInt8/Int32 would round the values away and send Float32. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Sensor|Rays")
+    EObservationDType DType = EObservationDType::Float32;
+
+    /** Frames a batch may stay incomplete before it is reissued, e.g. when a trace result got lost. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Sensor|Rays", meta = (ClampMin = "1"))
+    int32 BatchTimeoutFrames = 8;
+
+    /** Number of values per ray, the distance plus one flag per tag. */
+    int32 GetValuesPerRay() const { return 1 + DetectableTags.Num(); }
+
+    /** DType as sent, the integer types fall back to Float32. */
+    EObservationDType GetFieldDType() const;
+
+    /** Copies the latest completed reading, [NumRays x GetValuesPerRay()] floats. */
+    UFUNCTION(BlueprintCallable, Category = "Sensor|Rays")
+    TArray<float> GetLatestReading() const;
+
+    // One field of shape [NumRays, 1 + DetectableTags.Num()]
+    virtual void GetObservationFields(TArray<FObservationField>& OutFields) const override;
+
+    // Latest completed reading, zeros before the first batch completed
+    virtual void WriteObservation(TArrayView<float> OutValues) const override;
+
+    virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+protected:
+    virtual void BeginPlay() override;
+
+    /** Issues one async trace per ray from the owner's current transform. */
+    void IssueTraceBatch();
+
+    /** Async trace callback, UserData carries the batch id (high 16 bits) and the ray index (low 16 bits). */
+    void OnTraceCompleted(const FTraceHandle& Handle, FTraceDatum& Data);
+
+private:
+    /** Ray directions in the owner's local space, from BeginPlay. */
+    TArray<FVector> LocalDirections;
+
+    /** Reading being filled by the current batch, swapped into LatestValues once complete. */
+    TArray<float> PendingValues;
+
+    /** Last complete reading, guarded by ReadingLock. */
+    TArray<float> LatestValues;
+    mutable FCriticalSection ReadingLock;
+
+    /** Rays of the current batch that have not reported back yet. */
+    int32 NumPendingRays = 0;
+
+    /** Id of the current batch, results of older batches are dropped. */
+    uint16 BatchId = 0;
+
+    /** Engine frame the current batch was issued on. */
+    uint64 BatchIssueFrame = 0;
+
+    FCollisionQueryParams QueryParams;
+    FTraceDelegate TraceDelegate;
+};
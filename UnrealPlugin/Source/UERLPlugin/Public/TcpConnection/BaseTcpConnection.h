@@ -7,6 +7,13 @@
 
 class FAcceptRunnable;
 
+/** One message read from the admin socket. Payload holds the bytes announced by ";BYTES=<n>", empty for text lines. */
+struct FAdminFrame
+{
+    FString Header;
+    TArray<uint8> Payload;
+};
+
 /**
  * Abstract base class for framework TCP connection operations.
  */
@@ -30,12 +37,18 @@ public:
 
 
     /**
-     * Accept an incoming connection from the listening socket.
+     * Accept an incoming connection from the listening socket and pass it to AssignSocket().
+     */
+    virtual bool AcceptConnection();
+
+    /**
+     * Take ownership of a freshly connected socket.
      *
      * We assume first connection is always meant to be admin socket and fill admin socket first
      * Then, when admin socket is full we fill enviornment sockets
+     * Called by the own accept thread, or by UBridgeConnectionSubsystem for shared listeners.
      */
-    virtual bool AcceptConnection();
+    virtual bool AssignSocket(FSocket* NewSock);
 
     /**
     * Subclasses must implement environment acceptance (single env, multi env, etc.).
@@ -51,6 +64,16 @@ public:
     // Get listening socket
     FSocket* GetListeningSocket();
 
+    /**
+     * Share the listening port with other bridges through UBridgeConnectionSubsystem.
+     * Clients must then open every socket with "HELLO:BRIDGE=<InBridgeId>". Empty opens an own listener.
+     * Must be set before StartListening().
+     */
+    void SetSharedBridgeId(const FString& InBridgeId);
+
+    /** True if sockets arrive through the shared listener instead of an own listening socket. */
+    bool UsesSharedListener() const { return !SharedBridgeId.IsEmpty(); }
+
     //--------------------------------------------------------------------------
     // Admin vs. Environment messaging
     //--------------------------------------------------------------------------
@@ -60,18 +83,37 @@ public:
      */
     virtual bool SendMessageAdmin(const FString& Data);
 
+    /**
+     * Sends a binary frame "<Header>;BYTES=<n>\n<Payload>" to the admin socket.
+     * Used for bulk data such as whole rollouts. Returns false if admin is not connected or if sending fails.
+     */
+    virtual bool SendMessageAdminBinary(const FString& Header, TConstArrayView<uint8> Payload);
+
     /**
      * Sends a UTF-8 string to environment socket(s).
      * Subclass must define whether it's single or multiple env sockets.
      */
     virtual bool SendMessageEnv(const FString& Data) PURE_VIRTUAL(UBaseTcpConnection::SendMessageEnv, return false;);
 
+    /**
+     * Sends a binary frame "<Header>;BYTES=<n>\n<Payload>" to environment socket(s).
+     * Used for schema packed observations. Default implementation does not support binary frames.
+     */
+    virtual bool SendMessageEnvBinary(const FString& Header, TConstArrayView<uint8> Payload);
+
     /**
      * Receives a UTF-8 string from the admin socket, returns empty if none is pending.
      * Applies newline char as delimiter.
      */
     virtual FString ReceiveMessageAdmin(int32 BufSize = 1024);
 
+    /**
+     * Returns the next complete admin message without blocking, false if none is pending.
+     * Handles text lines as well as binary frames "<Header>;BYTES=<n>\n<Payload>" (e.g. streamed model chunks),
+     * partial frames stay buffered until the rest arrives. Don't mix with ReceiveMessageAdmin().
+     */
+    virtual bool ReceiveAdminFrame(FAdminFrame& OutFrame);
+
     /**
      * Receives a UTF-8 string from environment socket(s).
      * Subclass must define logic (single, multi, round-robin, etc.).
@@ -79,12 +121,37 @@ public:
      */
     virtual FString ReceiveMessageEnv(int32 BufSize = 1024) PURE_VIRTUAL(UBaseTcpConnection::ReceiveMessageEnv, return TEXT(""););
 
+    /**
+     * Blocks for at most TimeoutSeconds until environment data is available to ReceiveMessageEnv().
+     * Returns false on timeout. Default implementation does not wait.
+     */
+    virtual bool WaitForEnvData(float TimeoutSeconds) { return false; }
+
     /**
      * Checks if admin socket and enviornment sockets are set and ready for training loop logic
      */
     virtual bool IsConnected() const PURE_VIRTUAL(UBaseTcpConnection::IsConnected, return false;);
 
-  
+    /**
+     * Checks if a specific enviornment slot currently has a live socket.
+     * Single environment connections only have one slot, so this defaults to IsConnected().
+     */
+    virtual bool IsEnvConnected(int32 EnvId) const { return IsConnected(); }
+
+    /**
+     * Returns the env ids that have connected since the last call and clears the list.
+     * Bridges use this to reset environments for workers that join after training started.
+     */
+    virtual TArray<int32> ConsumeJoinedEnvs() { return TArray<int32>(); }
+
+    /**
+     * Checks the admin and environment sockets for disconnects (zero-byte recv or socket error).
+     * Dropped sockets are cleaned up and the accept thread is re-armed so a worker can
+     * reconnect to the vacated slot. Subclasses extend this for their environment sockets.
+     */
+    virtual void PollDisconnects();
+
+
 protected:
 
     // Handshakestring
@@ -95,14 +162,57 @@ protected:
     // The first accepted socket is the admin client.
     FSocket* AdminSocket = nullptr;
 
+    // Guards AdminSocket and subclass env sockets: the accept thread assigns them, the game thread uses and closes them.
+    // Taken before a subclass's own env lock. Never hold it while joining the accept thread.
+    mutable FCriticalSection SocketMutex;
+
+    // Admin bytes read by ReceiveAdminFrame() that don't form a complete frame yet
+    TArray<uint8> AdminReceiveBuffer;
+
     // Accept thread
     FRunnableThread* AcceptThreadRef = nullptr;
     TSharedPtr<FAcceptRunnable> AcceptRunnableRef = nullptr;
     bool bStopAcceptThreadRef = false;
 
+    // Bridge id used to route connections from a shared listener, empty if not shared
+    FString SharedBridgeId = "";
+
+    // Port this connection is registered on with the shared listener, INDEX_NONE if not registered
+    int32 SharedPort = INDEX_NONE;
+
     // Sends handshake message
     void SendHandshake();
 
+    /** Builds "<Header>;BYTES=<n>\n" followed by Payload. */
+    static void BuildBinaryFrame(const FString& Header, TConstArrayView<uint8> Payload, TArray<uint8>& OutFrame);
+
+    /** Sends all of Bytes, looping over partial sends. Returns false if the socket failed. */
+    static bool SendAllBytes(FSocket* Socket, TConstArrayView<uint8> Bytes);
+
+    /** Registers with the shared listener of Port instead of opening an own listening socket. */
+    bool StartSharedListening(const FString& IPAddress, int32 Port);
+
+    /** Unregisters from the shared listener, if registered. */
+    void StopSharedListening();
+
+    /**
+     * Returns false if the peer closed the socket (readable with zero bytes) or the socket errored.
+     * Does not consume any pending data.
+     */
+    bool IsSocketAlive(FSocket* Socket) const;
+
+    /** Closes and frees the admin socket, then re-arms the accept thread. */
+    void ReleaseAdminSocket();
+
+    /** Closes and frees the admin socket under SocketMutex, for CloseConnection() once the accept thread is stopped. */
+    void CloseAdminSocket();
+
+    /** True if the admin socket is assigned. */
+    bool HasAdminSocket() const;
+
+    /** Lets the accept thread accept connections again after a slot was vacated. */
+    void RearmAcceptThread();
+
     /** Spawn an acceptance thread. */
     virtual void StartAcceptThread() PURE_VIRTUAL(UBaseTcpConnection::StartAcceptThread, );
 
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/EngineSubsystem.h"
+#include "Tickable.h"
+#include "BridgeConnectionSubsystem.generated.h"
+
+class FSocket;
+class FRunnableThread;
+class FSharedAcceptRunnable;
+class UBaseTcpConnection;
+
+/**
+ * Process wide connection manager that lets several bridges share one listening port.
+ *
+ * One listening socket and accept thread exist per port, no matter how many bridges use it.
+ * Every client opens its connection with a "HELLO:BRIDGE=<id>" line, the accept thread reads it
+ * and queues the socket for the bridge id. The subsystem's game thread tick hands queued sockets to the
+ * connection registered under that id, which then applies its usual admin-first / environment slot logic
+ * (UBaseTcpConnection::AssignSocket()). Connections are only touched on the game thread, where they are destroyed.
+ *
+ * Connections opt in through UBaseTcpConnection::SetSharedBridgeId(), see UBaseBridge::SharedBridgeId.
+ */
+UCLASS()
+class UERLPLUGIN_API UBridgeConnectionSubsystem : public UEngineSubsystem, public FTickableGameObject
+{
+    GENERATED_BODY()
+
+public:
+    /** Returns the engine wide instance, or nullptr if the engine is not up (or shutting down). */
+    static UBridgeConnectionSubsystem* Get();
+
+    virtual void Deinitialize() override;
+
+    /**
+     * Routes connections that say hello with BridgeId on Port to Connection.
+     * The listener for Port is created on first registration. Returns false if the port could not
+     * be opened or BridgeId is already taken on that port.
+     */
+    bool RegisterConnection(int32 Port, const FString& BridgeId, UBaseTcpConnection* Connection);
+
+    /** Stops routing to BridgeId and drops its queued sockets. The listener for Port is closed once its last bridge is gone. */
+    void UnregisterConnection(int32 Port, const FString& BridgeId);
+
+    /**
+     * Called by the accept thread of Port once a socket sent its hello.
+     * Queues the socket for the next Tick(); returns false if nobody is registered for BridgeId,
+     * in which case the caller still owns the socket.
+     */
+    bool RouteSocket(int32 Port, const FString& BridgeId, FSocket* Socket);
+
+    // -------------------------------------------------------------
+    //  FTickableGameObject Interface
+    // -------------------------------------------------------------
+    virtual void Tick(float DeltaTime) override;
+    virtual bool IsTickable() const override { return !HasAnyFlags(RF_ClassDefaultObject); }
+    virtual bool IsTickableInEditor() const override { return true; }
+    virtual bool IsTickableWhenPaused() const override { return true; }
+    virtual ETickableTickType GetTickableTickType() const override { return ETickableTickType::Conditional; }
+    virtual TStatId GetStatId() const override;
+
+    /** Connections that do not say hello within this many seconds are dropped. */
+    static constexpr double HelloTimeoutSeconds = 5.0;
+
+private:
+    struct FSharedListener
+    {
+        FSocket* ListeningSocket = nullptr;
+        TSharedPtr<FSharedAcceptRunnable> AcceptRunnable;
+        FRunnableThread* AcceptThread = nullptr;
+        // Weak, a bridge that was destroyed without unregistering must not be routed to
+        TMap<FString, TWeakObjectPtr<UBaseTcpConnection>> Connections;
+    };
+
+    /** A socket that said hello, waiting for the game thread to hand it to its bridge. */
+    struct FRoutedSocket
+    {
+        int32 Port = 0;
+        FString BridgeId;
+        FSocket* Socket = nullptr;
+    };
+
+    /** Stops the accept thread and closes the listening socket. Must be called without holding ListenerMutex. */
+    static void ShutdownListener(FSharedListener& Listener);
+
+    /** Closes and destroys the queued sockets. */
+    static void DestroyRoutedSockets(TArray<FRoutedSocket>& Sockets);
+
+    /** One listener per port. */
+    TMap<int32, FSharedListener> Listeners;
+
+    /** Sockets queued by the accept threads, drained by Tick(). */
+    TArray<FRoutedSocket> RoutedSockets;
+
+    /** Guards Listeners and RoutedSockets, taken by the game thread and every accept thread (lookup and queueing only). */
+    FCriticalSection ListenerMutex;
+};
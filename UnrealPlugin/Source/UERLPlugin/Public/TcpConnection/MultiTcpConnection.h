@@ -15,6 +15,10 @@
  * 
  * SendMessageEnv() parses "ENV=%d" from the string to find which socket to use.
  * ReceiveMessageEnv() returns a single combined string of new messages from all envs.
+ *
+ * If bAllowPartialConnections is set, the connection reports itself as connected once the
+ * admin and at least one environment have joined, so the bridge can step a partial fleet.
+ * If bAdminOnly is set, the admin socket alone counts as connected (actor mode, envs are stepped locally).
  * 
  * Uses "\n" as delimiter.
  */
@@ -54,13 +58,23 @@ public:
      */
     virtual bool SendMessageEnv(const FString& Data) override;
 
+    // Send a binary frame, the target env is parsed from "ENV=%d" in the header
+    virtual bool SendMessageEnvBinary(const FString& Header, TConstArrayView<uint8> Payload) override;
+
     /**
      * Gather new messages from all environment sockets. 
+     * Envs that joined since the last ConsumeJoinedEnvs() call are not read yet.
      * Parses partial messages into buffer.
      * Expects newline char as delimiter.
      */
     virtual FString ReceiveMessageEnv(int32 BufSize = 1024) override;
 
+    /**
+     * Polls the env sockets for up to TimeoutSeconds until any of them has data for ReceiveMessageEnv().
+     * Sockets can't be waited on together, so this yields between polls instead of blocking.
+     */
+    virtual bool WaitForEnvData(float TimeoutSeconds) override;
+
     /**
      * Close acceptance thread, plus admin and environment sockets.
      */
@@ -68,15 +82,32 @@ public:
 
     /**
      * Spawns a thread that calls AcceptConnection() repeatedly
-     * for admin + multiple envs. We stop it once all envs are filled (or at shutdown).
+     * for admin + multiple envs. We pause it once all envs are filled and stop it at shutdown.
      */
     virtual void StartAcceptThread() override;
 
     /**
-     * Return true if AdminSocket is assigned and all envs are connceted
+     * Return true if AdminSocket is assigned and all envs are connceted.
+     * With bAllowPartialConnections, one connected env is enough.
      */
     virtual bool IsConnected() const override;
 
+    /**
+     * Return true if the socket slot for EnvId is currently filled.
+     */
+    virtual bool IsEnvConnected(int32 EnvId) const override;
+
+    /**
+     * Returns env ids accepted since the last call.
+     */
+    virtual TArray<int32> ConsumeJoinedEnvs() override;
+
+    /**
+     * Checks admin + all env sockets for disconnects. Dropped env slots are freed
+     * and the accept thread is re-armed so a worker can reconnect into them.
+     */
+    virtual void PollDisconnects() override;
+
     //-------------------------------------------------------------------------
     // Configuration
     //-------------------------------------------------------------------------
@@ -87,13 +118,27 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "MultiEnv")
     int32 NumEnvironments = 1;
 
+    /**
+     * If true, IsConnected() returns true as soon as the admin and any environment are connected
+     * instead of waiting for all NumEnvironments sockets.
+     */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "MultiEnv")
+    bool bAllowPartialConnections = false;
+
+    /**
+     * If true, IsConnected() only needs the admin socket. Used when the bridge acts with a local policy
+     * and talks to the learner over the admin socket only.
+     */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "MultiEnv")
+    bool bAdminOnly = false;
+
 protected:
     //-------------------------------------------------------------------------
     // Internal data
     //-------------------------------------------------------------------------
 
     /** Protect EnvSockets and PartialData arrays. */
-    FCriticalSection EnvSocketMutex;
+    mutable FCriticalSection EnvSocketMutex;
 
     /**
      * Environment sockets array. If EnvSockets[i] is null, that slot is free.
@@ -107,6 +152,12 @@ protected:
      */
     TArray<FString> PartialData;
 
+    /** Number of filled slots in EnvSockets, kept in sync on accept and release. */
+    int32 NumConnectedEnvs = 0;
+
+    /** Env ids accepted since the last ConsumeJoinedEnvs() call, their sockets are not read until then. */
+    TArray<int32> JoinedEnvs;
+
     //-------------------------------------------------------------------------
     // Helper Methods
     //-------------------------------------------------------------------------
@@ -125,6 +176,14 @@ protected:
 
     /**
      * Checks if all EnvSockets[i] are assigned (none are null).
+     * Caller must hold EnvSocketMutex.
      */
     bool AreAllEnvsAssigned() const;
+
+    /**
+     * Closes and frees the socket in slot EnvId so the env is no longer stepped,
+     * then re-arms the accept thread for the vacated slot.
+     * Caller must hold EnvSocketMutex.
+     */
+    void ReleaseEnvSocket(int32 EnvId);
 };
@@ -3,6 +3,7 @@
 
 #include "CoreMinimal.h"
 #include "BaseTcpConnection.h"
+#include "HAL/ThreadSafeBool.h"
 #include "SingleTcpConnection.generated.h"
 
 class FAcceptRunnable;
@@ -30,9 +31,15 @@ public:
     // Send data to environment. Applies newline char as delimiter.
     virtual bool SendMessageEnv(const FString& Data) override;
 
+    // Send a binary frame to the env socket
+    virtual bool SendMessageEnvBinary(const FString& Header, TConstArrayView<uint8> Payload) override;
+
     // Receive data from environment. Expects newline char as delimiter.
     virtual FString ReceiveMessageEnv(int32 BufSize = 1024) override;
 
+    // Wait (bounded) until a full line is buffered or the env socket becomes readable
+    virtual bool WaitForEnvData(float TimeoutSeconds) override;
+
     // Clean up
     virtual void CloseConnection() override;
 
@@ -40,15 +47,24 @@ public:
     virtual void StartAcceptThread() override;
 
     // IsConnected returns true only if AdminSocket + EnvSocket are set
-    virtual bool IsConnected() const override
-    {
-        return (AdminSocket != nullptr && EnvSocket != nullptr);
-    }
+    virtual bool IsConnected() const override;
+
+    // Returns {0} once after the env socket (re)connects
+    virtual TArray<int32> ConsumeJoinedEnvs() override;
+
+    // Check admin + env socket for disconnects, re-arm accept thread if one dropped
+    virtual void PollDisconnects() override;
 
 protected:
-    // The environment socket
+    // The environment socket, guarded by SocketMutex
     FSocket* EnvSocket = nullptr;
 
-    // Buffer leftover data until we see a full line (newline-delimited)
+    // Buffer leftover data until we see a full line (newline-delimited), guarded by SocketMutex
     FString PartialData;
+
+    // True when the env socket connected since the last ConsumeJoinedEnvs() call, it is not read until then
+    FThreadSafeBool bEnvJoined = false;
+
+    // Close and free the env socket so a new worker can take its place
+    void ReleaseEnvSocket();
 };
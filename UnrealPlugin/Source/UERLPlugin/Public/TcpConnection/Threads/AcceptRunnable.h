@@ -8,6 +8,8 @@ class UBaseTcpConnection;
 /**
  * FRunnable that polls a listening socket for new connections
  * and calls AcceptConnection() on its owner when one arrives.
+ * While paused the thread stays alive but leaves pending connections in the backlog,
+ * so it can be re-armed when a socket slot is vacated.
  */
 class FAcceptRunnable : public FRunnable
 {
@@ -19,7 +21,14 @@ public:
     virtual uint32 Run() override;
     virtual void Stop() override;
 
+    // Stop accepting without ending the thread (all slots are filled)
+    void Pause();
+
+    // Start accepting again (a slot was vacated)
+    void Resume();
+
 private:
     UBaseTcpConnection* Owner;
     FThreadSafeBool       bStop;
+    FThreadSafeBool       bPaused;
 };
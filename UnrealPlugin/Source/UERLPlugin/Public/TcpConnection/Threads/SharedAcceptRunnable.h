@@ -0,0 +1,45 @@
+#pragma once
+
+#include "HAL/Runnable.h"
+#include "HAL/ThreadSafeBool.h"
+
+class FSocket;
+class UBridgeConnectionSubsystem;
+
+/**
+ * FRunnable that accepts connections on a port shared by several bridges.
+ * New sockets are held until their "HELLO:BRIDGE=<id>" line has arrived, then routed through
+ * UBridgeConnectionSubsystem::RouteSocket(). Sockets with a bad, missing or late hello are closed.
+ */
+class FSharedAcceptRunnable : public FRunnable
+{
+public:
+    FSharedAcceptRunnable(UBridgeConnectionSubsystem* InOwner, FSocket* InListeningSocket, int32 InPort);
+    virtual ~FSharedAcceptRunnable() override;
+
+    // FRunnable interface
+    virtual uint32 Run() override;
+    virtual void Stop() override;
+
+private:
+    struct FPendingHello
+    {
+        FSocket* Socket = nullptr;
+        FString Line;
+        double AcceptTime = 0.0;
+        bool bFailed = false;
+    };
+
+    // Reads the hello byte by byte so nothing after the newline is consumed, returns true once the line is complete
+    bool ReadHelloLine(FPendingHello& Pending) const;
+
+    static void DestroySocket(FSocket* Socket);
+
+    UBridgeConnectionSubsystem* Owner;
+    FSocket* ListeningSocket;
+    int32 Port;
+    FThreadSafeBool bStop;
+
+    // Only touched by the accept thread
+    TArray<FPendingHello> PendingHellos;
+};
@@ -7,9 +7,13 @@
 #include "Tickable.h"
 #include "Inference/InferenceInterfaces/InferenceInterface.h"
 #include "TcpConnection/BaseTcpConnection.h"
+#include "TrainingBridges/Schema/ObservationSchema.h"
+#include "TrainingBridges/Observation/ObservationFrameStack.h"
+#include "TrainingBridges/Observation/ObservationNormalizer.h"
 #include "BaseBridge.generated.h"
 
 class UBaseTcpConnection;
+class UObservationSensorComponent;
 
 /**
  * An abstract base class that defines high‑level RL bridging:
@@ -46,6 +50,78 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Bridge|Connection")
     virtual void Disconnect();
 
+    /**
+     * If set, the bridge shares its port with other bridges in this process (UBridgeConnectionSubsystem)
+     * and Python must open every socket with "HELLO:BRIDGE=<SharedBridgeId>".
+     * Empty opens a dedicated listener on the port. Must be set before Connect().
+     */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Bridge|Connection")
+    FString SharedBridgeId;
+
+    /**
+     * Optional typed observation/action layout, declared in the handshake.
+     * With observation fields set, observations are sent as binary frames packed per field dtype
+     * and the observation size is taken from the schema. Must be set before Connect().
+     */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Bridge|Schema")
+    FObservationSchema ObservationSchema;
+
+    /**
+     * Registers a native observation sensor for EnvId. Sensor values follow the state string values in the
+     * observation and their fields are appended to ObservationSchema ("state" float field first if no schema is set).
+     * The observation size passed to Connect() covers the state string only. Every env must register the same
+     * sensor layout, in the same order. Must be called before Connect().
+     */
+    UFUNCTION(BlueprintCallable, Category = "Bridge|Sensors")
+    void AddObservationSensor(UObservationSensorComponent* Sensor, int32 EnvId = 0);
+
+    /**
+     * Number of most recent observations sent per step, oldest first, for training and local inference alike.
+     * Announced as FRAME_STACK=K in the handshake, OBS stays the size of one frame. 1 disables stacking.
+     * Must be set before Connect().
+     */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Bridge|Observation", meta = (ClampMin = "1"))
+    int32 FrameStackDepth = 1;
+
+    /**
+     * Normalize the state values of every observation with running mean/variance statistics (like VecNormalize)
+     * before they are stacked, sent, or fed to the local model. Sensor values pass through unchanged.
+     * Announced as OBS_NORM=<clip> in the handshake. Must be set before Connect().
+     */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Bridge|Observation")
+    bool bNormalizeObservations = false;
+
+    /** Normalized values are clipped to [-ObservationClip, ObservationClip], 0 disables clipping. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Bridge|Observation", meta = (EditCondition = "bNormalizeObservations", ClampMin = "0"))
+    float ObservationClip = 10.f;
+
+    /** Added to the variance before taking the square root. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Bridge|Observation", meta = (EditCondition = "bNormalizeObservations", ClampMin = "0"))
+    float NormalizationEpsilon = 1e-8f;
+
+    /** While training, every sent observation updates the statistics. Disable to keep imported statistics fixed. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Bridge|Observation", meta = (EditCondition = "bNormalizeObservations"))
+    bool bUpdateNormalizationStats = true;
+
+    /**
+     * Writes the normalization statistics (count, clip, epsilon, mean, var) to a text file,
+     * readable by gym_wrappers/obs_normalization.py. Returns false if there are no statistics yet.
+     */
+    UFUNCTION(BlueprintCallable, Category = "Bridge|Observation")
+    bool ExportNormalizationStats(const FString& FilePath) const;
+
+    /**
+     * Loads statistics written by ExportNormalizationStats() or by obs_normalization.py (e.g. from a VecNormalize
+     * checkpoint), replacing ObservationClip and NormalizationEpsilon. Works before Connect(), so inference only
+     * setups can normalize like training did.
+     */
+    UFUNCTION(BlueprintCallable, Category = "Bridge|Observation")
+    bool ImportNormalizationStats(const FString& FilePath);
+
+    /** Restarts the statistics from mean 0, variance 1. */
+    UFUNCTION(BlueprintCallable, Category = "Bridge|Observation")
+    void ResetNormalizationStats();
+
 
     // -------------------------------------------------------------
     //  RL Modes (Training / Inference)
@@ -59,6 +135,14 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Bridge|Mode")
     virtual void StartInference();
 
+    /**
+     * Inference without a learner: sizes the observation layout like Connect() does (sensors, schema,
+     * frame stack, normalization) without opening a socket, then switches to inference mode.
+     * Not needed if the bridge was connected. Returns false if the observation schema is invalid.
+     */
+    UFUNCTION(BlueprintCallable, Category = "Bridge|Mode")
+    bool InitializeInference(int32 InActionSpaceSize, int32 InObservationSpaceSize);
+
 
     // -------------------------------------------------------------
     //  Inference 
@@ -72,11 +156,74 @@ public:
     virtual bool SetInferenceInterface(UInferenceInterface* Interface);
 
     /**
-     * Run embedded model inference on a given observation string
+     * Run embedded model inference on a given observation string.
+     * The observation is built like the ones sent while training: the state values, then the values of the
+     * sensors registered for env 0, normalized and stacked. Sensors need the layout of Connect() or InitializeInference().
      */
     UFUNCTION(BlueprintCallable, Category = "Bridge|Inference")
     virtual FString RunLocalModelInference(const FString& Observation);
 
+    /**
+     * Clears the hidden state of a recurrent model for AgentId (env or agent index), or for all if negative.
+     * Also clears the inference frame stack of AgentId.
+     * The bridges call this on every episode start, after the reset callbacks (HandleReset, HandleResetForEnv);
+     * call it yourself only for resets the bridge does not see.
+     */
+    UFUNCTION(BlueprintCallable, Category = "Bridge|Inference")
+    void ResetInferenceState(int32 AgentId = -1);
+
+    /**
+     * Version of the policy in the InferenceInterface, as sent by the learner with streamed or announced weights.
+     * 0 until the learner sent one.
+     */
+    UFUNCTION(BlueprintCallable, Category = "Bridge|Inference")
+    int32 GetPolicyVersion() const { return PolicyVersion; }
+
+    /**
+     * Largest model the learner may stream as MODEL_CHUNK frames, in MB. Larger models are refused with
+     * MODEL_FAILED before any memory is reserved for them.
+     */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Bridge|Inference", meta = (ClampMin = "1", ClampMax = "2047"))
+    int32 MaxStreamedModelSizeMB = 512;
+
+
+    // -------------------------------------------------------------
+    //  Simulation Stepping
+    // -------------------------------------------------------------
+
+    /**
+     * Decouple RL steps from the render frame rate.
+     * Every engine frame advances the world by exactly InFixedDeltaTime, and each action is held
+     * for InSubStepsPerAction frames (action repeat) before its observation is taken.
+     * With 0 sub-steps an instant action may complete in the frame it was applied.
+     * The action is still considered running afterwards while IsActionRunning() reports true.
+     * If bInDisableRendering is set, world rendering is turned off while the fixed timestep is active.
+     */
+    UFUNCTION(BlueprintCallable, Category = "Bridge|Stepping")
+    virtual void EnableFixedTimestep(float InFixedDeltaTime = 0.0166667f, int32 InSubStepsPerAction = 1, bool bInDisableRendering = true);
+
+    /** Restore variable timestep, rendering, and per-frame action completion. */
+    UFUNCTION(BlueprintCallable, Category = "Bridge|Stepping")
+    virtual void DisableFixedTimestep();
+
+    /**
+     * Max-speed headless training. Enables the fixed timestep without world rendering, uncaps the frame rate
+     * (no vsync, no smoothing, no max FPS), mutes audio, and lets UpdateRL run up to InMaxStepsPerFrame
+     * request/response cycles per engine frame while actions complete instantly. Between cycles the bridge
+     * waits up to TurboActionWaitSeconds for Python's answer to the observations it just sent.
+     * Steps per second are then bound by simulation cost instead of the display.
+     */
+    UFUNCTION(BlueprintCallable, Category = "Bridge|Stepping")
+    virtual void EnableTrainingTurbo(float InFixedDeltaTime = 0.0166667f, int32 InSubStepsPerAction = 0, int32 InMaxStepsPerFrame = 16);
+
+    /** Upper bound on how long a turbo frame waits for Python's next actions before the next cycle. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Bridge|Stepping", meta = (ClampMin = "0"))
+    float TurboActionWaitSeconds = 0.002f;
+
+    /** Restore the frame rate, audio and timestep settings changed by EnableTrainingTurbo(). */
+    UFUNCTION(BlueprintCallable, Category = "Bridge|Stepping")
+    virtual void DisableTrainingTurbo();
+
 
 protected:
     // -------------------------------------------------------------
@@ -101,6 +248,165 @@ protected:
     int32 ActionSpaceSize = 0;
     int32 ObservationSpaceSize = 0;
 
+    /** True while the engine is stepped with a fixed delta, see EnableFixedTimestep(). */
+    bool bUseFixedTimestep = false;
+
+    /** Simulated seconds per engine frame while bUseFixedTimestep is set. */
+    float FixedDeltaTime = 0.0166667f;
+
+    /** Number of fixed frames each action is held for before its observation is taken. */
+    int32 SubStepsPerAction = 0;
+
+    /** True if world rendering was turned off by EnableFixedTimestep(). */
+    bool bDisabledRendering = false;
+
+    /** Engine settings saved when the fixed timestep is enabled, restored when disabled. */
+    bool bPrevUseFixedTimeStep = false;
+    double PrevFixedDeltaTime = 0.0;
+
+    /** True while training turbo is enabled, see EnableTrainingTurbo(). */
+    bool bTrainingTurbo = false;
+
+    /** Max request/response cycles UpdateRL may run within one engine frame. */
+    int32 MaxStepsPerFrame = 1;
+
+    /** Engine settings saved when turbo is enabled, restored when disabled. */
+    float PrevMaxFPS = 0.f;
+    int32 PrevVSync = 0;
+    bool bPrevSmoothFrameRate = false;
+    bool bPrevBenchmarking = false;
+    bool bPrevAudioMuted = false;
+
+    /**
+     * Subclasses set this in UpdateRL when a Python message was consumed and answered with an observation.
+     * In turbo mode Tick keeps calling UpdateRL within the same frame while this is set.
+     */
+    bool bStepCompletedThisUpdate = false;
+
+    /** Reused buffer for schema packed observations. */
+    TArray<uint8> PackedObservationBuffer;
+
+    /** Version of the policy acting, see GetPolicyVersion(). */
+    int32 PolicyVersion = 0;
+
+    /** Streamed model being assembled from MODEL_CHUNK frames, INDEX_NONE version if none. */
+    TArray<uint8> StreamedModelBytes;
+    int32 StreamedModelVersion = INDEX_NONE;
+
+    /** Registered sensors with their env id and value count, in registration order. */
+    UPROPERTY()
+    TArray<UObservationSensorComponent*> ObservationSensors;
+    TArray<int32> ObservationSensorEnvIds;
+    TArray<int32> ObservationSensorSizes;
+    TArray<int32> ObservationSensorFieldCounts;
+
+    /** Sensor fields appended to the schema on Connect(), they follow the state fields. */
+    int32 NumSensorSchemaFields = 0;
+
+    /** Float reading of a sensor that cannot pack itself, see SendPackedSensorObservation(). */
+    TArray<float> SensorObservationScratch;
+
+    /** Number of leading observation values parsed from the state string, sensor values follow. */
+    int32 StateObservationSize = 0;
+
+    /** Schema fields set before sensor fields were appended on Connect(), INDEX_NONE if none were appended. */
+    int32 NumConfiguredSchemaFields = INDEX_NONE;
+
+    /** Last FrameStackDepth observations per env, one row per env, sized on Connect(). */
+    FObservationFrameStack FrameStack;
+
+    /** Last FrameStackDepth observations fed to the local model, sized on first use, restarted by ResetInferenceState(). */
+    FObservationFrameStack InferenceFrameStack;
+
+    /** Actions of a stacked local inference run, reused. */
+    TArray<float> InferenceActionScratch;
+
+    /** Running statistics of the state values, one pending row per env, sized on Connect() or import. */
+    FObservationNormalizer ObservationNormalizer;
+
+    /**
+     * Non network part of Connect(): applies the sensors and the schema, then sizes StateObservationSize,
+     * the frame stack and the normalizer. Subclasses size their per env buffers here. Returns false on an invalid schema.
+     */
+    virtual bool InitializeObservationLayout(int32 InActionSpaceSize, int32 InObservationSpaceSize);
+
+    /** Subclasses that normalize their observations through ObservationNormalizer return true. */
+    virtual bool SupportsObservationNormalization() const { return false; }
+
+    /** True if observations are normalized before they are stacked and sent. */
+    bool UsesObservationNormalization() const { return SupportsObservationNormalization() && bNormalizeObservations; }
+
+    /** True if normalized observations also update the statistics. */
+    bool ShouldUpdateNormalizationStats() const { return bIsTraining && bUpdateNormalizationStats; }
+
+    /** Subclasses that send observations through the frame stack return true. */
+    virtual bool SupportsFrameStack() const { return false; }
+
+    /** True if observations are sent as a stack of the last FrameStackDepth frames. */
+    bool UsesFrameStack() const { return SupportsFrameStack() && FrameStackDepth > 1; }
+
+    /** Number of independent observation streams (envs), one frame stack row each. */
+    virtual int32 GetNumObservationRows() const { return 1; }
+
+    /** True if sensors contribute to the observation. */
+    bool HasObservationSensors() const { return ObservationSensors.Num() > 0; }
+
+    /**
+     * Appends the sensor fields to the schema (or just their sizes to the observation size if the
+     * bridge does not support schemas). Returns the number of sensor values per observation.
+     */
+    int32 ApplyObservationSensors();
+
+    /** Writes the sensors of EnvId into OutObservation after the first StateObservationSize values. Thread safe. */
+    void WriteSensorObservations(int32 EnvId, TArrayView<float> OutObservation) const;
+
+    /** Subclasses that send observations through SendPackedObservation() return true. */
+    virtual bool SupportsObservationSchema() const { return false; }
+
+    /** True if observations go out as schema packed binary frames. */
+    bool UsesObservationSchema() const { return SupportsObservationSchema() && !ObservationSchema.IsEmpty(); }
+
+    /**
+     * Sends "<Header>;BYTES=<n>\n" followed by the schema packed observations (one or more back to back).
+     * An observation view holding a frame stack is packed frame by frame.
+     * Game thread only, reuses PackedObservationBuffer.
+     */
+    bool SendPackedObservation(const FString& Header, TConstArrayView<TConstArrayView<float>> Observations);
+
+    /**
+     * Like SendPackedObservation() for one unstacked observation of EnvId, with the state fields packed from
+     * StateObservation and every sensor packed straight from its own reading (e.g. uint8 pixels are copied as is).
+     * Game thread only.
+     */
+    bool SendPackedSensorObservation(int32 EnvId, const FString& Header, TConstArrayView<float> StateObservation);
+
+    /** Engine frame on which an action applied now may complete, the current frame when sub-stepping is off. */
+    uint64 GetActionReadyFrame() const;
+
+    /** Returns true while an action applied earlier still has fixed frames left to run. */
+    bool IsHoldingAction(uint64 ActionReadyFrame) const;
+
+    /**
+     * Handles every pending admin message, then swaps in a streamed policy the InferenceInterface finished
+     * building and reports it to the learner with "MODEL_LOADED:VERSION=<v>", or "MODEL_FAILED:VERSION=<v>" if
+     * the model could not be built. Runs before UpdateRL each tick, so a step never sees a half loaded model.
+     */
+    void PollAdminMessages();
+
+    /**
+     * Handles one admin message. The base bridge assembles streamed policies:
+     *   "MODEL_CHUNK:VERSION=<v>;OFFSET=<o>;TOTAL=<size>;BYTES=<n>\n" + n model bytes
+     * Chunks of one model arrive in order; the complete model is built in the background by
+     * UInferenceInterface::LoadModelFromMemoryAsync(). Subclasses handle their own messages and call Super.
+     */
+    virtual void HandleAdminFrame(const FAdminFrame& Frame);
+
+    /** Appends a MODEL_CHUNK frame to StreamedModelBytes and hands the model over once it is complete. */
+    void ReceiveModelChunk(const FAdminFrame& Frame);
+
+    /** Tells the learner that streamed model Version will not be used, "MODEL_FAILED:VERSION=<v>". */
+    void SendModelFailed(int32 Version);
+
 
     // -------------------------------------------------------------
     //  RL Loop
@@ -0,0 +1,169 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TrainingBridges/BaseBridge.h"
+#include "MultiAgentBridge.generated.h"
+
+/** Name and space sizes of one agent of a UMultiAgentBridge. */
+USTRUCT(BlueprintType)
+struct UERLPLUGIN_API FAgentSpec
+{
+    GENERATED_BODY()
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "MultiAgent")
+    FString Name;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "MultiAgent")
+    int32 ObservationSize = 0;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "MultiAgent")
+    int32 ActionSize = 0;
+};
+
+/**
+ * A multi-agent RL bridge (PettingZoo parallel style), inherits from UBaseBridge.
+ * One environment on one socket holds several agents, each with its own observation/action size,
+ * declared in the handshake as "ENV_TYPE=MULTIAGENT;AGENTS=<name>:<obs>:<act>,...".
+ *
+ * All agents step together: Python sends "AGENT=0;ACT=..||AGENT=1;ACT=.." (or "ACT=RESET"),
+ * actions are scattered to HandleResponseActionsForAgent, and once the world reports its action
+ * done every agent's observation is gathered into one packed "AGENT=0;OBS=..;REW=..;DONE=..;TRUNC=..||AGENT=1;.." message.
+ * Observations and actions live in packed float buffers laid out by agent index.
+ */
+UCLASS(Blueprintable)
+class UERLPLUGIN_API UMultiAgentBridge : public UBaseBridge
+{
+    GENERATED_BODY()
+
+public:
+    // -------------------------------------------------------------
+    //  Agent Setup
+    // -------------------------------------------------------------
+    /**
+     * Declare an agent and return its index. Agents must be registered before Connect(),
+     * the total observation/action sizes passed to Connect() are then derived from the agents.
+     */
+    UFUNCTION(BlueprintCallable, Category = "MultiAgent")
+    int32 RegisterAgent(const FString& Name, int32 ObservationSize, int32 ActionSize);
+
+    /** Remove all agents, only valid while disconnected. */
+    UFUNCTION(BlueprintCallable, Category = "MultiAgent")
+    void ClearAgents();
+
+    UFUNCTION(BlueprintCallable, Category = "MultiAgent")
+    int32 GetNumAgents() const { return Agents.Num(); }
+
+    UFUNCTION(BlueprintCallable, Category = "MultiAgent")
+    FAgentSpec GetAgentSpec(int32 AgentId) const;
+
+    /** Model used for one agent in inference mode, agents without one use the bridge's InferenceInterface. */
+    UFUNCTION(BlueprintCallable, Category = "MultiAgent|Inference")
+    bool SetAgentInferenceInterface(int32 AgentId, UInferenceInterface* Interface);
+
+    // Sizes the packed buffers from the registered agents
+    virtual bool Connect_Implementation(const FString& IPAddress, int32 Port, int32 InActionSpaceSize, int32 InObservationSpaceSize) override;
+
+    /** Decimal places used when observations are written to the wire. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "MultiAgent")
+    int32 ObservationPrecision = 2;
+
+    /** Episodes reaching this many joint steps are reported as truncated for every agent not DONE. 0 disables the time limit. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "MultiAgent")
+    int32 MaxEpisodeSteps = 0;
+
+    // -------------------------------------------------------------
+    //  RL Loop: UpdateRL Implementation
+    // -------------------------------------------------------------
+    virtual void UpdateRL_Implementation(float DeltaTime) override;
+
+protected:
+    // Override handshake to send the agent table
+    virtual FString BuildHandshake_Implementation() override;
+
+    // One socket carries the whole world
+    virtual UBaseTcpConnection* CreateTcpConnection_Implementation() override;
+
+    /**
+     * Starts a new episode: calls HandleReset(), then clears the inference state of every agent.
+     * Every episode start goes through here, so overriding HandleReset never skips the inference reset.
+     */
+    void StartEpisode();
+
+    /** Resets the world and sends the first packed observation. */
+    void ResetAndSendObservations();
+
+    /** Gathers every agent's observation, reward, done and truncation into one packed message and sends it. */
+    void GatherAndSendObservations();
+
+    /** Splits "AGENT=i;ACT=..||.." and hands every agent its actions. */
+    void ScatterActions(const FString& PythonMessage);
+
+    /** Observation slot of AgentId inside the packed observation buffer. */
+    TArrayView<float> GetAgentObservation(int32 AgentId);
+
+    /** Action slot of AgentId inside the packed action buffer. */
+    TArrayView<float> GetAgentActions(int32 AgentId);
+
+    /**
+     * Fills AgentId's observation slot (ObservationSize floats).
+     * Default parses CreateStateStringForAgent; C++ subclasses can override this to write floats directly.
+     */
+    virtual void WriteObservationForAgent(int32 AgentId, TArrayView<float> OutObservation);
+
+    // -------------------------------------------------------------
+    //  Environment Callbacks
+    // -------------------------------------------------------------
+    UFUNCTION(BlueprintNativeEvent, BlueprintCallable, Category = "MultiAgent|Environment")
+    FString CreateStateStringForAgent(int32 AgentId);
+    virtual FString CreateStateStringForAgent_Implementation(int32 AgentId);
+
+    UFUNCTION(BlueprintNativeEvent, BlueprintCallable, Category = "MultiAgent|Environment")
+    float CalculateRewardForAgent(int32 AgentId, bool& bDone);
+    virtual float CalculateRewardForAgent_Implementation(int32 AgentId, bool& bDone);
+
+    UFUNCTION(BlueprintNativeEvent, BlueprintCallable, Category = "MultiAgent|Environment")
+    void HandleResponseActionsForAgent(int32 AgentId, const FString& Actions);
+    virtual void HandleResponseActionsForAgent_Implementation(int32 AgentId, const FString& Actions);
+
+    /**
+     * Resets the whole world, all agents start a new episode together.
+     * In inference mode it is called once every agent is done or MaxEpisodeSteps is hit.
+     * The inference state of every agent is cleared by the bridge.
+     */
+    UFUNCTION(BlueprintNativeEvent, BlueprintCallable, Category = "MultiAgent|Environment")
+    void HandleReset();
+    virtual void HandleReset_Implementation();
+
+    /** Returns true while the world is still executing the last joint action. */
+    UFUNCTION(BlueprintNativeEvent, BlueprintCallable, Category = "MultiAgent|Environment")
+    bool IsActionRunning();
+    virtual bool IsActionRunning_Implementation();
+
+    // -------------------------------------------------------------
+    //  Agent Layout
+    // -------------------------------------------------------------
+    UPROPERTY(VisibleAnywhere, Category = "MultiAgent")
+    TArray<FAgentSpec> Agents;
+
+    /** Per-agent models for inference mode, indexed by agent. */
+    UPROPERTY()
+    TArray<UInferenceInterface*> AgentInferenceInterfaces;
+
+    /** Start of each agent's slot in Observations / Actions. */
+    TArray<int32> ObservationOffsets;
+    TArray<int32> ActionOffsets;
+
+    /** Packed [sum of agent obs sizes] observations and [sum of agent act sizes] actions. */
+    TArray<float> Observations;
+    TArray<float> Actions;
+
+private:
+    /** True while the world executes the last joint action. */
+    bool bIsActionRunning = false;
+
+    /** Engine frame on which the current action may complete, see UBaseBridge::EnableFixedTimestep(). */
+    uint64 ActionReadyFrame = 0;
+
+    /** Joint steps since the last reset, for MaxEpisodeSteps. */
+    int32 EpisodeSteps = 0;
+};
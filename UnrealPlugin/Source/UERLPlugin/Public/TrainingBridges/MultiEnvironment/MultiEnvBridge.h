@@ -2,11 +2,16 @@
 
 #include "CoreMinimal.h"
 #include "TrainingBridges/BaseBridge.h"
+#include "TrainingBridges/MultiEnvironment/MultiEnvStateBuffer.h"
+#include "TrainingBridges/MultiEnvironment/RolloutBuffer.h"
 #include "MultiEnvBridge.generated.h"
 
 /**
  * A multi-environment RL bridge, inherits from BaseBridge.
  * This class implements a multi-env update loop and sends per-enviornment updates when actions complete
+ *
+ * Per-env step state (observations, actions, rewards, dones, episode stats) lives in one
+ * structure-of-arrays buffer, EnvState. Callbacks fill their env's slot and messages are built from it.
  */
 UCLASS(Blueprintable)
 class UERLPLUGIN_API UMultiEnvBridge : public UBaseBridge
@@ -26,20 +31,164 @@ protected:
     UPROPERTY(VisibleAnywhere, Category = "MultiEnv|Environment")
     int32 NumEnvironments = 0;
 
-    /** Array of booleans that determines if an enviornment is still running actions */
+    /**
+     * Array of booleans that determines if an enviornment has a connected worker that completed its reset handshake.
+     * Inactive environments are fenced off: their actions are ignored and they are never polled or sent to.
+     */
     UPROPERTY(VisibleAnywhere, Category = "MultiEnv|Environment")
-    TArray<bool> bIsActionRunning;
+    TArray<bool> bIsEnvActive;
+
+    /** Engine frame on which each environment's current action may complete, see UBaseBridge::EnableFixedTimestep(). */
+    TArray<uint64> ActionReadyFrame;
+
+    /** Set once a state string of the wrong length was reported for the env, so the warning is not repeated. */
+    TArray<bool> bWarnedObservationSize;
+
+    /**
+     * Contiguous per-env state: [NumEnvs x ObsSize] observations, [NumEnvs x ActSize] actions,
+     * rewards, dones, truncations, episode lengths/returns and action running flags.
+     * Sized in InitializeEnvironments() and again on Connect() once the space sizes are known.
+     */
+    FMultiEnvStateBuffer EnvState;
+
+    /** Async stepping: env ids and step messages of ready envs waiting to be shipped, in completion order. */
+    TArray<int32> ReadyEnvIds;
+    TArray<FString> ReadyMessages;
+
+    /** Terminal observation kept across an auto-reset when sending packed steps. */
+    TArray<float> TerminalObservationScratch;
+
+    /** [RolloutLength x NumEnvs] transitions of the current rollout, sized on Connect(). */
+    FRolloutBuffer Rollout;
+
+    /** Serialized rollout, reused. */
+    TArray<uint8> RolloutBytes;
+
+    /** Actor mode: rollouts shipped since the last policy request. */
+    int32 RolloutsSincePolicySync = 0;
+
+    /** Actor mode batch of envs waiting for an action, reused. */
+    TArray<int32> ActorEnvIds;
+    TArray<float> ActorObservations;
+    TArray<float> ActorActions;
+
+    /** True if a Blueprint overrides one of the step callbacks, which rules out parallel evaluation. */
+    bool bHasBlueprintEnvCallbacks = false;
 
 
 
 public:
+    /**
+     * If true, training starts as soon as one environment is connected and only connected
+     * environments are stepped. Late joiners are reset and must send RESET before being stepped.
+     * Must be set before Connect().
+     */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "MultiEnv|Environment")
+    bool bStepPartialFleet = false;
+
+    /**
+     * Marks IsActionRunningForEnv, CalculateRewardForEnv and CreateStateStringForEnv as thread safe,
+     * so they are evaluated for all environments in parallel on worker threads.
+     * Only valid for C++ overrides that touch nothing but their own environment;
+     * if any of them is overridden in Blueprint the bridge falls back to sequential evaluation.
+     */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "MultiEnv|Environment")
+    bool bParallelEnvCallbacks = false;
+
+    /** Episodes reaching this many steps without DONE are reported as truncated. 0 disables the time limit. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "MultiEnv|Environment")
+    int32 MaxEpisodeSteps = 0;
+
+    /**
+     * Gymnasium style auto-reset: when a step ends the episode (done or truncated) the env is reset
+     * right away and the step message carries the terminal observation in OBS and the first
+     * observation of the next episode in RESET_OBS, so Python does not send RESET after DONE.
+     * Announced as AUTO_RESET=1 in the handshake. Must be set before Connect().
+     */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "MultiEnv|Environment")
+    bool bAutoReset = false;
+
+    /**
+     * Async stepping (EnvPool style). If > 0, step messages are not sent per env; ready envs are
+     * queued and the first AsyncBatchSize of them are shipped together over the admin socket as
+     * "BATCH:<msg>||<msg>..." where every msg carries its ENV id. Actions still arrive per env socket.
+     * The batch size is capped at the number of active envs so a partial fleet never stalls.
+     * Announced as ASYNC_BATCH=K in the handshake. 0 keeps the synchronous per env messages.
+     */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "MultiEnv|Environment", meta = (ClampMin = "0"))
+    int32 AsyncBatchSize = 0;
+
+    /**
+     * Native rollout storage. If > 0, the bridge records RolloutLength transitions per env (observation, action,
+     * reward, termination, truncation and the value and log probability Python sends with each action as
+     * "ACT=..;VAL=..;LOGP=..[;TVAL=..]"; TVAL is the value of the terminal observation after a truncated step).
+     * Once every active env is full it computes GAE advantages and returns and ships the whole rollout over the
+     * admin socket as one binary frame "ROLLOUT:T=..;N=..;OBS=..;ACT=..;BYTES=<n>" (layout in FRolloutBuffer::Serialize()).
+     * Step messages are still sent so Python can choose actions, but it no longer stores transitions.
+     * Announced as ROLLOUT=T in the handshake. Must be set before Connect(). 0 disables rollout storage.
+     */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "MultiEnv|Rollout", meta = (ClampMin = "0"))
+    int32 RolloutLength = 0;
+
+    /** Discount factor of the rollout returns. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "MultiEnv|Rollout", meta = (ClampMin = "0", ClampMax = "1"))
+    float RolloutGamma = 0.99f;
+
+    /** GAE lambda of the rollout advantages. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "MultiEnv|Rollout", meta = (ClampMin = "0", ClampMax = "1"))
+    float RolloutGaeLambda = 0.95f;
+
+    /**
+     * IMPALA style actor mode. While training, actions come from the local InferenceInterface (set with
+     * SetInferenceInterface() before Connect(), with PolicyHeads so actions are sampled) instead of Python, so envs
+     * step at simulation speed regardless of learner latency. Episodes auto-reset, behaviour log probabilities are
+     * recorded, and every RolloutLength steps the trajectories of all envs are shipped as one ROLLOUT frame
+     * carrying ACTOR=1;VERSION=<policy version>;BOOTSTRAP_OBS=1;TERMINAL_OBS=1 (values are not known here, the
+     * learner computes them, e.g. for V-trace, from the last observations and the terminal observations of
+     * truncated steps). Envs that filled their part of
+     * the rollout are held until it ships, so trajectories have no gaps. Only the admin socket is used.
+     * Announced as ACTOR=1 in the handshake. Must be set before Connect(), requires RolloutLength > 0.
+     */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "MultiEnv|Actor")
+    bool bActorMode = false;
+
+    /**
+     * Actor mode: rollouts between "POLICY_REQUEST:VERSION=<v>" messages to the learner, which answers with
+     * "POLICY:PATH=<onnx file>;VERSION=<v>" or streams the model as MODEL_CHUNK frames (see UBaseBridge::HandleAdminFrame()).
+     * The new policy is loaded into the InferenceInterface.
+     */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "MultiEnv|Actor", meta = (ClampMin = "1"))
+    int32 PolicySyncInterval = 1;
+
+    /** Decimal places used when observations are written to the wire. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "MultiEnv|Environment")
+    int32 ObservationPrecision = 2;
+
     // -------------------------------------------------------------
     //  Initialization and training loop functions
     // -------------------------------------------------------------
-    /** Initialize the number of environments and resize the internal arrays accordingly. */
+    /**
+     * Initialize the number of environments and resize the internal arrays accordingly.
+     * With bInInferenceMode the bridge switches to inference, where all envs act through the local model in one batch.
+     */
     UFUNCTION(BlueprintCallable, Category = "MultiEnv")
     void InitializeEnvironments(int32 InNumEnvironments = 1, bool bInInferenceMode = false);
 
+    // Warns about actor mode settings that ship nothing
+    virtual bool Connect_Implementation(const FString& IPAddress, int32 Port, int32 InActionSpaceSize, int32 InObservationSpaceSize) override;
+
+    /** Steps taken so far in the current episode of EnvId. */
+    UFUNCTION(BlueprintCallable, Category = "MultiEnv|Environment")
+    int32 GetEpisodeLength(int32 EnvId) const;
+
+    /** Summed reward of the current episode of EnvId. */
+    UFUNCTION(BlueprintCallable, Category = "MultiEnv|Environment")
+    float GetEpisodeReturn(int32 EnvId) const;
+
+    /** Last actions applied to EnvId, as parsed from the action message. */
+    UFUNCTION(BlueprintCallable, Category = "MultiEnv|Environment")
+    TArray<float> GetLastActions(int32 EnvId) const;
+
 protected:
     // Override handshake to send multi enviornment configuration settngs
     virtual FString BuildHandshake_Implementation() override;
@@ -47,6 +196,109 @@ protected:
     // Training loop 
     virtual void UpdateRL_Implementation(float DeltaTime) override;
 
+    /**
+     * Resets environments whose worker just connected and fences off environments whose worker dropped.
+     */
+    void RefreshEnvConnections();
+
+    // Sizes the env state buffer and the rollout once action and observation space sizes are known
+    virtual bool InitializeObservationLayout(int32 InActionSpaceSize, int32 InObservationSpaceSize) override;
+
+    /**
+     * Inference step: completes finished actions, restarts ended episodes and acts for every idle env with the
+     * local model in one batch, from the same observations training sends.
+     */
+    void UpdateInference();
+
+    /** Runs EvaluateEnvStep() for every env, in parallel when the callbacks allow it. */
+    void EvaluateAllEnvSteps();
+
+    /** Actor mode step: completes finished actions, auto-resets ended episodes and acts with the local policy. */
+    void UpdateActor();
+
+    /** Actor and inference mode: samples actions for every active env that is not running one, in one inference batch. */
+    void ActWithLocalPolicy();
+
+    /** Actor mode: loads policies announced by the learner with "POLICY:PATH=<onnx file>;VERSION=<v>". */
+    virtual void HandleAdminFrame(const FAdminFrame& Frame) override;
+
+    /**
+     * Checks if EnvId finished its action and, if so, stores reward, done and observation in EnvState.
+     * With bCallNative the C++ implementations are called directly, which is safe off the game thread.
+     */
+    void EvaluateEnvStep(int32 EnvId, bool bCallNative);
+
+    /** Gathers reward, done and observation of EnvId into its EnvState slot and marks the step completed. */
+    void CompleteEnvStep(int32 EnvId, bool bCallNative);
+
+    /** Builds "OBS=..;REW=..;DONE=..;TRUNC=.." for EnvId from its EnvState slot. */
+    FString BuildStepFields(int32 EnvId) const;
+
+    /** Builds the "OBS=..;REW=..;DONE=..;TRUNC=..;ENV=.." message for EnvId from its EnvState slot. */
+    FString BuildStepMessage(int32 EnvId) const;
+
+    /**
+     * Builds "<TerminalFields>;RESET_OBS=<initial>;ENV=.." for an env that was just auto-reset.
+     * TerminalFields are the BuildStepFields() of the finished episode, taken before AutoResetEnv().
+     */
+    FString BuildAutoResetMessage(int32 EnvId, const FString& TerminalFields) const;
+
+    /**
+     * Starts a new episode of EnvId: calls HandleResetForEnv(), then clears its inference state, frame stack and
+     * EnvState slot. Every episode start goes through here, so overriding HandleResetForEnv never skips the inference reset.
+     */
+    void StartEnvEpisode(int32 EnvId);
+
+    /** Resets EnvId right after its episode ended and writes the first observation of the next one. */
+    void AutoResetEnv(int32 EnvId);
+
+    /**
+     * Schema version of the step messages: header "REW=..;DONE=..;TRUNC=..[;RESET_OBS=1];ENV=.." with the packed
+     * observation as payload. With bWithAutoReset the env is reset and its reset observation follows the terminal one.
+     */
+    void SendPackedStep(int32 EnvId, bool bWithAutoReset);
+
+    // Step messages go through SendPackedStep() when a schema is set (async batches stay text)
+    virtual bool SupportsObservationSchema() const override { return AsyncBatchSize <= 0; }
+
+    // Step messages are built from GetSentObservation(), which stacks frames
+    virtual bool SupportsFrameStack() const override { return true; }
+
+    // UpdateEnvObservation() normalizes the env slot in place
+    virtual bool SupportsObservationNormalization() const override { return true; }
+
+    // One frame stack and normalizer row per env
+    virtual int32 GetNumObservationRows() const override { return NumEnvironments; }
+
+    /**
+     * Writes EnvId's observation slot, normalizes it and pushes it onto its frame stack. Thread safe per env
+     * with bCallNative, which calls the C++ observation callback directly instead of the Blueprint event.
+     */
+    void UpdateEnvObservation(int32 EnvId, bool bCallNative = false);
+
+    /** Observation sent for EnvId: its frame stack when stacking, otherwise its EnvState slot. */
+    TConstArrayView<float> GetSentObservation(int32 EnvId) const;
+
+    /**
+     * Fills EnvId's observation slot (ObsSize floats).
+     * Default parses CreateStateStringForEnv and appends the env's sensors; C++ subclasses can override this
+     * to write floats directly and skip string formatting. Must be thread safe when bParallelEnvCallbacks is set,
+     * bCallNative is then set and the C++ callbacks have to be called directly.
+     */
+    virtual void WriteObservationForEnv(int32 EnvId, TArrayView<float> OutObservation, bool bCallNative);
+
+    /** Sends the step message of EnvId right away, or queues it for the next batch in async mode. */
+    void DispatchStepMessage(int32 EnvId, const FString& Message);
+
+    /** Ships every full batch of queued ready envs over the admin socket. */
+    void FlushReadyBatches();
+
+    /** Computes advantages and ships the rollout once every active env filled it, then starts the next one. */
+    void ShipRolloutIfReady();
+
+    /** Returns true if any step callback is overridden in a Blueprint class. */
+    bool HasBlueprintEnvCallbacks() const;
+
     // -------------------------------------------------------------
     //  Environment Callbacks
     // -------------------------------------------------------------
@@ -58,6 +310,10 @@ protected:
     float CalculateRewardForEnv(int32 EnvId, bool& bDone);
     virtual float CalculateRewardForEnv_Implementation(int32 EnvId, bool& bDone);
 
+    /**
+     * Resets one env. In inference mode it is called once CalculateRewardForEnv reports done or the episode
+     * hits MaxEpisodeSteps. The inference state of EnvId is cleared by the bridge.
+     */
     UFUNCTION(BlueprintNativeEvent, BlueprintCallable, Category = "MultiEnv|Environment")
     void HandleResetForEnv(int32 EnvId);
     virtual void HandleResetForEnv_Implementation(int32 EnvId);
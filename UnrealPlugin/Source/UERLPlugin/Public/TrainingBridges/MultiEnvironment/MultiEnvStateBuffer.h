@@ -0,0 +1,72 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Structure-of-arrays storage for per-environment step state, owned by UMultiEnvBridge.
+ *
+ * Every field is one contiguous array indexed by env id; observations and actions are
+ * row-major blocks of [NumEnvs x ObsSize] and [NumEnvs x ActSize].
+ * Env callbacks only write their own slot, so slots can be filled from worker threads,
+ * and the transport/inference layers read whole blocks without gathering.
+ */
+struct UERLPLUGIN_API FMultiEnvStateBuffer
+{
+public:
+    /** Allocate (or reallocate) every array and zero it. */
+    void Initialize(int32 InNumEnvs, int32 InObsSize, int32 InActSize);
+
+    /** Zero episode counters and step flags for EnvId, called when the env is reset. */
+    void ResetEnv(int32 EnvId);
+
+    /** Accumulate the reward of a completed step into the episode statistics of EnvId. */
+    void RecordStep(int32 EnvId, float Reward, bool bDone, bool bTruncated);
+
+    int32 GetNumEnvs() const { return NumEnvs; }
+    int32 GetObsSize() const { return ObsSize; }
+    int32 GetActSize() const { return ActSize; }
+
+    /** Observation slot of EnvId, ObsSize floats. */
+    TArrayView<float> GetObservation(int32 EnvId) { return TArrayView<float>(Observations.GetData() + EnvId * ObsSize, ObsSize); }
+    TConstArrayView<float> GetObservation(int32 EnvId) const { return TConstArrayView<float>(Observations.GetData() + EnvId * ObsSize, ObsSize); }
+
+    /** Action slot of EnvId, ActSize floats. */
+    TArrayView<float> GetAction(int32 EnvId) { return TArrayView<float>(Actions.GetData() + EnvId * ActSize, ActSize); }
+    TConstArrayView<float> GetAction(int32 EnvId) const { return TConstArrayView<float>(Actions.GetData() + EnvId * ActSize, ActSize); }
+
+    // -------------------------------------------------------------
+    //  Contiguous blocks
+    // -------------------------------------------------------------
+
+    /** [NumEnvs x ObsSize] observations of the latest completed step. */
+    TArray<float> Observations;
+
+    /** [NumEnvs x ActSize] last applied actions. */
+    TArray<float> Actions;
+
+    /** [NumEnvs] reward of the latest completed step. */
+    TArray<float> Rewards;
+
+    /** [NumEnvs] terminal flag of the latest completed step. */
+    TArray<uint8> Dones;
+
+    /** [NumEnvs] time limit flag of the latest completed step. */
+    TArray<uint8> Truncations;
+
+    /** [NumEnvs] steps taken in the current episode. */
+    TArray<int32> EpisodeLengths;
+
+    /** [NumEnvs] summed reward of the current episode. */
+    TArray<float> EpisodeReturns;
+
+    /** [NumEnvs] true while an env is still running its current action. */
+    TArray<uint8> ActionRunning;
+
+    /** [NumEnvs] true if the env completed a step during the current update and has to be sent. */
+    TArray<uint8> StepCompleted;
+
+private:
+    int32 NumEnvs = 0;
+    int32 ObsSize = 0;
+    int32 ActSize = 0;
+};
@@ -0,0 +1,141 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Preallocated on-policy rollout storage for UMultiEnvBridge, [Horizon x NumEnvs] per field.
+ *
+ * Transitions are recorded in two halves: RecordAction() when an action arrives (observation it was chosen from,
+ * action, value estimate and log probability sent by the trainer) and RecordOutcome() when the step completes
+ * (reward, termination and truncation). Every env has its own cursor, so envs stepping at different rates fill their
+ * column independently. Once an env holds Horizon transitions its next action supplies the bootstrap value and is
+ * staged for the following rollout; the rollout is ready when every active env is bootstrapped.
+ *
+ * Terminated steps do not bootstrap. Truncated steps bootstrap from the value of their terminal observation, which the
+ * trainer sends with the next action (after an auto-reset that action's own value belongs to the new episode).
+ *
+ * Scalar fields are time-major with the env dimension padded to a multiple of 4, so GAE and returns are computed
+ * with SIMD over 4 envs at a time. The rollout is shipped as one binary block, see Serialize().
+ */
+struct UERLPLUGIN_API FRolloutBuffer
+{
+public:
+    /**
+     * Allocate every field for InHorizon steps of InNumEnvs envs. A horizon of 0 disables the buffer.
+     * With bInTerminalObservations the terminal observation of every truncated step is kept as well, for learners
+     * that evaluate terminal values themselves, see RecordTerminalObservation().
+     */
+    void Initialize(int32 InHorizon, int32 InNumEnvs, int32 InObsSize, int32 InActSize, bool bInTerminalObservations = false);
+
+    /** True if Initialize() was given a positive horizon. */
+    bool IsEnabled() const { return Horizon > 0; }
+
+    int32 GetHorizon() const { return Horizon; }
+    int32 GetNumEnvs() const { return NumEnvs; }
+    int32 GetObsSize() const { return ObsSize; }
+    int32 GetActSize() const { return ActSize; }
+    bool HasTerminalObservations() const { return bTerminalObservations; }
+
+    /**
+     * Records the first half of a transition of EnvId. A second action before the outcome (e.g. after a RESET)
+     * overwrites the pending one. TerminalValue is the value of the terminal observation of the previous step,
+     * only read if that step was truncated.
+     * Envs that run a full step ahead of the slowest env are not recorded: their staged step is closed as a
+     * truncation bootstrapped from Value, so advantages never span the dropped steps. Callers that choose actions
+     * themselves hold such envs instead, see IsWaitingForNextRollout().
+     */
+    void RecordAction(int32 EnvId, TConstArrayView<float> Observation, TConstArrayView<float> Action, float Value, float LogProb, float TerminalValue = 0.f);
+
+    /** Completes the pending transition of EnvId. A terminated step does not bootstrap, a truncated one bootstraps from its terminal value. */
+    void RecordOutcome(int32 EnvId, float Reward, bool bTerminated, bool bTruncated);
+
+    /**
+     * Keeps Observation as the terminal observation of the step RecordOutcome() just completed for EnvId,
+     * if that step was truncated. Call it before the env is reset. Ignored without terminal observation storage.
+     */
+    void RecordTerminalObservation(int32 EnvId, TConstArrayView<float> Observation);
+
+    /** True if EnvId completed its staged step, any further transition is dropped until the rollout ships. */
+    bool IsWaitingForNextRollout(int32 EnvId) const { return StagedOutcome.IsValidIndex(EnvId) && StagedOutcome[EnvId]; }
+
+    /** Discards the partial rollout of EnvId, for envs that disconnected or rejoined. */
+    void DropEnv(int32 EnvId);
+
+    /** True if at least one env is active and every active env holds Horizon transitions plus a bootstrap value. */
+    bool IsReady(TConstArrayView<bool> ActiveEnvs) const;
+
+    /** Generalized advantage estimation and discounted returns over the whole rollout, SIMD over envs. */
+    void ComputeAdvantages(float Gamma, float GaeLambda);
+
+    /**
+     * Writes the rollout as little endian float32 arrays, time-major and without padding:
+     * observations [T x N x ObsSize], actions [T x N x ActSize], then rewards, dones (terminations), truncations,
+     * terminal_values (0 unless truncated), values, log_probs, advantages and returns [T x N] each, then the env mask [N]
+     * (1 for envs in the rollout, 0 for inactive ones).
+     * With bWithBootstrapObservations the observations after the last step [N x ObsSize] follow, for learners
+     * that evaluate the bootstrap value themselves. With terminal observation storage the terminal observations
+     * [T x N x ObsSize] come last, zeros for steps that were not truncated.
+     */
+    void Serialize(TConstArrayView<bool> ActiveEnvs, TArray<uint8>& OutBytes, bool bWithBootstrapObservations = false) const;
+
+    /** Starts the next rollout, staged transitions become its first step. */
+    void StartNextRollout();
+
+private:
+    /** Offset of (Step, EnvId) in the scalar fields. */
+    int32 ScalarIndex(int32 Step, int32 EnvId) const { return Step * EnvStride + EnvId; }
+
+    /** Row RecordAction() writes for EnvId, Horizon for the staging row. */
+    int32 GetWriteStep(int32 EnvId) const { return Bootstrapped[EnvId] ? Horizon : Cursors[EnvId]; }
+
+    /** Stores TerminalValue on the last completed step of EnvId if it was truncated, once per step. */
+    void ApplyTerminalValue(int32 EnvId, float TerminalValue);
+
+    /** Copies Observation into the terminal observation of (Step, EnvId). */
+    void WriteTerminalObservation(int32 Step, int32 EnvId, TConstArrayView<float> Observation);
+
+    int32 Horizon = 0;
+    int32 NumEnvs = 0;
+    int32 ObsSize = 0;
+    int32 ActSize = 0;
+    bool bTerminalObservations = false;
+
+    /** NumEnvs rounded up to a multiple of 4, the row stride of the scalar fields. */
+    int32 EnvStride = 0;
+
+    // Horizon + 1 rows, the last one stages the first step of the next rollout
+    TArray<float> Observations;
+    TArray<float> Actions;
+    TArray<float> TerminalObservations;
+    TArray<float, TAlignedHeapAllocator<16>> Rewards;
+    TArray<float, TAlignedHeapAllocator<16>> Dones;
+    TArray<float, TAlignedHeapAllocator<16>> Truncations;
+    TArray<float, TAlignedHeapAllocator<16>> TerminalValues;
+    TArray<float, TAlignedHeapAllocator<16>> Values;
+    TArray<float, TAlignedHeapAllocator<16>> LogProbs;
+
+    // Horizon rows
+    TArray<float, TAlignedHeapAllocator<16>> Advantages;
+    TArray<float, TAlignedHeapAllocator<16>> Returns;
+
+    /** [EnvStride] value of the observation after the last step, from the first action past the horizon. */
+    TArray<float, TAlignedHeapAllocator<16>> LastValues;
+
+    /** [NumEnvs] completed transitions of the current rollout. */
+    TArray<int32> Cursors;
+
+    /** [NumEnvs] true while a recorded action waits for its outcome. */
+    TArray<uint8> PendingOutcome;
+
+    /** [NumEnvs] true once LastValues holds the env's bootstrap value. */
+    TArray<uint8> Bootstrapped;
+
+    /** [NumEnvs] true once the staged step of a bootstrapped env has its outcome. */
+    TArray<uint8> StagedOutcome;
+
+    /** [NumEnvs] true once the staged step was closed because the env ran ahead. */
+    TArray<uint8> StagedClosed;
+
+    /** [NumEnvs] step of the last outcome still waiting for its terminal value, INDEX_NONE if none. */
+    TArray<int32> LastOutcomeSteps;
+};
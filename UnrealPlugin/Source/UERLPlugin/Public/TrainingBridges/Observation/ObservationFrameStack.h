@@ -0,0 +1,51 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Keeps the last Depth observations of every row (env or agent) and exposes them as one stacked view,
+ * oldest frame first, as seen by Python and the local model.
+ *
+ * Each row stores its ring twice back to back ([2 x Depth x FrameSize]); a pushed frame is written to both
+ * copies, so the last Depth frames are always contiguous and the stacked view is a slice, not a copy.
+ * After a reset the first pushed frame fills the whole history, like gymnasium's FrameStackObservation padding.
+ */
+struct UERLPLUGIN_API FObservationFrameStack
+{
+public:
+    /** Allocate (or reallocate) storage for InNumRows rows of InDepth frames of InFrameSize floats. */
+    void Initialize(int32 InNumRows, int32 InFrameSize, int32 InDepth);
+
+    /** The next Push() of Row fills its whole history. */
+    void ResetRow(int32 Row);
+
+    /** ResetRow() for every row. */
+    void ResetAll();
+
+    /** Adds Frame as the newest frame of Row and returns the stacked view. Rows are independent, so
+     *  different rows may be pushed from different threads. */
+    TConstArrayView<float> Push(int32 Row, TConstArrayView<float> Frame);
+
+    /** Last Depth frames of Row, oldest first, Depth x FrameSize floats. */
+    TConstArrayView<float> GetStacked(int32 Row) const;
+
+    bool IsInitialized() const { return Depth > 0; }
+    int32 GetNumRows() const { return NumRows; }
+    int32 GetFrameSize() const { return FrameSize; }
+    int32 GetDepth() const { return Depth; }
+    int32 GetStackedSize() const { return Depth * FrameSize; }
+
+private:
+    /** [NumRows x 2 x Depth x FrameSize] */
+    TArray<float> Storage;
+
+    /** [NumRows] slot of the oldest frame, the next push overwrites it. */
+    TArray<int32> Heads;
+
+    /** [NumRows] false until the first frame after a reset was pushed. */
+    TArray<uint8> Primed;
+
+    int32 NumRows = 0;
+    int32 FrameSize = 0;
+    int32 Depth = 0;
+};
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Running observation normalization matching stable-baselines3's VecNormalize:
+ * x' = clip((x - mean) / sqrt(var + epsilon), -clip, clip), with the statistics started at mean 0, var 1, count 1e-4.
+ *
+ * Rows (envs) record their raw observation and are normalized in place with the current statistics; Commit() then
+ * folds every recorded row into the running mean/variance as one batch (Chan et al. parallel Welford update).
+ * Only the first Size values of an observation are normalized, the rest (sensor values) pass through.
+ */
+struct UERLPLUGIN_API FObservationNormalizer
+{
+public:
+    /**
+     * Allocate InNumRows pending rows of InSize values. The statistics are reset only if InSize differs from
+     * the current size, so imported statistics survive (re)connecting.
+     */
+    void Initialize(int32 InNumRows, int32 InSize, float InClip = 10.f, float InEpsilon = 1e-8f);
+
+    /** Back to mean 0, var 1, count 1e-4, drops pending rows. */
+    void ResetStatistics();
+
+    /**
+     * Normalizes the first Size values of Observation in place with the current statistics.
+     * With bRecord the raw values are kept for the next Commit(), a row recorded twice keeps the latest.
+     * Rows are independent, so different rows may be normalized from different threads while no Commit() runs.
+     */
+    void Normalize(int32 Row, TArrayView<float> Observation, bool bRecord);
+
+    /** Normalizes the first Size values of Observation without recording them. */
+    void NormalizeReadOnly(TArrayView<float> Observation) const;
+
+    /** Folds the recorded rows into the running statistics as one batch. Game thread. */
+    void Commit();
+
+    /** "COUNT=..\nCLIP=..\nEPSILON=..\nMEAN=a,b,..\nVAR=a,b,.." */
+    FString ToString() const;
+
+    /** Parses ToString() output. Resizes the statistics to the file if not initialized yet, otherwise sizes must match. */
+    bool FromString(const FString& Text);
+
+    bool IsInitialized() const { return Size > 0; }
+    int32 GetSize() const { return Size; }
+    int32 GetNumRows() const { return NumRows; }
+    float GetClip() const { return Clip; }
+    float GetEpsilon() const { return Epsilon; }
+    double GetCount() const { return Count; }
+    TConstArrayView<float> GetMean() const { return Mean; }
+    TConstArrayView<float> GetVariance() const { return Variance; }
+
+private:
+    /** Recomputes InvStd from Variance, clip and epsilon. */
+    void UpdateScale();
+
+    /** [Size] running statistics, M2 = Variance * Count. */
+    TArray<float> Mean;
+    TArray<float> Variance;
+
+    /** [Size] 1 / sqrt(Variance + Epsilon), cached per Commit(). */
+    TArray<float> InvStd;
+
+    /** [NumRows x Size] raw observations since the last Commit(). */
+    TArray<float> PendingRows;
+
+    /** [NumRows] true if the row was recorded since the last Commit(). */
+    TArray<uint8> PendingMask;
+
+    /** [Size] batch scratch, reused by Commit(). */
+    TArray<float> BatchMean;
+    TArray<float> BatchM2;
+
+    double Count = 1e-4;
+    float Clip = 10.f;
+    float Epsilon = 1e-8f;
+    int32 NumRows = 0;
+    int32 Size = 0;
+};
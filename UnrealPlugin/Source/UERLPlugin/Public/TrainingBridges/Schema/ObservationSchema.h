@@ -0,0 +1,128 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ObservationSchema.generated.h"
+
+/** Wire type of an observation field. */
+UENUM(BlueprintType)
+enum class EObservationDType : uint8
+{
+    Float32,
+    Float16,
+    UInt8,
+    Int32,
+    /** Linear quantized: q = round((value - Offset) / Scale), clamped to -128..127. */
+    QInt8,
+    /** Linear quantized: q = round((value - Offset) / Scale), clamped to 0..65535. */
+    QUInt16
+};
+
+/** Kind of an action head. */
+UENUM(BlueprintType)
+enum class EActionHeadType : uint8
+{
+    /** Size real valued actions. */
+    Continuous,
+    /** One integer choice out of Size options. */
+    Discrete
+};
+
+/**
+ * One named component of the observation, e.g. a 3x64x64 uint8 image or an 8 float vector.
+ * Fields are laid out back to back in declaration order in the flat observation.
+ */
+USTRUCT(BlueprintType)
+struct UERLPLUGIN_API FObservationField
+{
+    GENERATED_BODY()
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Schema")
+    FString Name;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Schema")
+    EObservationDType DType = EObservationDType::Float32;
+
+    /** Dimensions, row-major. Empty means a scalar. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Schema")
+    TArray<int32> Shape;
+
+    /** Quantization step for QInt8/QUInt16, value = q * Scale + Offset. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Schema", meta = (EditCondition = "DType == EObservationDType::QInt8 || DType == EObservationDType::QUInt16"))
+    float Scale = 1.f;
+
+    /** Quantization zero point for QInt8/QUInt16, value = q * Scale + Offset. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Schema", meta = (EditCondition = "DType == EObservationDType::QInt8 || DType == EObservationDType::QUInt16"))
+    float Offset = 0.f;
+
+    /** True for the linear quantized dtypes, which carry Scale/Offset in the handshake. */
+    bool IsQuantized() const { return DType == EObservationDType::QInt8 || DType == EObservationDType::QUInt16; }
+
+    /** Number of values in this field. */
+    int32 GetNumElements() const;
+
+    /** Bytes per value on the wire. */
+    int32 GetElementSize() const;
+};
+
+/** One named action head. */
+USTRUCT(BlueprintType)
+struct UERLPLUGIN_API FActionHead
+{
+    GENERATED_BODY()
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Schema")
+    FString Name;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Schema")
+    EActionHeadType Type = EActionHeadType::Continuous;
+
+    /** Continuous: number of values. Discrete: number of choices (the head sends one integer). */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Schema")
+    int32 Size = 1;
+
+    /** Number of values this head occupies in the action string. */
+    int32 GetNumValues() const { return Type == EActionHeadType::Discrete ? 1 : Size; }
+};
+
+/**
+ * Typed layout of observations and actions, declared in the handshake as
+ * "OBS_SCHEMA=<name>:<dtype>:<d0>x<d1>..[:<scale>:<offset>],...;ACT_SCHEMA=<name>:<cont|disc>:<size>,..."
+ * Scale and offset are only present for the quantized dtypes (qint8, quint16).
+ *
+ * With a schema, observations are sent as a binary frame "<header>;BYTES=<n>\n<payload>" where the payload
+ * holds every field packed in its own dtype (little endian), instead of the %.2f text list.
+ */
+USTRUCT(BlueprintType)
+struct UERLPLUGIN_API FObservationSchema
+{
+    GENERATED_BODY()
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Schema")
+    TArray<FObservationField> Fields;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Schema")
+    TArray<FActionHead> ActionHeads;
+
+    /** True if no observation fields are declared, observations then use the plain text format. */
+    bool IsEmpty() const { return Fields.Num() == 0; }
+
+    /** Number of float values of the flat observation covered by all fields. */
+    int32 GetNumObservationValues() const;
+
+    /** Size of one packed observation in bytes. */
+    int32 GetPackedObservationBytes() const;
+
+    /** Number of values in an action string covered by all heads. */
+    int32 GetNumActionValues() const;
+
+    /**
+     * Checks the declared fields and heads, e.g. quantized fields need a finite non zero Scale
+     * and names must not contain the handshake separators ':', ',' or ';'.
+     */
+    bool Validate(FString& OutError) const;
+
+    /** ";OBS_SCHEMA=...;ACT_SCHEMA=..." suffix for the handshake, empty if no schema is set. */
+    FString ToHandshakeString() const;
+
+    static const TCHAR* DTypeToString(EObservationDType DType);
+};
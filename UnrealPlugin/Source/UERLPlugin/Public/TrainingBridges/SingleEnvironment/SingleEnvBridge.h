@@ -25,8 +25,52 @@ public:
      */
     virtual void UpdateRL_Implementation(float DeltaTime) override;
 
+    // -------------------------------------------------------------
+    //  Same Tick Response
+    // -------------------------------------------------------------
+    /**
+     * If true, after sending an observation the bridge blocks for up to SameTickWaitSeconds
+     * for Python's next action and applies it within the same tick, instead of on the next one.
+     * Useful for instant actions, where it saves at least one frame per step.
+     */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SingleEnv|Stepping")
+    bool bSameTickResponse = false;
+
+    /** Upper bound on how long a tick may block waiting for the next action. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SingleEnv|Stepping")
+    float SameTickWaitSeconds = 0.002f;
+
+    /** Max number of actions waited for and applied per tick in same tick mode. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SingleEnv|Stepping")
+    int32 MaxSameTickActions = 1;
+
 protected:
 
+    /**
+     * One training step: apply a pending Python message, then check whether the current action completed.
+     * Returns true if an observation was sent back.
+     */
+    bool StepTraining();
+
+    /**
+     * Starts a new episode: calls HandleReset(), then clears the inference state and frame stacks.
+     * Every episode start goes through here (RESET, worker join, episode end in inference), so overriding
+     * HandleReset never skips the inference reset.
+     */
+    void StartEpisode();
+
+    /** Sends the current observation with Reward and bDone, schema packed if a schema is set. */
+    void SendObservation(float Reward, bool bDone);
+
+    // Observations are sent through SendObservation(), which handles schema packing
+    virtual bool SupportsObservationSchema() const override { return true; }
+
+    // SendObservation() stacks frames as well
+    virtual bool SupportsFrameStack() const override { return true; }
+
+    // and normalizes them before stacking
+    virtual bool SupportsObservationNormalization() const override { return true; }
+
     // Override handshake to send multi enviornment configuration settngs
     FString BuildHandshake_Implementation() override;
 
@@ -52,6 +96,7 @@ protected:
 
     /**
      * Called when a reset is requested (e.g., after the environment is done).
+     * In inference mode it is called once CalculateReward reports done. The inference state is cleared by the bridge.
      */
     UFUNCTION(BlueprintNativeEvent, BlueprintCallable, Category = "SingleEnv|Environment")
     void HandleReset();
@@ -77,4 +122,10 @@ private:
     /** True when we have just applied an action and are waiting for it to finish before requesting another. */
     bool bIsActionRunning = false;
 
+    /** Engine frame on which the current action may complete, see UBaseBridge::EnableFixedTimestep(). */
+    uint64 ActionReadyFrame = 0;
+
+    /** Parsed observation reused for schema packing. */
+    TArray<float> ObservationScratch;
+
 };
@@ -17,7 +17,9 @@ public class UERLPlugin : ModuleRules
                 "InputCore",
                 "Sockets",
                 "Networking",
-                "EnhancedInput"
+                "EnhancedInput",
+                "RenderCore",
+                "RHI"
             }
         );
 